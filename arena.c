@@ -0,0 +1,210 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                 arena.c
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *      Purpose: Bump allocator for whole compilation (memory is released at once)
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file arena.c
+ * @brief Bump allocator for whole compilation (memory is released at once)
+ * @note For more documentation about functions and structures @see arena.h
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#include "arena.h"
+#include <string.h>
+
+
+//Arena is set per thread, because more compilations can run concurrently (@see batch.h)
+static __thread arena_t *cur_arena = NULL;
+
+
+//Every allocation starts at address aligned as this type (and its header is stored before it)
+typedef union arena_header {
+    struct {
+        size_t size; /**< Size of allocation */
+        void *prev; /**< Allocation, that was the last one in the same block before this one */
+    } info;
+    void *ptr;
+    double dbl;
+    long double ldbl;
+} arena_header_t;
+
+#define ARENA_ALIGN(size) (((size) + sizeof(arena_header_t) - 1) / sizeof(arena_header_t) * sizeof(arena_header_t))
+
+#define BLOCK_DATA(block) ((char *)(block) + ARENA_ALIGN(sizeof(arena_block_t)))
+
+
+void arena_init(arena_t *arena) {
+    arena->blocks = NULL;
+    arena->last = NULL;
+    arena->total = 0;
+}
+
+
+void *arena_alloc(arena_t *arena, size_t size) {
+    size_t needed = ARENA_ALIGN(sizeof(arena_header_t) + size);
+    arena_block_t *block = arena->blocks;
+    bool is_current = true;
+    if(!block || block->size - block->used < needed) {
+        size_t block_size = needed > ARENA_BLOCK_SIZE ? needed : ARENA_BLOCK_SIZE;
+        block = (arena_block_t *)malloc(ARENA_ALIGN(sizeof(arena_block_t)) + block_size);
+        if(!block) {
+            return NULL;
+        }
+
+        block->size = block_size;
+        block->used = 0;
+        arena->total += block_size;
+
+        if(block_size > ARENA_BLOCK_SIZE && arena->blocks) { //Big block is used only once, so the current block stays
+            block->next = arena->blocks->next;
+            arena->blocks->next = block;
+            is_current = false;
+        }
+        else {
+            block->next = arena->blocks;
+            arena->blocks = block;
+        }
+    }
+
+    arena_header_t *header = (arena_header_t *)(BLOCK_DATA(block) + block->used);
+    block->used += needed;
+    header->info.size = size;
+    header->info.prev = NULL;
+
+    if(is_current) {
+        header->info.prev = block->used > needed ? arena->last : NULL;
+        arena->last = header + 1;
+    }
+
+    return header + 1;
+}
+
+
+void *arena_realloc(arena_t *arena, void *ptr, size_t size) {
+    if(!ptr) {
+        return arena_alloc(arena, size);
+    }
+
+    arena_header_t *header = (arena_header_t *)ptr - 1;
+    size_t old_size = header->info.size;
+    if(size <= old_size) {
+        return ptr;
+    }
+
+    //The last allocation can grow, if there is enough space in the current block
+    if(ptr == arena->last) {
+        arena_block_t *block = arena->blocks;
+        size_t extra = ARENA_ALIGN(sizeof(arena_header_t) + size) - ARENA_ALIGN(sizeof(arena_header_t) + old_size);
+        if(block->size - block->used >= extra) {
+            block->used += extra;
+            header->info.size = size;
+
+            return ptr;
+        }
+    }
+
+    void *moved = arena_alloc(arena, size);
+    if(moved) {
+        memcpy(moved, ptr, old_size);
+    }
+
+    return moved;
+}
+
+
+void arena_release(arena_t *arena) {
+    arena_block_t *block = arena->blocks;
+    while(block) {
+        arena_block_t *next = block->next;
+        free(block);
+        block = next;
+    }
+
+    arena_init(arena);
+}
+
+
+void arena_adopt(arena_t *dst, arena_t *src) {
+    if(!src->blocks) {
+        return;
+    }
+
+    if(!dst->blocks) {
+        *dst = *src;
+    }
+    else { //Blocks are put behind the current block of dst, so it can be still used for allocation
+        arena_block_t *last = src->blocks;
+        while(last->next) {
+            last = last->next;
+        }
+
+        last->next = dst->blocks->next;
+        dst->blocks->next = src->blocks;
+        dst->total += src->total;
+    }
+
+    arena_init(src);
+}
+
+
+arena_t *arena_use(arena_t *arena) {
+    arena_t *previous = cur_arena;
+    cur_arena = arena;
+
+    return previous;
+}
+
+
+bool arena_active() {
+    return cur_arena != NULL;
+}
+
+
+arena_t *arena_current() {
+    return cur_arena;
+}
+
+
+void *mem_alloc(size_t size) {
+    return cur_arena ? arena_alloc(cur_arena, size) : malloc(size);
+}
+
+
+void *mem_realloc(void *ptr, size_t size) {
+    return cur_arena ? arena_realloc(cur_arena, ptr, size) : realloc(ptr, size);
+}
+
+
+/**
+ * @brief Returns the last allocation back to arena (other memory of arena is released at once with it)
+ */
+static void arena_free(arena_t *arena, void *ptr) {
+    if(ptr && ptr == arena->last) { //Temporary data are often freed in reverse order of allocation
+        arena_header_t *header = (arena_header_t *)ptr - 1;
+        arena->blocks->used = (char *)header - BLOCK_DATA(arena->blocks);
+        arena->last = header->info.prev;
+    }
+}
+
+
+void mem_free(void *ptr) {
+    if(cur_arena) {
+        arena_free(cur_arena, ptr);
+    }
+    else {
+        free(ptr);
+    }
+}
+
+
+/***                              End of arena.c                           ***/
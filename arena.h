@@ -0,0 +1,127 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                 arena.h
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *      Purpose: Bump allocator for whole compilation (memory is released at once)
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file arena.h
+ * @brief Bump allocator for whole compilation (memory is released at once)
+ * @note Strings, stacks, nodes of symbol tables and instructions are allocated by mem_alloc(),
+ *       if arena is set to current thread (@see arena_use()), memory is taken from it and
+ *       mem_free() does nothing, otherwise standard malloc() and free() are used
+ * @warning Memory must be reallocated and freed in the same mode as it was allocated
+ *          (arena should be set before the first allocation of compilation and unset after the last one)
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#define ARENA_BLOCK_SIZE (256 * 1024) /**< Default size of data of one block of arena (in bytes) */
+
+
+/**
+ * @brief Block of memory of arena
+ * @note Data of block are right after this structure
+ */
+typedef struct arena_block {
+    struct arena_block *next; /**< Block, that was used before this one */
+    size_t size; /**< Size of data of block */
+    size_t used; /**< Number of already allocated bytes of data */
+} arena_block_t;
+
+/**
+ * @brief Arena (allocated memory is not freed one by one, but all at once by arena_release())
+ */
+typedef struct arena {
+    arena_block_t *blocks; /**< Block, that is currently used for allocation (older blocks are linked behind it) */
+    void *last; /**< The last allocation (it can be extended in place) */
+    size_t total; /**< Number of bytes allocated from system */
+} arena_t;
+
+
+/**
+ * @brief Inits empty arena (the first block is allocated with the first allocation)
+ */
+void arena_init(arena_t *arena);
+
+
+/**
+ * @brief Allocates memory from arena
+ * @return Pointer to allocated memory or NULL if allocation failed
+ */
+void *arena_alloc(arena_t *arena, size_t size);
+
+
+/**
+ * @brief Changes size of memory allocated from arena (the last allocation is extended in place)
+ * @return Pointer to reallocated memory or NULL if allocation failed (original memory stays valid)
+ */
+void *arena_realloc(arena_t *arena, void *ptr, size_t size);
+
+
+/**
+ * @brief Releases all memory of arena at once
+ */
+void arena_release(arena_t *arena);
+
+
+/**
+ * @brief Moves all blocks of src arena to dst arena (they are released together with dst)
+ * @note It is used when part of compilation runs in other thread with its own arena
+ */
+void arena_adopt(arena_t *dst, arena_t *src);
+
+
+/**
+ * @brief Sets arena, from which memory of current thread is allocated (NULL means standard allocation)
+ * @return Arena, that was used before
+ */
+arena_t *arena_use(arena_t *arena);
+
+
+/**
+ * @brief Returns true if memory of current thread is allocated from arena (so it does not have to be freed)
+ */
+bool arena_active();
+
+
+/**
+ * @brief Returns arena of current thread (NULL if memory is allocated by malloc())
+ */
+arena_t *arena_current();
+
+
+/**
+ * @brief Allocates memory from arena of current thread (or by malloc() if there is no arena)
+ */
+void *mem_alloc(size_t size);
+
+
+/**
+ * @brief Reallocates memory from arena of current thread (or by realloc() if there is no arena)
+ */
+void *mem_realloc(void *ptr, size_t size);
+
+
+/**
+ * @brief Frees memory allocated by mem_alloc() (it does nothing if memory is allocated from arena)
+ */
+void mem_free(void *ptr);
+
+
+#endif
+
+/***                              End of arena.h                           ***/
@@ -0,0 +1,108 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                  ast.c
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *      Purpose: Abstract syntax tree built by parser (code is generated from it)
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file ast.c
+ * @brief Abstract syntax tree built by parser (code is generated from it)
+ * @note For more documentation about functions and structures @see ast.h
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#include "ast.h"
+#include <string.h>
+
+
+void ast_init(ast_t *ast) {
+    arena_init(&ast->arena);
+    ast->first = NULL;
+    ast->int_error = false;
+}
+
+
+void ast_dtor(ast_t *ast) {
+    arena_release(&ast->arena);
+    ast->first = NULL;
+}
+
+
+ast_node_t *ast_node(ast_t *ast, ast_kind_t kind) {
+    ast_node_t *node = (ast_node_t *)arena_alloc(&ast->arena, sizeof(ast_node_t));
+    if(!node) {
+        ast->int_error = true;
+        return NULL;
+    }
+
+    memset(node, 0, sizeof(ast_node_t));
+    node->kind = kind;
+
+    return node;
+}
+
+
+const char *ast_str(ast_t *ast, const char *str) {
+    size_t length = strlen(str) + 1;
+    char *copy = (char *)arena_alloc(&ast->arena, length);
+    if(!copy) {
+        ast->int_error = true;
+        return NULL;
+    }
+
+    return (const char *)memcpy(copy, str, length);
+}
+
+
+void ast_append(ast_node_t **list, ast_node_t *node) {
+    while(*list) { //Lists of arguments and values are short, so the end is searched
+        list = &(*list)->next;
+    }
+
+    *list = node;
+}
+
+
+bool ast_int2num(ast_t *ast, ast_node_t **node) {
+    if((*node)->kind == AST_INT2NUM) {
+        (*node)->n++;
+        return true;
+    }
+
+    ast_node_t *conversion = ast_node(ast, AST_INT2NUM);
+    if(!conversion) {
+        return false;
+    }
+
+    conversion->a = *node;
+    conversion->n = 1;
+    *node = conversion;
+
+    return true;
+}
+
+
+bool ast_dump(ast_t *ast, ast_node_t **node, size_t save_n, size_t delete_n) {
+    ast_node_t *dump = ast_node(ast, AST_DUMP);
+    if(!dump) {
+        return false;
+    }
+
+    dump->a = *node;
+    dump->n = save_n;
+    dump->m = delete_n;
+    *node = dump;
+
+    return true;
+}
+
+
+/***                               End of ast.c                            ***/
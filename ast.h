@@ -0,0 +1,137 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                  ast.h
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *      Purpose: Abstract syntax tree built by parser (code is generated from it)
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file ast.h
+ * @brief Abstract syntax tree built by parser (code is generated from it)
+ * @note Parser only builds the tree and checks semantics, instructions are generated
+ *       by separate walk over the tree (@see codegen.h)
+ * @note Nodes are allocated from arena of tree, so they are released at once by ast_dtor()
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#ifndef AST_H
+#define AST_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "arena.h"
+#include "scanner.h"
+#include "symtable.h"
+
+
+/**
+ * @brief Kind of node (meaning of fields of node depends on it)
+ */
+typedef enum ast_kind {
+    AST_FUNCTION, /**< Definition of function: name, a = parameters (AST_VAR), b = body, n = number of return values */
+    AST_CALL, /**< Call of function: name, a = arguments (expressions) */
+    AST_LOCAL, /**< Declaration of local variable: name (unique), a = initial value (or NULL) */
+    AST_ASSIGN, /**< Assignment: a = variables (AST_VAR), b = values (evaluated from right to left) */
+    AST_IF, /**< Condition: a = condition, b = then branch, c = else branch, n = number of condition, m = data type of condition */
+    AST_WHILE, /**< Loop: a = condition, b = body, n = number of loop, m = data type of condition */
+    AST_RETURN, /**< Return: a = returned values, n = number of implicit nils pushed before them */
+
+    AST_VAR, /**< Variable: name (unique), m = data type */
+    AST_NUM, /**< Numeric literal: num, m = data type */
+    AST_VAL, /**< Other literal (string, nil): name (its text), m = data type */
+    AST_OP, /**< Operation: a = first operand, b = second operand (or NULL), n = index of rule (@see get_rule()) */
+    AST_DUMP, /**< Values from stack are disposed after a is evaluated: n = number of kept values, m = number of disposed values */
+    AST_INT2NUM, /**< Integers on top of the stack are converted to number after a is evaluated: n = number of conversions */
+} ast_kind_t;
+
+
+/**
+ * @brief Flags of nodes
+ */
+typedef enum ast_flags {
+    AST_CALL_EACH = 1, /**< Function is called after every argument (call of variadic function as statement) */
+    AST_CONVERT = 2, /**< Value is converted from integer to number before it is stored (variable in assignment) */
+    AST_REUSED = 4, /**< Code of function was taken from cache (there is no body) */
+} ast_flags_t;
+
+
+/**
+ * @brief Node of AST (kept small, because there is node for every operand and operation)
+ */
+typedef struct ast_node {
+    struct ast_node *next; /**< Next node in list (statements of block, arguments, parameters, ...) */
+    struct ast_node *a; /**< The first child */
+    struct ast_node *b; /**< The second child */
+    union {
+        const char *name; /**< Name of function or variable or text of literal */
+        num_value_t num; /**< Value of numeric literal */
+        struct ast_node *c; /**< The third child */
+    } u;
+    uint32_t n; /**< Counter, index or number of values (@see ast_kind_t) */
+    uint16_t m; /**< Data type of value or the second number (@see ast_kind_t) */
+    uint8_t kind; /**< Kind of node (@see ast_kind_t) */
+    uint8_t flags; /**< Flags of node (@see ast_flags_t) */
+} ast_node_t;
+
+
+/**
+ * @brief Tree of whole program (its nodes and names are allocated from one arena)
+ */
+typedef struct ast {
+    arena_t arena; /**< Memory of nodes and names */
+    ast_node_t *first; /**< The first global statement (definition or call of function) */
+    bool int_error; /**< Flag that signalizes internal error (allocation of node failed) */
+} ast_t;
+
+
+/**
+ * @brief Inits empty tree
+ */
+void ast_init(ast_t *ast);
+
+/**
+ * @brief Releases all nodes of tree at once
+ */
+void ast_dtor(ast_t *ast);
+
+/**
+ * @brief Creates new node (other fields than kind are zeroed)
+ * @return Pointer to new node or NULL if an error occured (int_error of tree is set)
+ */
+ast_node_t *ast_node(ast_t *ast, ast_kind_t kind);
+
+/**
+ * @brief Makes copy of string in memory of tree (names must outlive symbol tables and scanner buffers)
+ * @return Pointer to copy or NULL if an error occured (int_error of tree is set)
+ */
+const char *ast_str(ast_t *ast, const char *str);
+
+/**
+ * @brief Appends node to the end of list
+ */
+void ast_append(ast_node_t **list, ast_node_t *node);
+
+/**
+ * @brief Converts the top of stack to number after given node is evaluated (the conversions are merged into one node)
+ * @return False if an error occured
+ */
+bool ast_int2num(ast_t *ast, ast_node_t **node);
+
+/**
+ * @brief Disposes values from stack after given node is evaluated (top save_n values are kept)
+ * @return False if an error occured
+ */
+bool ast_dump(ast_t *ast, ast_node_t **node, size_t save_n, size_t delete_n);
+
+
+#endif
+
+/***                               End of ast.h                            ***/
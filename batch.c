@@ -0,0 +1,401 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                 batch.c
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *    Purpose: Parallel compilation of more files (batch mode of compiler)
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file batch.c
+ * @brief Parallel compilation of more files (batch mode of compiler)
+ * @note For more documentation about functions and structures @see batch.h
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#define _POSIX_C_SOURCE 200809L /**< Because of pthreads, and clock_gettime() */
+
+#include "batch.h"
+#include "compiler.h"
+#include "scanner.h"
+#include "workers.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+
+/**
+ * @brief Queue of files (indexes to array of files) of one worker
+ * @note Owner takes files from the bottom, thieves take them from the top
+ */
+typedef struct work_queue {
+    size_t *tasks;
+    size_t top;
+    size_t bottom;
+    pthread_mutex_t lock;
+} work_queue_t;
+
+
+/**
+ * @brief Shared state of batch compilation
+ */
+typedef struct batch {
+    batch_file_t *files;
+    const compile_opts_t *opts;
+    work_queue_t *queues;
+    unsigned worker_num;
+    FILE *log;
+    pthread_mutex_t log_lock;
+} batch_t;
+
+
+/**
+ * @brief Arguments of worker thread
+ */
+typedef struct worker {
+    batch_t *batch;
+    unsigned id;
+    pthread_t thread;
+} worker_t;
+
+
+char *get_output_name(const char *path) {
+    size_t base_len = strlen(path);
+    size_t ext_len = strlen(INPUT_EXTENSION);
+    if(base_len > ext_len && strcmp(&path[base_len - ext_len], INPUT_EXTENSION) == 0) {
+        base_len -= ext_len;
+    }
+
+    char *name = malloc(base_len + strlen(OUTPUT_EXTENSION) + 1);
+    if(!name) {
+        return NULL;
+    }
+
+    memcpy(name, path, base_len);
+    strcpy(&name[base_len], OUTPUT_EXTENSION);
+
+    return name;
+}
+
+
+/**
+ * @brief Takes file from the bottom of own queue
+ * @return True if queue was not empty
+ */
+static bool queue_pop(work_queue_t *q, size_t *task) {
+    bool got = false;
+
+    pthread_mutex_lock(&q->lock);
+    if(q->bottom > q->top) {
+        *task = q->tasks[--q->bottom];
+        got = true;
+    }
+    pthread_mutex_unlock(&q->lock);
+
+    return got;
+}
+
+
+/**
+ * @brief Takes file from the top of queue of other worker
+ * @return True if queue was not empty
+ */
+static bool queue_steal(work_queue_t *q, size_t *task) {
+    bool got = false;
+
+    pthread_mutex_lock(&q->lock);
+    if(q->bottom > q->top) {
+        *task = q->tasks[q->top++];
+        got = true;
+    }
+    pthread_mutex_unlock(&q->lock);
+
+    return got;
+}
+
+
+/**
+ * @brief Finds next file for worker (own queue is preferred)
+ * @return False if there is nothing to do (files are not added during batch,
+ *         so all queues are empty for good)
+ */
+static bool get_task(batch_t *b, unsigned id, size_t *task) {
+    if(queue_pop(&b->queues[id], task)) {
+        return true;
+    }
+
+    for(unsigned i = 1; i < b->worker_num; i++) {
+        if(queue_steal(&b->queues[(id + i) % b->worker_num], task)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Writes whole buffer to the file with given name
+ */
+static int write_file(const char *name, const char *content, size_t length) {
+    FILE *f = fopen(name, "wb");
+    if(!f) {
+        return INTERNAL_ERROR;
+    }
+
+    size_t written = fwrite(content, sizeof(char), length, f);
+    if(fclose(f) != 0 || written != length) {
+        return INTERNAL_ERROR;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * @brief Prints status of compiled file (and its diagnostic messages) to the log
+ */
+static void log_status(batch_t *b, batch_file_t *file, compile_result_t *res) {
+    if(!b->log) {
+        return;
+    }
+
+    pthread_mutex_lock(&b->log_lock);
+    if(file->ret_code == EXIT_SUCCESS) {
+        fprintf(b->log, "\033[0;32m[  OK  ]\033[0m %s%s\n", file->path, file->cache_hit ? " (cached)" : "");
+    }
+    else {
+        fprintf(b->log, "\033[0;31m[FAILED]\033[0m %s (return code %d)\n",
+                file->path, file->ret_code);
+    }
+
+    if(res && res->diag_len > 0) {
+        fwrite(res->diag, sizeof(char), res->diag_len, b->log);
+    }
+    pthread_mutex_unlock(&b->log_lock);
+}
+
+
+/**
+ * @brief Compiles one file of batch (output is written only if compilation was successful)
+ */
+static void compile_file(batch_t *b, batch_file_t *file) {
+    FILE *src_file = fopen(file->path, "rb");
+    if(!src_file) {
+        file->ret_code = INTERNAL_ERROR;
+        log_status(b, file, NULL);
+        return;
+    }
+
+    char *src = NULL;
+    int ret = read_stream(src_file, &src, &file->src_len);
+    fclose(src_file);
+    if(ret != EXIT_SUCCESS) {
+        file->ret_code = INTERNAL_ERROR;
+        log_status(b, file, NULL);
+        return;
+    }
+
+    compile_result_t res;
+    file->ret_code = compile_buffer(src, file->src_len, b->opts, &res);
+    file->cache_hit = res.cache_hit;
+    free(src);
+
+    if(file->ret_code == EXIT_SUCCESS) {
+        char *out_name = get_output_name(file->path);
+        if(!out_name || write_file(out_name, res.code, res.code_len) != EXIT_SUCCESS) {
+            file->ret_code = INTERNAL_ERROR;
+        }
+
+        free(out_name);
+    }
+
+    log_status(b, file, &res);
+    compile_result_dtor(&res);
+}
+
+
+/**
+ * @brief Main function of worker thread
+ */
+static void *worker_run(void *arg) {
+    worker_t *w = (worker_t *)arg;
+
+    size_t task;
+    while(get_task(w->batch, w->id, &task)) {
+        compile_file(w->batch, &w->batch->files[task]);
+    }
+
+    return NULL;
+}
+
+
+/**
+ * @brief Distributes files to queues of workers (every worker gets continuous block)
+ */
+static int init_queues(batch_t *b, size_t path_num) {
+    b->queues = calloc(b->worker_num, sizeof(work_queue_t));
+    if(!b->queues) {
+        return INTERNAL_ERROR;
+    }
+
+    size_t block = path_num / b->worker_num, rest = path_num % b->worker_num;
+    size_t next = 0;
+    for(unsigned i = 0; i < b->worker_num; i++) {
+        work_queue_t *q = &b->queues[i];
+        size_t len = block + (i < rest ? 1 : 0);
+
+        q->tasks = malloc((len > 0 ? len : 1) * sizeof(size_t));
+        if(!q->tasks) {
+            return INTERNAL_ERROR;
+        }
+
+        //Owner pops from the bottom so files are stored in reversed order
+        for(size_t j = 0; j < len; j++) {
+            q->tasks[len - j - 1] = next++;
+        }
+
+        q->top = 0;
+        q->bottom = len;
+        pthread_mutex_init(&q->lock, NULL);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+static void queues_dtor(batch_t *b) {
+    if(!b->queues) {
+        return;
+    }
+
+    for(unsigned i = 0; i < b->worker_num; i++) {
+        if(b->queues[i].tasks) {
+            free(b->queues[i].tasks);
+            pthread_mutex_destroy(&b->queues[i].lock);
+        }
+    }
+
+    free(b->queues);
+    b->queues = NULL;
+}
+
+
+static double get_time() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+
+
+/**
+ * @brief Prints overall statistics of batch to the log
+ */
+static void log_stats(FILE *log, batch_stats_t *stats, bool cache_used) {
+    if(!log) {
+        return;
+    }
+
+    double seconds = stats->seconds > 0 ? stats->seconds : 1e-9;
+    fprintf(log, "\n\033[1;37mCompiled %lu files\033[0m (%lu failed) in %.3f s using %u workers\n",
+            stats->file_num, stats->failed_num, stats->seconds, stats->workers);
+    fprintf(log, "Throughput: %.1f files/s, %.2f MB/s\n",
+            stats->file_num / seconds, stats->bytes / seconds / 1e6);
+    if(cache_used) {
+        fprintf(log, "Cache: %lu hits, %lu misses\n", stats->cache_hits, stats->cache_misses);
+    }
+}
+
+
+int batch_compile(char **paths, size_t path_num, unsigned workers,
+                  const compile_opts_t *opts, FILE *log, batch_stats_t *stats) {
+    batch_t b;
+    b.opts = opts;
+    b.worker_num = get_worker_num(workers, path_num, MAX_WORKERS);
+    b.log = log;
+    b.queues = NULL;
+    b.files = calloc(path_num > 0 ? path_num : 1, sizeof(batch_file_t));
+    if(!b.files) {
+        return INTERNAL_ERROR;
+    }
+
+    for(size_t i = 0; i < path_num; i++) {
+        b.files[i].path = paths[i];
+        b.files[i].ret_code = EXIT_SUCCESS;
+        b.files[i].src_len = 0;
+        b.files[i].cache_hit = false;
+    }
+
+    if(init_queues(&b, path_num) != EXIT_SUCCESS) {
+        queues_dtor(&b);
+        free(b.files);
+        return INTERNAL_ERROR;
+    }
+
+    pthread_mutex_init(&b.log_lock, NULL);
+
+    double start = get_time();
+
+    //Calling thread works as the first worker
+    worker_t w[MAX_WORKERS];
+    unsigned started = 1;
+    for(unsigned i = 0; i < b.worker_num; i++) {
+        w[i].batch = &b;
+        w[i].id = i;
+        if(i > 0) {
+            if(pthread_create(&w[i].thread, NULL, worker_run, &w[i]) != 0) {
+                break; //Files of missing workers are stolen by the others
+            }
+
+            started++;
+        }
+    }
+
+    worker_run(&w[0]);
+    for(unsigned i = 1; i < started; i++) {
+        pthread_join(w[i].thread, NULL);
+    }
+
+    bool cache_used = opts && opts->cache_dir;
+    batch_stats_t st = {path_num, 0, 0, started, get_time() - start, 0, 0};
+    int ret = EXIT_SUCCESS;
+    for(size_t i = 0; i < path_num; i++) {
+        st.bytes += b.files[i].src_len;
+        if(b.files[i].cache_hit) {
+            st.cache_hits++;
+        }
+        else if(cache_used) {
+            st.cache_misses++;
+        }
+
+        if(b.files[i].ret_code != EXIT_SUCCESS) {
+            if(st.failed_num == 0) {
+                ret = b.files[i].ret_code;
+            }
+
+            st.failed_num++;
+        }
+    }
+
+    log_stats(log, &st, cache_used);
+    if(stats) {
+        *stats = st;
+    }
+
+    pthread_mutex_destroy(&b.log_lock);
+    queues_dtor(&b);
+    free(b.files);
+
+    return ret;
+}
+
+
+/***                              End of batch.c                           ***/
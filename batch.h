@@ -0,0 +1,86 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                 batch.h
+ * 
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ * 
+ *    Purpose: Parallel compilation of more files (batch mode of compiler)
+ * 
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/ 
+
+/**
+ * @file batch.h
+ * @brief Parallel compilation of more files (batch mode of compiler)
+ * @note Files are distributed to queues of workers, worker with empty queue 
+ *       steals files from queues of other workers (work stealing)
+ * 
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */ 
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "compiler.h"
+
+#define OUTPUT_EXTENSION ".code" /**< Extension of files with generated code */
+#define INPUT_EXTENSION ".tl" /**< Extension of source files (it is replaced by OUTPUT_EXTENSION) */
+#define MAX_WORKERS 256 /**< Upper limit of number of workers (threads) */
+
+
+/**
+ * @brief Result of compilation of one file in batch
+ */ 
+typedef struct batch_file {
+    const char *path; /**< Path to source file */
+    int ret_code; /**< Return code of compilation */
+    size_t src_len; /**< Size of source file */
+    bool cache_hit; /**< True if result of compilation was found in cache */
+} batch_file_t;
+
+
+/**
+ * @brief Overall statistics of batch compilation
+ */ 
+typedef struct batch_stats {
+    size_t file_num; /**< Number of compiled files */
+    size_t failed_num; /**< Number of files, that weren't compiled successfully */
+    size_t bytes; /**< Total size of source files */
+    unsigned workers; /**< Number of used workers (threads) */
+    double seconds; /**< Wall time of whole batch */
+    size_t cache_hits; /**< Number of files, whose result was found in cache */
+    size_t cache_misses; /**< Number of files, that had to be compiled (only if cache is used) */
+} batch_stats_t;
+
+
+/**
+ * @brief Creates name of output file (extension .tl is replaced by .code, otherwise .code is appended)
+ * @return Pointer to dynamically allocated name (caller must free it) or NULL if allocation failed
+ */ 
+char *get_output_name(const char *path);
+
+
+/**
+ * @brief Compiles all given files concurrently, for every file.tl creates file.code 
+ *        (only if compilation was successful)
+ * @param paths Array with paths to source files
+ * @param path_num Number of paths
+ * @param workers Number of workers (threads), if it is 0 number of online processors is used
+ * @param opts Options of compilation of every file (NULL means default options)
+ * @param log Stream for status of every file and overall statistics (NULL means no logging)
+ * @param stats Output parameter for statistics of batch (can be NULL)
+ * @return EXIT_SUCCESS if all files were compiled successfully, otherwise return code 
+ *         of the first failed file (in order of paths)
+ */ 
+int batch_compile(char **paths, size_t path_num, unsigned workers, 
+                  const compile_opts_t *opts, FILE *log, batch_stats_t *stats);
+
+
+#endif
+
+/***                              End of batch.h                           ***/
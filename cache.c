@@ -0,0 +1,330 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                 cache.c
+ * 
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ * 
+ *         Purpose: On-disk cache of results of compilation
+ * 
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/ 
+
+/**
+ * @file cache.c
+ * @brief On-disk cache of results of compilation
+ * @note For more documentation about functions and structures @see cache.h
+ * 
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */ 
+
+#define _POSIX_C_SOURCE 200809L /**< Because of mkstemp(), directory listing and utimensat() */
+
+#include "cache.h"
+#include "dstring.h"
+#include "scanner.h"
+#include "generator.h"
+
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define KEY_NAME_LEN 16 /**< Key is written as 16 hexadecimal digits */
+
+
+/**
+ * @brief Header of entry (it is followed by source code, generated code and diagnostic messages)
+ */ 
+typedef struct entry_header {
+    char magic[sizeof(CACHE_MAGIC) - 1];
+    uint64_t key; /**< Full key (to detect collisions of file names) */
+    uint64_t salt; /**< Salt of code generator, that produced entry */
+    uint8_t opt_level;
+    int32_t ret_code;
+    uint64_t src_len;
+    uint64_t code_len;
+    uint64_t diag_len;
+} entry_header_t;
+
+
+uint64_t cache_key(const char *src, size_t src_len, const compile_opts_t *opts) {
+    //Entries of older versions of compiler are not valid (they can contain different code)
+    uint64_t salt = codegen_salt();
+
+    uint64_t hash = hash_bytes(src, src_len, HASH_INIT);
+    hash = hash_bytes(&salt, sizeof(salt), hash);
+
+    //Only level of optimizations influences generated code (token streams and memory management have no effect on it)
+    uint8_t opt_level = (uint8_t)opts->opt_level;
+    hash = hash_bytes(&opt_level, sizeof(opt_level), hash);
+
+    return hash;
+}
+
+
+cache_id_t cache_id(const char *src, size_t src_len, const compile_opts_t *opts) {
+    cache_id_t id = {.key = cache_key(src, src_len, opts), .salt = codegen_salt(), 
+                     .opt_level = (uint8_t)opts->opt_level, .src = src, .src_len = src_len};
+
+    return id;
+}
+
+
+/**
+ * @brief Creates path to entry with given key
+ * @return Dynamically allocated path (caller must free it) or NULL
+ */ 
+static char *entry_path(const char *dir, uint64_t key, const char *suffix) {
+    size_t len = strlen(dir) + 1 + KEY_NAME_LEN + strlen(CACHE_EXTENSION) + strlen(suffix) + 1;
+    char *path = malloc(len);
+    if(path) {
+        snprintf(path, len, "%s/%016llx%s%s", dir, (unsigned long long)key, CACHE_EXTENSION, suffix);
+    }
+
+    return path;
+}
+
+
+/**
+ * @brief Makes copy of part of entry terminated by '\0'
+ */ 
+static char *copy_part(const char *src, size_t len) {
+    char *dst = malloc(len + 1);
+    if(dst) {
+        memcpy(dst, src, len);
+        dst[len] = '\0';
+    }
+
+    return dst;
+}
+
+
+/**
+ * @brief Checks, that entry was created from the same source code with the same options (not only with same key)
+ */ 
+static bool is_entry_of(entry_header_t *h, const char *content, size_t len, const cache_id_t *id) {
+    if(memcmp(h->magic, CACHE_MAGIC, sizeof(h->magic)) != 0 || h->key != id->key || h->salt != id->salt || 
+       h->opt_level != id->opt_level || h->src_len != id->src_len) {
+        return false;
+    }
+
+    size_t data_len = len - sizeof(*h);
+    if(h->src_len > data_len || h->code_len > data_len - h->src_len || 
+       h->diag_len != data_len - h->src_len - h->code_len) {
+        return false;
+    }
+
+    return memcmp(&content[sizeof(*h)], id->src, id->src_len) == 0;
+}
+
+
+bool cache_load(const char *dir, const cache_id_t *id, compile_result_t *result) {
+    char *path = entry_path(dir, id->key, "");
+    if(!path) {
+        return false;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if(!f) {
+        free(path);
+        return false;
+    }
+
+    char *content = NULL;
+    size_t len = 0;
+    int ret = read_stream(f, &content, &len);
+    fclose(f);
+    if(ret != EXIT_SUCCESS) {
+        free(path);
+        return false;
+    }
+
+    entry_header_t h;
+    bool valid = len >= sizeof(h);
+    if(valid) {
+        memcpy(&h, content, sizeof(h));
+        valid = is_entry_of(&h, content, len, id);
+    }
+
+    if(valid) {
+        size_t code_start = sizeof(h) + h.src_len;
+
+        compile_result_init(result);
+        result->ret_code = h.ret_code;
+        result->code = copy_part(&content[code_start], h.code_len);
+        result->code_len = h.code_len;
+        result->diag = copy_part(&content[code_start + h.code_len], h.diag_len);
+        result->diag_len = h.diag_len;
+        result->cache_hit = true;
+
+        if(!result->code || !result->diag) {
+            compile_result_dtor(result);
+            valid = false;
+        }
+        else {
+            utimensat(AT_FDCWD, path, NULL, 0); //Entry was used (it is the last candidate for eviction)
+        }
+    }
+
+    free(content);
+    free(path);
+
+    return valid;
+}
+
+
+int cache_store(const char *dir, const cache_id_t *id, compile_result_t *result, size_t max_size) {
+    char *path = entry_path(dir, id->key, "");
+    char *tmp_path = entry_path(dir, id->key, ".XXXXXX");
+    if(!path || !tmp_path) {
+        free(path);
+        free(tmp_path);
+        return INTERNAL_ERROR;
+    }
+
+    entry_header_t h;
+    memset(&h, 0, sizeof(h)); //Padding is written too
+    memcpy(h.magic, CACHE_MAGIC, sizeof(h.magic));
+    h.key = id->key;
+    h.salt = id->salt;
+    h.opt_level = id->opt_level;
+    h.ret_code = result->ret_code;
+    h.src_len = id->src_len;
+    h.code_len = result->code_len;
+    h.diag_len = result->diag_len;
+
+    //Entry is created under unique temporary name and then it is atomically renamed
+    int ret = INTERNAL_ERROR;
+    mkdir(dir, 0777); //Directory may not exist yet (if it exists, mkstemp() reports possible problems)
+    int fd = mkstemp(tmp_path);
+    FILE *f = (fd >= 0) ? fdopen(fd, "wb") : NULL;
+    if(f) {
+        bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+                  fwrite(id->src, sizeof(char), id->src_len, f) == id->src_len &&
+                  fwrite(result->code, sizeof(char), result->code_len, f) == result->code_len &&
+                  fwrite(result->diag, sizeof(char), result->diag_len, f) == result->diag_len;
+
+        if(fclose(f) == 0 && ok && rename(tmp_path, path) == 0) {
+            ret = EXIT_SUCCESS;
+        }
+    }
+    else if(fd >= 0) {
+        close(fd);
+    }
+
+    if(ret != EXIT_SUCCESS && fd >= 0) {
+        unlink(tmp_path);
+    }
+
+    free(path);
+    free(tmp_path);
+
+    if(ret == EXIT_SUCCESS) {
+        cache_evict(dir, max_size);
+    }
+
+    return ret;
+}
+
+
+/**
+ * @brief Entry found in directory of cache
+ */ 
+typedef struct dir_entry {
+    char *path;
+    size_t size;
+    struct timespec used; /**< Time of the last usage */
+} dir_entry_t;
+
+
+static int cmp_usage(const void *a, const void *b) {
+    const dir_entry_t *e1 = a, *e2 = b;
+    if(e1->used.tv_sec != e2->used.tv_sec) {
+        return (e1->used.tv_sec < e2->used.tv_sec) ? -1 : 1;
+    }
+    else if(e1->used.tv_nsec != e2->used.tv_nsec) {
+        return (e1->used.tv_nsec < e2->used.tv_nsec) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Returns true if file name is name of entry (temporary files are ignored)
+ */ 
+static bool is_entry_name(const char *name) {
+    size_t len = strlen(name), ext_len = strlen(CACHE_EXTENSION);
+    return len == KEY_NAME_LEN + ext_len && strcmp(&name[KEY_NAME_LEN], CACHE_EXTENSION) == 0;
+}
+
+
+void cache_evict(const char *dir, size_t max_size) {
+    DIR *d = opendir(dir);
+    if(!d) {
+        return;
+    }
+
+    dir_entry_t *entries = NULL;
+    size_t num = 0, alloc_size = 0, total = 0;
+
+    struct dirent *de;
+    while((de = readdir(d)) != NULL) {
+        if(!is_entry_name(de->d_name)) {
+            continue;
+        }
+
+        if(num == alloc_size) {
+            size_t new_size = alloc_size ? alloc_size * 2 : 64;
+            dir_entry_t *extended = realloc(entries, new_size * sizeof(dir_entry_t));
+            if(!extended) {
+                break;
+            }
+
+            entries = extended;
+            alloc_size = new_size;
+        }
+
+        size_t path_len = strlen(dir) + 1 + strlen(de->d_name) + 1;
+        char *path = malloc(path_len);
+        if(!path) {
+            break;
+        }
+
+        snprintf(path, path_len, "%s/%s", dir, de->d_name);
+
+        struct stat st;
+        if(stat(path, &st) != 0) {
+            free(path);
+            continue; //Entry could be evicted by another process
+        }
+
+        entries[num].path = path;
+        entries[num].size = st.st_size;
+        entries[num].used = st.st_mtim;
+        total += entries[num].size;
+        num++;
+    }
+
+    closedir(d);
+
+    if(total > max_size) { //The least recently used entries are removed first
+        qsort(entries, num, sizeof(dir_entry_t), cmp_usage);
+        for(size_t i = 0; i < num && total > max_size; i++) {
+            unlink(entries[i].path);
+            total -= entries[i].size;
+        }
+    }
+
+    for(size_t i = 0; i < num; i++) {
+        free(entries[i].path);
+    }
+
+    free(entries);
+}
+
+
+/***                              End of cache.c                           ***/
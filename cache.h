@@ -0,0 +1,86 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                 cache.h
+ * 
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ * 
+ *         Purpose: On-disk cache of results of compilation
+ * 
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/ 
+
+/**
+ * @file cache.h
+ * @brief On-disk cache of results of compilation
+ * @note Entries are addressed by hash of source code, version of compiler and options,
+ *       that influence generated code. Every entry is one file in directory of cache,
+ *       time of its last modification is time of its last usage (for LRU eviction).
+ * 
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */ 
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "compiler.h"
+
+#define CACHE_MAGIC "IFJ21CC2" /**< The first bytes of every entry */
+#define CACHE_EXTENSION ".ifjc" /**< Extension of files with entries */
+#define CACHE_DEFAULT_SIZE (64 * 1024 * 1024) /**< Default size limit of cache (in bytes) */
+
+
+/**
+ * @brief Identification of result of compilation in cache
+ * @note Key is only hash, so entry stores also everything it was computed from (to detect collisions of keys)
+ */
+typedef struct cache_id {
+    uint64_t key; /**< Name of entry (@see cache_key()) */
+    uint64_t salt; /**< Salt of code generator (@see codegen_salt()) */
+    uint8_t opt_level; /**< Level of optimizations */
+    const char *src; /**< Source code (it is not copied) */
+    size_t src_len;
+} cache_id_t;
+
+
+/**
+ * @brief Computes key of entry in cache
+ */ 
+uint64_t cache_key(const char *src, size_t src_len, const compile_opts_t *opts);
+
+/**
+ * @brief Creates identification of result of compilation of given source code with given options
+ */ 
+cache_id_t cache_id(const char *src, size_t src_len, const compile_opts_t *opts);
+
+/**
+ * @brief Tries to find result of compilation in cache (found entry is marked as recently used)
+ * @note Entry is used only if its source code, salt and level of optimizations are same as in id
+ * @param result Output parameter, it is filled only if entry was found (it must be freed by compile_result_dtor())
+ * @return True if entry was found
+ */ 
+bool cache_load(const char *dir, const cache_id_t *id, compile_result_t *result);
+
+/**
+ * @brief Stores result of compilation to cache and evicts the least recently used entries 
+ *        if size of cache exceeds given limit
+ * @note Entry is written to temporary file, that is renamed, so readers never see incomplete entry
+ *       (cache directory is created if it does not exist)
+ * @return INTERNAL_ERROR if entry could not be written
+ */ 
+int cache_store(const char *dir, const cache_id_t *id, compile_result_t *result, size_t max_size);
+
+/**
+ * @brief Removes the least recently used entries until size of cache is at most max_size
+ */ 
+void cache_evict(const char *dir, size_t max_size);
+
+
+#endif
+
+/***                              End of cache.h                           ***/
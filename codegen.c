@@ -0,0 +1,412 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                codegen.c
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *      Purpose: Generating of target code from abstract syntax tree
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file codegen.c
+ * @brief Generating of target code from abstract syntax tree
+ * @note For more documentation about functions and structures @see codegen.h
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#define _POSIX_C_SOURCE 200809L /**< Because of pthreads */
+
+#include "codegen.h"
+#include "precedence_parser.h"
+#include "workers.h"
+
+#include <string.h>
+#include <pthread.h>
+
+
+/**
+ * @brief State of walk over body of function
+ */
+typedef struct codegen {
+    prog_t *dst; /**< Program, where instructions are appended */
+    const char *f_name; /**< Name of function (labels of conditions and loops contain it) */
+    size_t nest_lvl; /**< Number of loops around current statement */
+} codegen_t;
+
+
+static void gen_block(codegen_t *gen, ast_node_t *block);
+
+
+static void gen_call(prog_t *dst, ast_node_t *call) {
+    bool call_each = call->flags & AST_CALL_EACH;
+    for(ast_node_t *arg = call->a; arg; arg = arg->next) {
+        codegen_expression(dst, arg);
+        if(call_each) {
+            generate_call_function(dst, call->u.name);
+        }
+    }
+
+    if(!call_each) {
+        generate_call_function(dst, call->u.name);
+    }
+}
+
+
+void codegen_expression(prog_t *dst, ast_node_t *expr) {
+    if(!expr) {
+        return;
+    }
+
+    switch(expr->kind) {
+        case AST_VAR:
+            generate_value_push(dst, VAR, expr->m, expr->u.name);
+            break;
+        case AST_NUM:
+            generate_num_push(dst, expr->m, expr->u.num);
+            break;
+        case AST_VAL:
+            generate_value_push(dst, VAL, expr->m, expr->u.name);
+            break;
+        case AST_CALL:
+            gen_call(dst, expr);
+            break;
+        case AST_OP: { //Operands are evaluated first (code of expression is in postfix order)
+            codegen_expression(dst, expr->a);
+            codegen_expression(dst, expr->b);
+
+            const expr_rule_t *rule = get_rule(expr->n);
+            if(rule && rule->generator_function) {
+                rule->generator_function(dst);
+            }
+
+            break;
+        }
+        case AST_DUMP:
+            codegen_expression(dst, expr->a);
+            generate_dump_values(dst, expr->n, expr->m);
+            break;
+        case AST_INT2NUM:
+            codegen_expression(dst, expr->a);
+            for(uint32_t i = 0; i < expr->n; i++) {
+                impl_int2num(dst);
+            }
+
+            break;
+        default:
+            dst->int_error = true; //Statement cannot be in expression
+            break;
+    }
+}
+
+
+/**
+ * @brief Generates values in reversed order (values of assignment are evaluated from right to left)
+ */
+static void gen_reversed(prog_t *dst, ast_node_t *values) {
+    if(values) {
+        gen_reversed(dst, values->next);
+        codegen_expression(dst, values);
+    }
+}
+
+
+/**
+ * @brief Declares all variables from loop body (including nested blocks) before the loop
+ */
+static void gen_declarations(prog_t *dst, ast_node_t *block) {
+    for(ast_node_t *stmt = block; stmt; stmt = stmt->next) {
+        if(stmt->kind == AST_LOCAL) {
+            generate_declare_variable(dst, stmt->u.name);
+        }
+        else if(stmt->kind == AST_IF) {
+            gen_declarations(dst, stmt->b);
+            gen_declarations(dst, stmt->u.c);
+        }
+        else if(stmt->kind == AST_WHILE) {
+            gen_declarations(dst, stmt->b);
+        }
+    }
+}
+
+
+/**
+ * @brief Returns how condition of statement is evaluated (comparison by "==" or "~=" is fused with jump)
+ */
+static cond_kind_t get_cond_kind(ast_node_t *stmt) {
+    ast_node_t *cond = stmt->a;
+    if(cond->kind == AST_OP) {
+        const char *pattern = get_rule(cond->n)->right_side;
+        if(strcmp(pattern, "E==E") == 0) {
+            return COND_EQ;
+        }
+        else if(strcmp(pattern, "E~=E") == 0) {
+            return COND_NEQ;
+        }
+    }
+
+    return stmt->m == BOOL ? COND_BOOL : COND_ANY;
+}
+
+
+/**
+ * @brief Generates condition of statement (only operands are generated if comparison is fused with jump)
+ */
+static void gen_condition(prog_t *dst, ast_node_t *stmt, cond_kind_t kind) {
+    if(kind == COND_EQ || kind == COND_NEQ) {
+        codegen_expression(dst, stmt->a->a);
+        codegen_expression(dst, stmt->a->b);
+    }
+    else {
+        codegen_expression(dst, stmt->a);
+    }
+}
+
+
+static void gen_while(codegen_t *gen, ast_node_t *loop) {
+    generate_while_start(gen->dst, loop->n, gen->nest_lvl);
+    if(gen->nest_lvl == 0) { //Variables cannot be defined again in the next iteration
+        gen_declarations(gen->dst, loop->b);
+    }
+
+    cond_kind_t kind = get_cond_kind(loop);
+    generate_while_condition_beginning(gen->dst, gen->f_name, loop->n);
+    gen_condition(gen->dst, loop, kind);
+    generate_while_condition_evaluate(gen->dst, gen->f_name, loop->n, kind);
+
+    gen->nest_lvl++;
+    gen_block(gen, loop->b);
+    gen->nest_lvl--;
+
+    generate_while_end(gen->dst, gen->f_name, loop->n);
+}
+
+
+static void gen_statement(codegen_t *gen, ast_node_t *stmt) {
+    prog_t *dst = gen->dst;
+    switch(stmt->kind) {
+        case AST_LOCAL:
+            if(gen->nest_lvl == 0) { //Otherwise it was declared before the loop
+                generate_declare_variable(dst, stmt->u.name);
+            }
+
+            if(stmt->a) {
+                codegen_expression(dst, stmt->a);
+                generate_assign_value(dst, stmt->u.name);
+            }
+
+            break;
+        case AST_ASSIGN:
+            gen_reversed(dst, stmt->b);
+            for(ast_node_t *var = stmt->a; var; var = var->next) {
+                if(var->flags & AST_CONVERT) {
+                    impl_int2num(dst);
+                }
+
+                generate_assign_value(dst, var->u.name);
+            }
+
+            break;
+        case AST_CALL:
+            gen_call(dst, stmt);
+            break;
+        case AST_IF: {
+            cond_kind_t kind = get_cond_kind(stmt);
+            gen_condition(dst, stmt, kind);
+            generate_if_condition(dst, gen->f_name, stmt->n, kind);
+            gen_block(gen, stmt->b);
+            generate_if_end(dst, gen->f_name, stmt->n);
+            gen_block(gen, stmt->u.c);
+            generate_else_end(dst, gen->f_name, stmt->n);
+            break;
+        }
+        case AST_WHILE:
+            gen_while(gen, stmt);
+            break;
+        case AST_RETURN: {
+            generate_additional_returns(dst, stmt->n);
+
+            size_t cnt = 0;
+            for(ast_node_t *value = stmt->a; value; value = value->next, cnt++) {
+                codegen_expression(dst, value);
+            }
+
+            generate_reverse_stack(dst, cnt);
+            generate_return(dst);
+            break;
+        }
+        default:
+            dst->int_error = true; //Expression cannot be statement
+            break;
+    }
+}
+
+
+static void gen_block(codegen_t *gen, ast_node_t *block) {
+    for(ast_node_t *stmt = block; stmt; stmt = stmt->next) {
+        gen_statement(gen, stmt);
+    }
+}
+
+
+static void gen_function(codegen_t *gen, ast_node_t *func) {
+    gen->f_name = func->u.name;
+
+    generate_start_function(gen->dst, func->u.name);
+    for(ast_node_t *param = func->a; param; param = param->next) {
+        generate_parameter(gen->dst, param->u.name);
+    }
+
+    gen_block(gen, func->b);
+
+    generate_additional_returns(gen->dst, func->n);
+    generate_end_function(gen->dst, func->u.name);
+}
+
+
+void codegen_global(prog_t *dst, ast_node_t *node, opt_level_t level, ast_t *ast) {
+    codegen_t gen = {.dst = dst, .f_name = NULL, .nest_lvl = 0};
+
+    ssa_optimize(node, level, ast);
+
+    if(node->kind == AST_FUNCTION) {
+        if(!(node->flags & AST_REUSED)) { //Code of reused function is already in program
+            gen_function(&gen, node);
+        }
+    }
+    else {
+        gen_statement(&gen, node);
+    }
+}
+
+
+/**
+ * @brief Global statements shared by workers of parallel code generation
+ */
+typedef struct codegen_jobs {
+    ast_node_t **nodes; /**< Global statements in source order */
+    prog_t *parts; /**< Code of global statements (part with the same index as statement) */
+    size_t num; /**< Number of global statements */
+    size_t next; /**< Index of the first statement, that was not taken by any worker */
+    pthread_mutex_t lock;
+    bool use_arena; /**< Compilation allocates from arena, so workers use their own arenas (@see arena.h) */
+    opt_level_t level; /**< Level of optimizations of statements */
+} codegen_jobs_t;
+
+
+/**
+ * @brief Arguments of worker thread
+ */
+typedef struct codegen_worker {
+    codegen_jobs_t *jobs;
+    arena_t arena; /**< Memory of code generated by worker (it is adopted by arena of compilation) */
+    ast_t nodes; /**< Nodes created by optimizations (its arena is adopted by the whole tree) */
+    pthread_t thread;
+} codegen_worker_t;
+
+
+/**
+ * @brief Takes global statements one by one and generates their code into their own programs
+ */
+static void *codegen_run(void *arg) {
+    codegen_worker_t *w = (codegen_worker_t *)arg;
+    codegen_jobs_t *jobs = w->jobs;
+
+    arena_t *prev_arena = jobs->use_arena ? arena_use(&w->arena) : NULL;
+    while(true) {
+        pthread_mutex_lock(&jobs->lock);
+        size_t i = jobs->next++;
+        pthread_mutex_unlock(&jobs->lock);
+
+        if(i >= jobs->num) {
+            break;
+        }
+
+        codegen_global(&jobs->parts[i], jobs->nodes[i], jobs->level, &w->nodes);
+    }
+
+    if(jobs->use_arena) {
+        arena_use(prev_arena);
+    }
+
+    return NULL;
+}
+
+
+void codegen_parallel(prog_t *dst, ast_t *ast, unsigned workers, opt_level_t level) {
+    ast_node_t *first = ast->first;
+    codegen_jobs_t jobs = {.nodes = NULL, .parts = NULL, .num = 0, .next = 0, .use_arena = arena_active(), .level = level};
+    for(ast_node_t *node = first; node; node = node->next) {
+        jobs.num++;
+    }
+
+    unsigned worker_num = get_worker_num(workers, jobs.num, CODEGEN_MAX_WORKERS);
+    if(worker_num > 1) {
+        jobs.nodes = (ast_node_t **)mem_alloc(sizeof(ast_node_t *) * jobs.num);
+        jobs.parts = (prog_t *)mem_alloc(sizeof(prog_t) * jobs.num);
+    }
+
+    if(!jobs.nodes || !jobs.parts) { //Code is generated by calling thread in place
+        mem_free(jobs.parts);
+        mem_free(jobs.nodes);
+        for(ast_node_t *node = first; node; node = node->next) {
+            codegen_global(dst, node, level, ast);
+        }
+
+        return;
+    }
+
+    size_t i = 0;
+    for(ast_node_t *node = first; node; node = node->next, i++) {
+        jobs.nodes[i] = node;
+        init_new_prog(&jobs.parts[i]);
+    }
+
+    pthread_mutex_init(&jobs.lock, NULL);
+
+    //Calling thread works as the first worker
+    codegen_worker_t w[CODEGEN_MAX_WORKERS];
+    unsigned started = 1;
+    for(unsigned u = 0; u < worker_num; u++) {
+        w[u].jobs = &jobs;
+        arena_init(&w[u].arena);
+        ast_init(&w[u].nodes);
+        if(u > 0) {
+            if(pthread_create(&w[u].thread, NULL, codegen_run, &w[u]) != 0) {
+                break; //Statements are taken by the others
+            }
+
+            started++;
+        }
+    }
+
+    codegen_run(&w[0]);
+    for(unsigned u = 1; u < started; u++) {
+        pthread_join(w[u].thread, NULL);
+    }
+
+    pthread_mutex_destroy(&jobs.lock);
+
+    //Parts are appended in source order, so the result is the same as if code was generated by one thread
+    for(i = 0; i < jobs.num; i++) {
+        app_prog(dst, &jobs.parts[i]);
+    }
+
+    for(unsigned u = 0; u < started; u++) {
+        if(jobs.use_arena) {
+            arena_adopt(arena_current(), &w[u].arena);
+        }
+
+        arena_adopt(&ast->arena, &w[u].nodes.arena);
+    }
+
+    mem_free(jobs.parts);
+    mem_free(jobs.nodes);
+}
+
+
+/***                             End of codegen.c                          ***/
@@ -0,0 +1,59 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                codegen.h
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *      Purpose: Generating of target code from abstract syntax tree
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file codegen.h
+ * @brief Generating of target code from abstract syntax tree
+ * @note Tree is walked in source order and instructions are made by functions from generator.h
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#ifndef CODEGEN_H
+#define CODEGEN_H
+
+#include "ast.h"
+#include "ssa.h"
+#include "generator.h"
+
+#define CODEGEN_MAX_WORKERS 64 /**< Upper limit of number of threads generating code */
+
+
+/**
+ * @brief Generates code of global statement (definition of function or function call)
+ * @param level Level of optimizations of statement before its code is generated (@see ssa_optimize())
+ * @param ast Tree, whose arena is used for nodes created by optimizations
+ * @note Declarations of variables inside loops are put before the outermost loop
+ *       (variable cannot be defined twice in target code)
+ */
+void codegen_global(prog_t *dst, ast_node_t *node, opt_level_t level, ast_t *ast);
+
+
+/**
+ * @brief Generates code of all global statements from the first one to the end of list
+ * @param workers Number of threads (0 means number of online processors, 1 means that code is generated by calling thread)
+ * @note Every statement (e. g. function) is generated to its own program by one of workers, then programs are 
+ *       appended to dst in source order, so the result is the same as if codegen_global() was called for every statement
+ */
+void codegen_parallel(prog_t *dst, ast_t *ast, unsigned workers, opt_level_t level);
+
+
+/**
+ * @brief Generates code of expression (its values are left on the top of the stack)
+ */
+void codegen_expression(prog_t *dst, ast_node_t *expr);
+
+
+#endif
+
+/***                             End of codegen.h                          ***/
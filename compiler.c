@@ -0,0 +1,310 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                compiler.c
+ * 
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ * 
+ *      Purpose: Reentrant interface of compiler (compilation of buffers)
+ * 
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/ 
+
+/**
+ * @file compiler.c
+ * @brief Reentrant interface of compiler (compilation of buffers)
+ * @note For more documentation about functions and structures @see compiler.h
+ * 
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */ 
+
+#define _POSIX_C_SOURCE 200809L /**< Because of open_memstream() */
+
+#include "compiler.h"
+#include "parser_topdown.h"
+#include "scanner.h"
+#include "tokstream.h"
+#include "cache.h"
+#include "funccache.h"
+#include "arena.h"
+
+
+void compile_opts_init(compile_opts_t *opts) {
+    opts->dump_tokens = NULL;
+    opts->load_tokens = NULL;
+    opts->cache_dir = NULL;
+    opts->cache_max_size = CACHE_DEFAULT_SIZE;
+    opts->incremental = NULL;
+    opts->memory = MEM_HEAP;
+    opts->codegen_workers = 1;
+    opts->opt_level = OPT_NONE;
+}
+
+
+void compile_result_init(compile_result_t *result) {
+    result->ret_code = EXIT_SUCCESS;
+    result->code = NULL;
+    result->code_len = 0;
+    result->diag = NULL;
+    result->diag_len = 0;
+    result->cache_hit = false;
+    result->reused_funcs = 0;
+}
+
+
+/**
+ * @brief Prints warning about token stream file (it does not stop the compilation)
+ */
+static void tokstream_warning(FILE *diag, const char *path, const char *msg) {
+    fprintf(diag, "\033[1;33mWarning:\033[0m Token stream '\033[1;33m%s\033[0m' %s\n", path, msg);
+}
+
+
+/**
+ * @brief Tries to load token stream of source code from file
+ * @return True if token stream was loaded and it belongs to given source
+ */
+static bool load_tokens(tokstream_t *ts, const char *path, const char *src, size_t src_len, FILE *diag) {
+    FILE *f = fopen(path, "rb");
+    if(!f) {
+        tokstream_warning(diag, path, "can't be opened, source is scanned!");
+        return false;
+    }
+
+    int ret = tokstream_read(ts, f);
+    fclose(f);
+    if(ret != EXIT_SUCCESS) {
+        tokstream_warning(diag, path, "is not valid, source is scanned!");
+        return false;
+    }
+    else if(!tokstream_matches(ts, src, src_len)) {
+        tokstream_warning(diag, path, "is stale (source was changed), source is scanned!");
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Scans whole source code to token stream
+ * @return True if token stream was recorded (it is complete)
+ */
+static bool record_tokens(tokstream_t *ts, const char *src, size_t src_len) {
+    //Errors are reported by the compilation itself, so they are thrown away here
+    char *rec_diag = NULL;
+    size_t rec_diag_len;
+    FILE *rec_diag_f = open_memstream(&rec_diag, &rec_diag_len);
+    if(!rec_diag_f) {
+        return false;
+    }
+
+    scanner_t sc;
+    int ret = scanner_init_buffer(&sc, src, src_len);
+    if(ret == EXIT_SUCCESS) {
+        sc.diag = rec_diag_f;
+        ret = tokstream_record(ts, &sc);
+        scanner_dtor(&sc);
+    }
+
+    fclose(rec_diag_f);
+    free(rec_diag);
+
+    return ret == EXIT_SUCCESS;
+}
+
+
+/**
+ * @brief Scans whole source code and dumps its token stream to file
+ * @return True if token stream was recorded (it is complete)
+ */
+static bool dump_tokens(tokstream_t *ts, const char *path, const char *src, size_t src_len, FILE *diag) {
+    if(!record_tokens(ts, src, src_len)) {
+        tokstream_warning(diag, path, "was not dumped (source contains lexical errors)!");
+        return false;
+    }
+
+    FILE *f = fopen(path, "wb");
+    if(!f || tokstream_write(ts, src, f) != EXIT_SUCCESS || fclose(f) != 0) {
+        tokstream_warning(diag, path, "can't be written!");
+    }
+
+    return true; //Stream can be used even if it was not written
+}
+
+
+/**
+ * @brief Loads code of functions from previous compilation (sidecar does not have to exist)
+ */
+static void load_sidecar(fcache_t *fc, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if(f) {
+        fcache_read(fc, f); //Invalid sidecar (e.g. from other version of compiler) is ignored
+        fclose(f);
+    }
+}
+
+
+/**
+ * @brief Writes code of functions of current compilation to sidecar
+ */
+static void write_sidecar(fcache_t *fc, const char *path, FILE *diag) {
+    FILE *f = fopen(path, "wb");
+    if(!f || fcache_write(fc, f) != EXIT_SUCCESS || fclose(f) != 0) {
+        fprintf(diag, "\033[1;33mWarning:\033[0m Sidecar '\033[1;33m%s\033[0m' can't be written!\n", path);
+    }
+}
+
+
+/**
+ * @brief Compiles source code and writes generated code to given stream
+ * @param reused Output parameter for number of functions, whose code was taken from sidecar (can be NULL)
+ */
+static int compile(const char *src, size_t src_len, const compile_opts_t *opts, 
+                   FILE *out, FILE *diag, size_t *reused) {
+
+    compile_opts_t defaults;
+    if(!opts) {
+        compile_opts_init(&defaults);
+        opts = &defaults;
+    }
+
+    //Everything allocated by compilation (strings, stacks, symbols, instructions...) is taken from one arena
+    arena_t arena;
+    arena_init(&arena);
+    arena_t *prev_arena = NULL;
+    if(opts->memory != MEM_HEAP) {
+        prev_arena = arena_use(&arena);
+    }
+
+    tokstream_t ts;
+    tokstream_init(&ts);
+
+    bool has_tokens = false;
+    if(opts->load_tokens) {
+        has_tokens = load_tokens(&ts, opts->load_tokens, src, src_len, diag);
+    }
+
+    if(!has_tokens && opts->dump_tokens) {
+        has_tokens = dump_tokens(&ts, opts->dump_tokens, src, src_len, diag);
+    }
+
+    if(!has_tokens && opts->incremental) { //Functions must be known in advance to find them in sidecar
+        has_tokens = record_tokens(&ts, src, src_len);
+    }
+
+    fcache_t fc;
+    fcache_init(&fc);
+    fc.variant = opts->opt_level;
+    bool is_incremental = has_tokens && opts->incremental;
+    if(is_incremental) {
+        load_sidecar(&fc, opts->incremental);
+    }
+
+    int ret_code;
+    scanner_t scanner;
+    parser_t parser;
+    if(scanner_init_buffer(&scanner, src, src_len) != EXIT_SUCCESS) {
+        ret_code = INTERNAL_ERROR;
+    }
+    else {
+        scanner.diag = diag;
+        if(has_tokens) { //Source code is not scanned again
+            scanner_replay(&scanner, ts.records, ts.len);
+        }
+
+        if(parser_setup(&parser, &scanner) != EXIT_SUCCESS) {
+            ret_code = INTERNAL_ERROR;
+        }
+        else {
+            parser.out = out;
+            parser.fcache = is_incremental ? &fc : NULL;
+            parser.codegen_workers = opts->codegen_workers;
+            parser.opt_level = opts->opt_level;
+            ret_code = parse_program(&parser);
+        }
+
+        scanner_dtor(&scanner);
+    }
+
+    //Sidecar is replaced only by complete compilation (functions after error are not compiled)
+    if(is_incremental && ret_code == EXIT_SUCCESS) {
+        write_sidecar(&fc, opts->incremental, diag);
+    }
+
+    if(reused) {
+        *reused = fc.hits;
+    }
+
+    fcache_dtor(&fc);
+    tokstream_dtor(&ts);
+
+    if(opts->memory != MEM_HEAP) {
+        arena_use(prev_arena);
+        if(opts->memory == MEM_ARENA) { //In MEM_EXIT mode memory is released by exit of process
+            arena_release(&arena);
+        }
+    }
+
+    return ret_code;
+}
+
+
+int compile_stream(const char *src, size_t src_len, const compile_opts_t *opts, 
+                   FILE *out, FILE *diag) {
+
+    return compile(src, src_len, opts, out, diag, NULL);
+}
+
+
+int compile_buffer(const char *src, size_t src_len, const compile_opts_t *opts, 
+                   compile_result_t *result) {
+    compile_result_init(result);
+
+    cache_id_t id;
+    if(opts && opts->cache_dir) { //Source does not have to be compiled at all
+        id = cache_id(src, src_len, opts);
+        if(cache_load(opts->cache_dir, &id, result)) {
+            return result->ret_code;
+        }
+    }
+
+    //Generated code and diagnostic messages are written to dynamically allocated buffers
+    FILE *out = open_memstream(&result->code, &result->code_len);
+    FILE *diag = open_memstream(&result->diag, &result->diag_len);
+    if(!out || !diag) {
+        if(out) {
+            fclose(out);
+        }
+        if(diag) {
+            fclose(diag);
+        }
+
+        result->ret_code = INTERNAL_ERROR;
+        return INTERNAL_ERROR;
+    }
+
+    result->ret_code = compile(src, src_len, opts, out, diag, &result->reused_funcs);
+
+    fclose(out);
+    fclose(diag);
+
+    //Internal errors are not cached (they don't depend on source), failure of cache is not failure of compilation
+    if(opts && opts->cache_dir && result->ret_code != INTERNAL_ERROR) {
+        cache_store(opts->cache_dir, &id, result, opts->cache_max_size);
+    }
+
+    return result->ret_code;
+}
+
+
+void compile_result_dtor(compile_result_t *result) {
+    free(result->code);
+    free(result->diag);
+
+    compile_result_init(result);
+}
+
+
+/***                             End of compiler.c                         ***/
@@ -0,0 +1,125 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                compiler.h
+ * 
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ * 
+ *      Purpose: Reentrant interface of compiler (compilation of buffers)
+ * 
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/ 
+
+/**
+ * @file compiler.h
+ * @brief Reentrant interface of compiler (compilation of buffers)
+ * @note Every compilation has its own scanner, parser and generated program,
+ *       so more compilations can run in one process (even in more threads)
+ * 
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */ 
+
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "ssa.h"
+
+/**
+ * @brief Version of compiler (it is part of keys in cache of results and of sidecars, @see codegen_salt())
+ * @note Changes of sources are detected by build (@see codegen_salt()), so it does not have to be changed with them
+ */
+#define COMPILER_VERSION "IFJ21 1.2"
+
+
+/**
+ * @brief Management of memory of one compilation (@see arena.h)
+ */ 
+typedef enum mem_mode {
+    MEM_HEAP, /**< Every structure is allocated and freed separately */
+    MEM_ARENA, /**< Structures are allocated from one arena, that is released at once after compilation */
+    MEM_EXIT, /**< Like MEM_ARENA, but arena is not released at all (only for process, that exits after compilation) */
+} mem_mode_t;
+
+
+/**
+ * @brief Options of compilation
+ */ 
+typedef struct compile_opts {
+    const char *dump_tokens; /**< File, where token stream of source is dumped (NULL if it should not be dumped) */
+    const char *load_tokens; /**< File with token stream, that is used instead of scanning (NULL if source should be scanned) */
+    const char *cache_dir; /**< Directory with cache of results (NULL if cache is not used, @see cache.h) */
+    size_t cache_max_size; /**< Size limit of cache in bytes */
+    const char *incremental; /**< Sidecar with code of functions from previous compilation (NULL if everything is compiled, @see funccache.h) */
+    mem_mode_t memory; /**< Management of memory (it does not affect result of compilation) */
+    unsigned codegen_workers; /**< Number of threads generating code of functions (1 by default, 0 means number of processors, it does not affect result) */
+    opt_level_t opt_level; /**< Level of optimizations of generated code (OPT_NONE by default, @see ssa.h) */
+} compile_opts_t;
+
+
+/**
+ * @brief Result of one compilation
+ */ 
+typedef struct compile_result {
+    int ret_code; /**< Return code of compilation (0 if compilation was successful) */
+    char *code; /**< Generated IFJcode21 (empty if compilation was not successful) */
+    size_t code_len; /**< Length of generated code */
+    char *diag; /**< Diagnostic messages (errors and warnings) */
+    size_t diag_len; /**< Length of diagnostic messages */
+    bool cache_hit; /**< True if result was found in cache (source was not compiled) */
+    size_t reused_funcs; /**< Number of functions, whose code was taken from sidecar of incremental compilation */
+} compile_result_t;
+
+
+/**
+ * @brief Sets default options (source is scanned, nothing is dumped, structures are freed separately)
+ */ 
+void compile_opts_init(compile_opts_t *opts);
+
+
+/**
+ * @brief Sets initial values to result structure (result is empty)
+ */ 
+void compile_result_init(compile_result_t *result);
+
+
+/**
+ * @brief Compiles source code in buffer to IFJcode21 and writes it to given stream
+ * @param opts Options of compilation (NULL means default options)
+ * @param out Stream for generated code
+ * @param diag Stream for diagnostic messages
+ * @note If load_tokens is stale (source code was changed) or invalid, source is scanned 
+ *       and token stream is dumped again (if dump_tokens is set)
+ * @note In incremental mode, unchanged functions are not compiled again and sidecar is updated after successful compilation
+ * @return Return code of compilation
+ */ 
+int compile_stream(const char *src, size_t src_len, const compile_opts_t *opts, 
+                   FILE *out, FILE *diag);
+
+
+/**
+ * @brief Compiles source code in buffer to IFJcode21
+ * @note If cache is set in options, result is taken from cache (or it is stored there after compilation)
+ * @param src Source code in IFJ21
+ * @param src_len Length of source code
+ * @param opts Options of compilation (NULL means default options)
+ * @param result Output parameter, where generated code and diagnostic messages are stored 
+ *               (it must be freed by compile_result_dtor())
+ * @return Return code of compilation (same as ret_code in result)
+ */ 
+int compile_buffer(const char *src, size_t src_len, const compile_opts_t *opts, 
+                   compile_result_t *result);
+
+
+/**
+ * @brief Frees all resources held by result of compilation
+ */ 
+void compile_result_dtor(compile_result_t *result);
+
+
+#endif
+
+/***                             End of compiler.h                         ***/
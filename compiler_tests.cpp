@@ -0,0 +1,852 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                            compiler_tests.cpp
+ * 
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ * 
+ *           Purpose: Tests of reentrant interface of compiler
+ * 
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/ 
+
+/**
+ * @file compiler_tests.cpp
+ * @brief Tests of reentrant interface of compiler
+ * 
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */ 
+
+extern "C" {
+    #include "compiler.h"
+    #include "batch.h"
+    #include "scanner.h"
+    #include "parser_topdown.h"
+    #include "arena.h"
+    #include "cache.h"
+}
+
+#include "gtest/gtest.h"
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <dirent.h>
+#include <unistd.h>
+
+
+class test_fixture : public :: testing :: Test {
+    protected:
+        compile_result_t result;
+
+        virtual void SetUp() {
+            compile_result_init(&result);
+        }
+
+        virtual void TearDown() {
+            compile_result_dtor(&result);
+        }
+
+        int compile(std::string src) {
+            compile_result_dtor(&result);
+            return compile_buffer(src.c_str(), src.length(), NULL, &result);
+        }
+
+        int compile(std::string src, opt_level_t level) {
+            compile_opts_t opts;
+            compile_opts_init(&opts);
+            opts.opt_level = level;
+
+            compile_result_dtor(&result);
+            return compile_buffer(src.c_str(), src.length(), &opts, &result);
+        }
+
+        std::string code() {
+            return std::string(result.code, result.code_len);
+        }
+
+        std::string diag() {
+            return std::string(result.diag, result.diag_len);
+        }
+};
+
+
+TEST_F(test_fixture, simple_program) {
+    std::string src = 
+    "require \"ifj21\"\n"
+    "function main()\n"
+    "   write(\"Hello\")\n"
+    "end\n"
+    "main()\n";
+
+    ASSERT_EQ(compile(src), PARSE_SUCCESS);
+    EXPECT_NE(code().find(".IFJcode21"), std::string::npos);
+    EXPECT_NE(code().find("main"), std::string::npos);
+    EXPECT_EQ(diag(), "");
+}
+
+
+TEST_F(test_fixture, errors_are_captured) {
+    std::string src = 
+    "require \"ifj21\"\n"
+    "function main()\n"
+    "   local a : integer = \n"
+    "end\n";
+
+    ASSERT_EQ(compile(src), SYNTAX_ERROR);
+    EXPECT_EQ(code(), "");
+    EXPECT_NE(diag().find("Syntax error"), std::string::npos);
+}
+
+
+TEST_F(test_fixture, more_compilations) {
+    std::string ok = 
+    "require \"ifj21\"\n"
+    "global f : function(integer) : integer\n"
+    "function f(a : integer) : integer\n"
+    "   return a * 2\n"
+    "end\n"
+    "write(f(21))\n";
+
+    std::string bad = 
+    "require \"ifj21\"\n"
+    "local_var = 1\n";
+
+    //Compilations must not influence each other
+    ASSERT_EQ(compile(ok), PARSE_SUCCESS);
+    std::string first = code();
+
+    ASSERT_NE(compile(bad), PARSE_SUCCESS);
+    EXPECT_NE(diag(), "");
+    EXPECT_EQ(code(), "");
+
+    ASSERT_EQ(compile(ok), PARSE_SUCCESS);
+    EXPECT_EQ(code(), first);
+    EXPECT_EQ(diag(), "");
+}
+
+
+TEST_F(test_fixture, arena) {
+    std::vector<std::string> sources = {
+        "require \"ifj21\"\n"
+        "function f(s : string, n : integer) : string\n"
+        "   local r : string = \"\"\n"
+        "   while n > 0 do\n"
+        "       r = r .. s\n"
+        "       n = n - 1\n"
+        "   end\n"
+        "   return r\n"
+        "end\n"
+        "write(f(\"long string, that is not short\", 100), #\"abc\")\n",
+        "require \"ifj21\"\nfunction main()\n local a : integer = b\nend\n",
+        "",
+    };
+
+    compile_opts_t opts;
+    compile_opts_init(&opts);
+    opts.memory = MEM_ARENA;
+    for(std::string &src : sources) { //Arena must not change result of compilation
+        int expected = compile(src);
+        std::string expected_code = code(), expected_diag = diag();
+
+        compile_result_t arena_result;
+        EXPECT_EQ(compile_buffer(src.c_str(), src.length(), &opts, &arena_result), expected);
+        EXPECT_EQ(std::string(arena_result.code, arena_result.code_len), expected_code);
+        EXPECT_EQ(std::string(arena_result.diag, arena_result.diag_len), expected_diag);
+        EXPECT_FALSE(arena_active()); //Arena is unset after compilation
+        compile_result_dtor(&arena_result);
+    }
+
+    arena_t arena;
+    arena_init(&arena);
+    arena_use(&arena);
+    char *first = (char *)mem_alloc(10);
+    char *last = (char *)mem_alloc(10);
+    strcpy(last, "123456789");
+    EXPECT_EQ(mem_realloc(last, 1000), last); //The last allocation grows in place
+    EXPECT_STREQ(last, "123456789");
+
+    char *moved = (char *)mem_realloc(first, 1000);
+    EXPECT_NE(moved, first);
+    mem_free(moved); //The last allocation is returned to arena
+    EXPECT_EQ(mem_alloc(1000), moved);
+
+    char *big = (char *)mem_alloc(2 * ARENA_BLOCK_SIZE);
+    ASSERT_NE(big, (char *)NULL);
+    memset(big, 'a', 2 * ARENA_BLOCK_SIZE);
+    EXPECT_EQ(arena_use(NULL), &arena);
+    arena_release(&arena);
+    EXPECT_EQ(arena.blocks, (arena_block_t *)NULL);
+}
+
+
+TEST_F(test_fixture, parallel_codegen) {
+    std::string src = "require \"ifj21\"\n";
+    for(int i = 0; i < 20; i++) {
+        std::string n = std::to_string(i);
+        src += "function f" + n + "(a : integer) : integer, number\n"
+               "   local r : integer = a\n"
+               "   while r < " + n + " do\n"
+               "       local t : number = r * 1.5\n"
+               "       r = r + 1\n"
+               "   end\n"
+               "   return r\n"
+               "end\n"
+               "write(f" + n + "(" + n + "))\n";
+    }
+
+    ASSERT_EQ(compile(src), PARSE_SUCCESS);
+    std::string expected_code = code(), expected_diag = diag();
+
+    compile_opts_t opts;
+    compile_opts_init(&opts);
+    opts.codegen_workers = 4;
+    for(mem_mode_t memory : {MEM_HEAP, MEM_ARENA}) { //Functions must be in source order
+        opts.memory = memory;
+
+        compile_result_t parallel_result;
+        EXPECT_EQ(compile_buffer(src.c_str(), src.length(), &opts, &parallel_result), PARSE_SUCCESS);
+        EXPECT_EQ(std::string(parallel_result.code, parallel_result.code_len), expected_code);
+        EXPECT_EQ(std::string(parallel_result.diag, parallel_result.diag_len), expected_diag);
+        compile_result_dtor(&parallel_result);
+    }
+}
+
+
+TEST_F(test_fixture, optimizations) {
+    std::string src =
+    "require \"ifj21\"\n"
+    "function main(a : integer)\n"
+    "   local unused : integer = a\n"
+    "   local x : integer = 2 * 3 + 1\n"
+    "   local y : integer = x\n"
+    "   if y > 5 then\n"
+    "       write(y, #\"abc\")\n"
+    "   else\n"
+    "       write(\"never\")\n"
+    "   end\n"
+    "end\n"
+    "main(1)\n";
+
+    ASSERT_EQ(compile(src, OPT_NONE), PARSE_SUCCESS);
+    std::string unoptimized = code();
+    EXPECT_NE(unoptimized.find("MULS"), std::string::npos);
+
+    ASSERT_EQ(compile(src, OPT_BASIC), PARSE_SUCCESS);
+    EXPECT_LT(code().length(), unoptimized.length());
+
+    //Constants are folded and propagated, so condition, dead variables and the other branch are removed
+    size_t body = code().find("LABEL $FUN$main");
+    ASSERT_NE(body, std::string::npos);
+    EXPECT_EQ(code().find("MULS", body), std::string::npos);
+    EXPECT_EQ(code().find("unused", body), std::string::npos);
+    EXPECT_EQ(code().find("never", body), std::string::npos);
+    EXPECT_NE(code().find("PUSHS int@7", body), std::string::npos);
+    EXPECT_NE(code().find("PUSHS int@3", body), std::string::npos);
+
+    //Result of compilation depends on level of optimizations
+    compile_opts_t opts;
+    compile_opts_init(&opts);
+    uint64_t key = cache_key(src.c_str(), src.length(), &opts);
+    opts.opt_level = OPT_BASIC;
+    EXPECT_NE(cache_key(src.c_str(), src.length(), &opts), key);
+}
+
+
+TEST_F(test_fixture, value_numbering) {
+    std::string src =
+    "require \"ifj21\"\n"
+    "function f(a : integer, b : integer) : integer\n"
+    "   local x : integer = a * b\n"
+    "   local y : integer = a * b\n"
+    "   a = 1\n"
+    "   local z : integer = a * b\n"
+    "   return x + y + z\n"
+    "end\n"
+    "write(f(2, 3))\n";
+
+    ASSERT_EQ(compile(src, OPT_BASIC), PARSE_SUCCESS);
+    std::string basic = code();
+
+    //The second product is taken from x, the third one has different operand
+    ASSERT_EQ(compile(src, OPT_FULL), PARSE_SUCCESS);
+    size_t body = code().find("LABEL $FUN$f");
+    ASSERT_NE(body, std::string::npos);
+    EXPECT_LT(code().length(), basic.length());
+    EXPECT_EQ(code().find("f$y$", body), std::string::npos);
+    EXPECT_NE(code().find("MULS", code().find("MULS", body) + 1), std::string::npos);
+}
+
+
+TEST_F(test_fixture, loop_invariants) {
+    std::string src =
+    "require \"ifj21\"\n"
+    "function f(s : string, n : integer) : integer\n"
+    "   local i : integer = 0\n"
+    "   local k : integer = n * 2\n"
+    "   while i < #s do\n"
+    "       i = i + k * 3\n"
+    "       write(10 // n)\n"
+    "   end\n"
+    "   return i\n"
+    "end\n"
+    "write(f(\"abc\", 1))\n";
+
+    //Length of string and product of invariant variable are computed before the loop, division can fail, so it stays
+    ASSERT_EQ(compile(src, OPT_FULL), PARSE_SUCCESS);
+    size_t loop = code().find("LABEL $WHILE$COND$f$0");
+    ASSERT_NE(loop, std::string::npos);
+    EXPECT_LT(code().find("STRLEN"), loop);
+    EXPECT_NE(code().find("PUSHS TF@&VAR&f$$0", loop), std::string::npos);
+    EXPECT_NE(code().find("PUSHS int@3", code().find("LABEL $FUN$f")), std::string::npos);
+    EXPECT_EQ(code().find("PUSHS int@3", loop), std::string::npos);
+    EXPECT_NE(code().find("IDIVS", loop), std::string::npos);
+
+    //Nodes created by workers are valid until the whole tree is released
+    compile_opts_t opts;
+    compile_opts_init(&opts);
+    opts.opt_level = OPT_FULL;
+    opts.codegen_workers = 4;
+    compile_result_t parallel_result;
+    EXPECT_EQ(compile_buffer(src.c_str(), src.length(), &opts, &parallel_result), PARSE_SUCCESS);
+    EXPECT_EQ(std::string(parallel_result.code, parallel_result.code_len), code());
+    compile_result_dtor(&parallel_result);
+}
+
+
+TEST_F(test_fixture, condition_jumps) {
+    std::string src =
+    "require \"ifj21\"\n"
+    "function f(a : integer, s : string)\n"
+    "   if a == 1 then write(1) end\n"
+    "   while a ~= 3 do a = a + 1 end\n"
+    "   if a < 5 then write(2) end\n"
+    "   if s then write(3) end\n"
+    "end\n"
+    "f(0, nil)\n";
+
+    ASSERT_EQ(compile(src), PARSE_SUCCESS);
+    size_t body = code().find("LABEL $FUN$f");
+    ASSERT_NE(body, std::string::npos);
+
+    //Comparisons are fused with jumps, bool values are not converted
+    EXPECT_NE(code().find("JUMPIFNEQS $ELSE$START$f$0", body), std::string::npos);
+    EXPECT_NE(code().find("JUMPIFEQS $WHILE$END$f$0", body), std::string::npos);
+    EXPECT_EQ(code().find("EQS\n", body), std::string::npos);
+
+    //Only the string must be converted to bool
+    size_t tobool = code().find("CALL $FUN$$BUILTIN$tobool", body);
+    ASSERT_NE(tobool, std::string::npos);
+    EXPECT_GT(tobool, code().find("#if 2", body));
+    EXPECT_EQ(code().find("CALL $FUN$$BUILTIN$tobool", tobool + 1), std::string::npos);
+}
+
+
+TEST_F(test_fixture, empty_input) {
+    ASSERT_EQ(compile(""), SYNTAX_ERROR);
+    EXPECT_EQ(code(), "");
+}
+
+
+TEST_F(test_fixture, nested_loop_declarations) {
+    std::string src =
+    "require \"ifj21\"\n"
+    "function main()\n"
+    "   local i : integer = 0\n"
+    "   while i < 2 do\n"
+    "       local j : integer = 0\n"
+    "       while j < 2 do\n"
+    "           local k : integer = j\n"
+    "           j = j + 1\n"
+    "       end\n"
+    "       local after : integer = i\n"
+    "       i = i + 1\n"
+    "   end\n"
+    "end\n"
+    "main()\n";
+
+    ASSERT_EQ(compile(src), PARSE_SUCCESS);
+
+    //All variables of loop (even the one after the nested loop) are declared before the outer loop
+    size_t loop_start = code().find("LABEL $WHILE$COND$main$0");
+    ASSERT_NE(loop_start, std::string::npos);
+    EXPECT_LT(code().find("DEFVAR TF@&VAR&main$k$2"), loop_start);
+    EXPECT_LT(code().find("DEFVAR TF@&VAR&main$after$3"), loop_start);
+    EXPECT_EQ(code().find("DEFVAR TF@&VAR&main$after$3", loop_start), std::string::npos);
+}
+
+
+TEST_F(test_fixture, output_names) {
+    char *name = get_output_name("dir/prog.tl");
+    EXPECT_STREQ(name, "dir/prog.code");
+    free(name);
+
+    name = get_output_name("prog");
+    EXPECT_STREQ(name, "prog.code");
+    free(name);
+}
+
+
+TEST_F(test_fixture, batch) {
+    std::vector<std::string> sources = {
+        "require \"ifj21\"\nfunction main()\n write(1)\nend\nmain()\n",
+        "require \"ifj21\"\nfunction main()\n local a : integer = b\nend\n",
+        "require \"ifj21\"\nfunction main()\n local a : integer = 1 + \"s\"\nend\n",
+        "require \"ifj21\"\nfunction f() : string\n return \"f\"\nend\nwrite(f())\n",
+    };
+
+    std::vector<std::string> names;
+    std::vector<char *> paths;
+    for(size_t i = 0; i < sources.size(); i++) {
+        names.push_back("tmp_batch" + std::to_string(i) + ".tl");
+    }
+
+    for(size_t i = 0; i < sources.size(); i++) {
+        FILE *f = fopen(names[i].c_str(), "w");
+        ASSERT_NE(f, nullptr);
+        fputs(sources[i].c_str(), f);
+        fclose(f);
+
+        paths.push_back(&names[i][0]);
+    }
+
+    batch_stats_t stats;
+    int ret = batch_compile(paths.data(), paths.size(), 2, NULL, NULL, &stats);
+    EXPECT_EQ(ret, SEMANTIC_ERROR_DEFINITION);
+    EXPECT_EQ(stats.file_num, sources.size());
+    EXPECT_EQ(stats.failed_num, 2u);
+
+    //Batch must produce same code as compilation of single buffer
+    for(size_t i = 0; i < sources.size(); i++) {
+        char *out_name = get_output_name(paths[i]);
+        FILE *f = fopen(out_name, "r");
+
+        int expected = compile(sources[i]);
+        if(expected == PARSE_SUCCESS) {
+            ASSERT_NE(f, nullptr);
+
+            char *got = NULL;
+            size_t got_len = 0;
+            ASSERT_EQ(read_stream(f, &got, &got_len), EXIT_SUCCESS);
+            EXPECT_EQ(std::string(got, got_len), code());
+
+            free(got);
+            fclose(f);
+        }
+        else {
+            EXPECT_EQ(f, nullptr);
+        }
+
+        remove(out_name);
+        remove(paths[i]);
+        free(out_name);
+    }
+}
+
+
+class token_stream : public test_fixture {
+    protected:
+        std::string path;
+        compile_opts_t opts;
+
+        virtual void SetUp() override {
+            test_fixture::SetUp();
+
+            char path_template[] = "/tmp/ifj21_tokensXXXXXX";
+            int fd = mkstemp(path_template);
+            ASSERT_NE(fd, -1);
+            close(fd);
+            path = path_template;
+
+            compile_opts_init(&opts);
+        }
+
+        virtual void TearDown() override {
+            test_fixture::TearDown();
+            remove(path.c_str());
+        }
+
+        int compile_tokens(std::string src) {
+            compile_result_dtor(&result);
+            return compile_buffer(src.c_str(), src.length(), &opts, &result);
+        }
+
+        long file_size() {
+            FILE *f = fopen(path.c_str(), "rb");
+            fseek(f, 0, SEEK_END);
+            long size = ftell(f);
+            fclose(f);
+
+            return size;
+        }
+};
+
+
+TEST_F(token_stream, dump_and_load) {
+    std::string src = 
+    "require \"ifj21\"\n"
+    "function main()\n"
+    "   local s : string = \"a b\" .. \"c\"\n"
+    "   local n : number = 1.5e3 + 2\n"
+    "   write(s, n, #s)\n"
+    "end\n"
+    "main()\n";
+
+    ASSERT_EQ(compile(src), PARSE_SUCCESS);
+    std::string expected = code();
+
+    opts.dump_tokens = path.c_str();
+    ASSERT_EQ(compile_tokens(src), PARSE_SUCCESS);
+    EXPECT_EQ(code(), expected);
+
+    //Source is not scanned
+    compile_opts_init(&opts);
+    opts.load_tokens = path.c_str();
+    ASSERT_EQ(compile_tokens(src), PARSE_SUCCESS);
+    EXPECT_EQ(code(), expected);
+    EXPECT_EQ(diag(), "");
+
+    //Stream of changed source is stale, so source must be scanned
+    std::string changed = src;
+    changed.replace(changed.find("1.5e3"), 5, "2.5e3");
+    ASSERT_EQ(compile_tokens(changed), PARSE_SUCCESS);
+    EXPECT_NE(diag().find("stale"), std::string::npos);
+    EXPECT_NE(code(), expected);
+
+    //Invalid stream
+    FILE *f = fopen(path.c_str(), "r+b");
+    ASSERT_NE(f, nullptr);
+    fputs("IFJ21XXX", f);
+    fclose(f);
+
+    ASSERT_EQ(compile_tokens(src), PARSE_SUCCESS);
+    EXPECT_NE(diag().find("not valid"), std::string::npos);
+    EXPECT_EQ(code(), expected);
+}
+
+
+TEST_F(token_stream, interned_identifiers) {
+    //Identifiers with indices longer than one byte, each of them is used more times
+    std::string src = "require \"ifj21\"\nfunction main()\n";
+    for(int i = 0; i < 300; i++) {
+        std::string name = "variable_with_long_name_" + std::to_string(i);
+        src += " local " + name + " : integer = " + std::to_string(i) + "\n";
+        src += " " + name + " = " + name + " + " + std::to_string(i % 7) + "\n";
+    }
+
+    src += " write(variable_with_long_name_0, variable_with_long_name_299)\nend\nmain()\n";
+
+    ASSERT_EQ(compile(src), PARSE_SUCCESS);
+    std::string expected = code();
+
+    opts.dump_tokens = path.c_str();
+    ASSERT_EQ(compile_tokens(src), PARSE_SUCCESS);
+    EXPECT_LT((size_t)file_size(), src.length());
+
+    compile_opts_init(&opts);
+    opts.load_tokens = path.c_str();
+    ASSERT_EQ(compile_tokens(src), PARSE_SUCCESS);
+    EXPECT_EQ(code(), expected);
+    EXPECT_EQ(diag(), "");
+}
+
+
+TEST_F(token_stream, lexical_error) {
+    std::string src = "require \"ifj21\"\nfunction main()\n local a : integer = 1 $ 2\nend\n";
+    ASSERT_EQ(compile(src), LEXICAL_ERROR);
+    std::string expected = diag();
+
+    opts.dump_tokens = path.c_str();
+    ASSERT_EQ(compile_tokens(src), LEXICAL_ERROR);
+
+    //Lexical error is reported only once, stream is not dumped
+    EXPECT_NE(diag().find(expected), std::string::npos);
+    EXPECT_NE(diag().find("was not dumped"), std::string::npos);
+    EXPECT_EQ(file_size(), 0);
+}
+
+
+class cache : public test_fixture {
+    protected:
+        std::string dir;
+        compile_opts_t opts;
+
+        virtual void SetUp() override {
+            test_fixture::SetUp();
+
+            char dir_template[] = "tmp_cacheXXXXXX";
+            ASSERT_NE(mkdtemp(dir_template), nullptr);
+            dir = dir_template;
+
+            compile_opts_init(&opts);
+            opts.cache_dir = dir.c_str();
+        }
+
+        virtual void TearDown() override {
+            test_fixture::TearDown();
+            system(("rm -rf " + dir).c_str());
+        }
+
+        int compile_cached(std::string src) {
+            compile_result_dtor(&result);
+            return compile_buffer(src.c_str(), src.length(), &opts, &result);
+        }
+
+        size_t entry_num() {
+            size_t num = 0;
+            DIR *d = opendir(dir.c_str());
+            struct dirent *de;
+            while((de = readdir(d)) != NULL) {
+                num += de->d_name[0] != '.';
+            }
+
+            closedir(d);
+
+            return num;
+        }
+
+        std::string program(int i) {
+            return "require \"ifj21\"\nfunction main()\n write(" + std::to_string(i) + ")\nend\nmain()\n";
+        }
+};
+
+
+TEST_F(cache, hit_and_miss) {
+    std::string src = program(1);
+    ASSERT_EQ(compile(src), PARSE_SUCCESS);
+    std::string expected = code();
+
+    ASSERT_EQ(compile_cached(src), PARSE_SUCCESS);
+    EXPECT_FALSE(result.cache_hit);
+    EXPECT_EQ(code(), expected);
+
+    ASSERT_EQ(compile_cached(src), PARSE_SUCCESS);
+    EXPECT_TRUE(result.cache_hit);
+    EXPECT_EQ(code(), expected);
+
+    ASSERT_EQ(compile_cached(program(2)), PARSE_SUCCESS); //Different source
+    EXPECT_FALSE(result.cache_hit);
+    EXPECT_EQ(entry_num(), 2u);
+}
+
+
+TEST_F(cache, collisions) {
+    std::string src = program(1), other = program(2);
+    ASSERT_EQ(compile_cached(src), PARSE_SUCCESS);
+
+    //Entry of src is put under key of other source (as if their keys collided)
+    uint64_t other_key = cache_key(other.c_str(), other.length(), &opts);
+    char name[64];
+    snprintf(name, sizeof(name), "/%016llx" CACHE_EXTENSION, (unsigned long long)cache_key(src.c_str(), src.length(), &opts));
+    std::string src_entry = dir + name;
+    snprintf(name, sizeof(name), "/%016llx" CACHE_EXTENSION, (unsigned long long)other_key);
+    ASSERT_EQ(rename(src_entry.c_str(), (dir + name).c_str()), 0);
+
+    FILE *f = fopen((dir + name).c_str(), "r+b"); //Key is right after magic
+    ASSERT_NE(f, nullptr);
+    fseek(f, sizeof(CACHE_MAGIC) - 1, SEEK_SET);
+    fwrite(&other_key, sizeof(other_key), 1, f);
+    fclose(f);
+
+    ASSERT_EQ(compile_cached(other), PARSE_SUCCESS);
+    EXPECT_FALSE(result.cache_hit);
+    EXPECT_NE(code().find("int@2"), std::string::npos);
+}
+
+
+TEST_F(cache, errors) {
+    std::string src = "require \"ifj21\"\nfunction main()\n local a : integer = b\nend\n";
+    int expected = compile(src);
+    std::string expected_diag = diag();
+
+    ASSERT_EQ(compile_cached(src), expected);
+    ASSERT_EQ(compile_cached(src), expected);
+    EXPECT_TRUE(result.cache_hit);
+    EXPECT_EQ(code(), "");
+    EXPECT_EQ(diag(), expected_diag);
+}
+
+
+TEST_F(cache, eviction) {
+    ASSERT_EQ(compile_cached(program(0)), PARSE_SUCCESS);
+    size_t entry_size = result.code_len;
+
+    //There is space only for three entries
+    opts.cache_max_size = entry_size * 3 + 3 * 128;
+    for(int i = 1; i < 10; i++) {
+        ASSERT_EQ(compile_cached(program(i)), PARSE_SUCCESS);
+        EXPECT_LE(entry_num(), 3u);
+
+        //Entry of program(1) is used by every iteration, so it should not be evicted
+        ASSERT_EQ(compile_cached(program(1)), PARSE_SUCCESS);
+        EXPECT_TRUE(result.cache_hit);
+    }
+
+    ASSERT_EQ(compile_cached(program(0)), PARSE_SUCCESS);
+    EXPECT_FALSE(result.cache_hit);
+}
+
+
+TEST_F(cache, batch) {
+    std::vector<std::string> names = {"tmp_cached0.tl", "tmp_cached1.tl"};
+    std::vector<char *> paths;
+    for(size_t i = 0; i < names.size(); i++) {
+        FILE *f = fopen(names[i].c_str(), "w");
+        ASSERT_NE(f, nullptr);
+        fputs(program(i).c_str(), f);
+        fclose(f);
+
+        paths.push_back(&names[i][0]);
+    }
+
+    batch_stats_t stats;
+    ASSERT_EQ(batch_compile(paths.data(), paths.size(), 2, &opts, NULL, &stats), EXIT_SUCCESS);
+    EXPECT_EQ(stats.cache_hits, 0u);
+    EXPECT_EQ(stats.cache_misses, 2u);
+
+    ASSERT_EQ(batch_compile(paths.data(), paths.size(), 2, &opts, NULL, &stats), EXIT_SUCCESS);
+    EXPECT_EQ(stats.cache_hits, 2u);
+    EXPECT_EQ(stats.cache_misses, 0u);
+
+    for(size_t i = 0; i < names.size(); i++) {
+        char *out_name = get_output_name(paths[i]);
+        remove(out_name);
+        remove(paths[i]);
+        free(out_name);
+    }
+}
+
+
+class incremental : public test_fixture {
+    protected:
+        compile_opts_t opts;
+
+        virtual void SetUp() override {
+            test_fixture::SetUp();
+
+            compile_opts_init(&opts);
+            opts.incremental = "tmp_incremental.inc";
+            remove(opts.incremental);
+        }
+
+        virtual void TearDown() override {
+            test_fixture::TearDown();
+            remove(opts.incremental);
+        }
+
+        int compile_incremental(std::string src) {
+            compile_result_dtor(&result);
+            return compile_buffer(src.c_str(), src.length(), &opts, &result);
+        }
+
+        std::string program(std::string g_sig, std::string f_body) {
+            return "require \"ifj21\"\n"
+                   "function g(" + g_sig + ") : integer\n"
+                   "    return 1\n"
+                   "end\n"
+                   "function f()\n"
+                   "    local a : integer = g(1)\n" + f_body +
+                   "end\n"
+                   "function h(n : integer)\n"
+                   "    while n > 0 do\n"
+                   "        if n > 2 then write(n) else write(0) end\n"
+                   "        n = n - 1\n"
+                   "    end\n"
+                   "end\n"
+                   "f()\n"
+                   "h(3)\n";
+        }
+
+        //Checks, that incremental compilation gives the same result as compilation from scratch
+        void check_same(std::string src, size_t reused) {
+            ASSERT_EQ(compile(src), PARSE_SUCCESS);
+            std::string expected = code();
+
+            ASSERT_EQ(compile_incremental(src), PARSE_SUCCESS);
+            EXPECT_EQ(result.reused_funcs, reused);
+            EXPECT_EQ(code(), expected);
+        }
+};
+
+
+TEST_F(incremental, unchanged) {
+    check_same(program("x : integer", "    write(a)\n"), 0);
+    check_same(program("x : integer", "    write(a)\n"), 3);
+}
+
+
+TEST_F(incremental, changed_body) {
+    check_same(program("x : integer", "    write(a)\n"), 0);
+    check_same(program("x : integer", "    if a > 0 then write(a) end\n"), 2);
+    check_same(program("x : integer", "    if a > 0 then write(a) end\n"), 3);
+}
+
+
+TEST_F(incremental, changed_callee_signature) {
+    check_same(program("x : integer", "    write(a)\n"), 0);
+    check_same(program("x : number", "    write(a)\n"), 1); //Caller f must be compiled again
+}
+
+
+TEST_F(incremental, warnings) {
+    std::string src = 
+    "require \"ifj21\"\n"
+    "function f()\n"
+    "    local a : integer\n"
+    "    write(a + 1)\n"
+    "end\n"
+    "f()\n";
+
+    ASSERT_EQ(compile(src), PARSE_SUCCESS);
+    std::string expected_diag = diag();
+    ASSERT_NE(expected_diag, "");
+
+    ASSERT_EQ(compile_incremental(src), PARSE_SUCCESS);
+    ASSERT_EQ(compile_incremental(src), PARSE_SUCCESS);
+    EXPECT_EQ(result.reused_funcs, 0u); //Function with warning is not stored
+    EXPECT_EQ(diag(), expected_diag);
+}
+
+
+TEST_F(incremental, invalid_sidecar) {
+    FILE *f = fopen(opts.incremental, "w");
+    ASSERT_NE(f, nullptr);
+    fputs("IFJ21FN2 but not valid", f);
+    fclose(f);
+
+    check_same(program("x : integer", "    write(a)\n"), 0);
+    check_same(program("x : integer", "    write(a)\n"), 3);
+}
+
+
+TEST_F(incremental, colliding_keys) {
+    check_same(program("x : integer", "    write(a)\n"), 0);
+
+    //Second hash of the first entry does not match (as if key of other function collided with it)
+    FILE *f = fopen(opts.incremental, "r+b");
+    ASSERT_NE(f, nullptr);
+    uint64_t check = 0;
+    fseek(f, 3 * sizeof(uint64_t) + sizeof(uint64_t), SEEK_SET); //Magic, version, number of entries and key
+    fwrite(&check, sizeof(check), 1, f);
+    fclose(f);
+
+    check_same(program("x : integer", "    write(a)\n"), 2);
+}
+
+
+TEST_F(incremental, errors_keep_sidecar) {
+    check_same(program("x : integer", "    write(a)\n"), 0);
+    EXPECT_NE(compile_incremental(program("x : integer", "    write(b)\n")), PARSE_SUCCESS);
+    check_same(program("x : integer", "    write(a)\n"), 3);
+}
+
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
+
+
+/***                        End of compiler_tests.cpp                      ***/
@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <string.h>
+#include "arena.h"
 
 
 #define INIT_SIZE 16 /**< Initial size of stack (after initialization)*/
@@ -106,9 +107,36 @@ unsigned int NAME##_get_top_ind(NAME##_stack_t *s);         \
 void NAME##_show(NAME##_stack_t *s);                        \
                                                             \
 /**                                                         \
- * @brief Rotates with stack to revert order of elements in stack\
+ * @brief Reverts order of elements in stack (in place, without allocation)\
  */                                                         \
 bool NAME##_revert(NAME##_stack_t *s);                      \
+                                                            \
+/**                                                         \
+ * @brief Ensures, that stack has space for at least capacity elements\
+ */                                                         \
+bool NAME##_reserve(NAME##_stack_t *s, size_t capacity);    \
+                                                            \
+/**                                                         \
+ * @brief Frees allocated space, that is not used by elements\
+ */                                                         \
+bool NAME##_shrink(NAME##_stack_t *s);                      \
+                                                            \
+/**                                                         \
+ * @brief Removes all elements from stack (allocated space is kept for next usage)\
+ */                                                         \
+void NAME##_clear(NAME##_stack_t *s);                       \
+                                                            \
+/**                                                         \
+ * @brief Pushes n elements from array to the stack (the last element of array will be on the top)\
+ */                                                         \
+bool NAME##_push_n(NAME##_stack_t *s, TYPE *src, size_t n); \
+                                                            \
+/**                                                         \
+ * @brief Pops n elements from the stack to array (they are in same order as they were in stack)\
+ * @note If dst is NULL, elements are only removed           \
+ * @warning You should check if there are at least n elements in stack\
+ */                                                         \
+void NAME##_pop_n(NAME##_stack_t *s, TYPE *dst, size_t n);  \
 
 
 
@@ -122,7 +150,7 @@ bool NAME##_revert(NAME##_stack_t *s);                      \
 #define DSTACK(TYPE, NAME, PRINT_CMD)                           \
 bool NAME##_stack_init(NAME##_stack_t *s) {                     \
     s->top = 0;                                                 \
-    s->data = (TYPE *)malloc(sizeof(TYPE)*INIT_SIZE);           \
+    s->data = (TYPE *)mem_alloc(sizeof(TYPE)*INIT_SIZE);        \
     if(!s->data) {                                              \
         fprintf(stderr, "Stack: Can't allocate!\n");            \
         return false;                                           \
@@ -134,7 +162,7 @@ bool NAME##_stack_init(NAME##_stack_t *s) {                     \
                                                                 \
 bool NAME##_stack_init_to(NAME##_stack_t *s, size_t cap) {      \
     s->top = 0;                                                 \
-    s->data = (TYPE *)malloc(sizeof(TYPE)*cap);                 \
+    s->data = (TYPE *)mem_alloc(sizeof(TYPE)*cap);              \
     if(!s->data) {                                              \
         fprintf(stderr, "Stack: Can't allocate!\n");            \
         return false;                                           \
@@ -145,7 +173,7 @@ bool NAME##_stack_init_to(NAME##_stack_t *s, size_t cap) {      \
 }                                                               \
                                                                 \
 void NAME##_stack_dtor(NAME##_stack_t *s) {                     \
-    free(s->data);                                              \
+    mem_free(s->data);                                          \
     s->allocated = 0;                                           \
 }                                               \
                                                 \
@@ -155,7 +183,7 @@ bool NAME##_is_empty(NAME##_stack_t *s) {       \
                                                 \
 bool NAME##_push(NAME##_stack_t *s, TYPE  newdata) {                                \
     if(s->top == s->allocated) { /*Allocated memory is full -> extend it*/          \
-        s->data = (TYPE *)realloc(s->data, sizeof(TYPE)*s->allocated*2);            \
+        s->data = (TYPE *)mem_realloc(s->data, sizeof(TYPE)*s->allocated*2);        \
         if(!s->data) {                                                              \
             fprintf(stderr, "Stack: Can't allocate!\n");                            \
             return false;                                                           \
@@ -203,27 +231,76 @@ void NAME##_show(NAME##_stack_t *s) {           \
 }                                               \
                                                 \
 bool NAME##_revert(NAME##_stack_t *s) {         \
-    NAME##_stack_t tmp;                         \
-    if(!NAME##_stack_init_to(&tmp, s->allocated)) {\
-        return false;                           \
-    }                                           \
-                                                \
-                                                \
-    TYPE tmp_el;                                \
-    while(!NAME##_is_empty(s)) {                \
-        tmp_el = NAME##_pop(s);                 \
-        NAME##_push(&tmp, tmp_el);              \
-    }                                           \
-                                                \
-    s->data = memmove(s->data, tmp.data, s->allocated*sizeof(TYPE));\
-    s->top = tmp.top;                           \
-                                                \
-                                                \
-    NAME##_stack_dtor(&tmp);                    \
-                                                \
-    return true;                                \
-}                                               \
-                                                \
+    for(unsigned int i = 0; i < s->top / 2; i++) {  \
+        TYPE tmp_el = s->data[i];                   \
+        s->data[i] = s->data[s->top - 1 - i];       \
+        s->data[s->top - 1 - i] = tmp_el;           \
+    }                                               \
+                                                    \
+    return true;                                    \
+}                                                   \
+                                                    \
+bool NAME##_reserve(NAME##_stack_t *s, size_t capacity) {           \
+    if(capacity <= s->allocated) {                                  \
+        return true;                                                \
+    }                                                               \
+                                                                    \
+    TYPE *extended = (TYPE *)mem_realloc(s->data, sizeof(TYPE)*capacity);\
+    if(!extended) {                                                 \
+        fprintf(stderr, "Stack: Can't allocate!\n");               \
+        return false;                                               \
+    }                                                               \
+                                                                    \
+    s->data = extended;                                             \
+    s->allocated = capacity;                                        \
+                                                                    \
+    return true;                                                    \
+}                                                                   \
+                                                                    \
+bool NAME##_shrink(NAME##_stack_t *s) {                             \
+    size_t capacity = s->top > 0 ? s->top : 1;                      \
+    TYPE *shrinked = (TYPE *)mem_realloc(s->data, sizeof(TYPE)*capacity);\
+    if(!shrinked) {                                                 \
+        return false;                                               \
+    }                                                               \
+                                                                    \
+    s->data = shrinked;                                             \
+    s->allocated = capacity;                                        \
+                                                                    \
+    return true;                                                    \
+}                                                                   \
+                                                                    \
+void NAME##_clear(NAME##_stack_t *s) {                              \
+    s->top = 0;                                                     \
+}                                                                   \
+                                                                    \
+bool NAME##_push_n(NAME##_stack_t *s, TYPE *src, size_t n) {        \
+    if(n == 0) {                                                    \
+        return true;                                                \
+    }                                                               \
+                                                                    \
+    size_t capacity = s->allocated > 0 ? s->allocated : INIT_SIZE;  \
+    while(capacity < s->top + n) { /*Space is doubled as in push*/  \
+        capacity *= 2;                                              \
+    }                                                               \
+                                                                    \
+    if(!NAME##_reserve(s, capacity)) {                              \
+        return false;                                               \
+    }                                                               \
+                                                                    \
+    memcpy(&s->data[s->top], src, sizeof(TYPE)*n);                  \
+    s->top += n;                                                    \
+                                                                    \
+    return true;                                                    \
+}                                                                   \
+                                                                    \
+void NAME##_pop_n(NAME##_stack_t *s, TYPE *dst, size_t n) {         \
+    s->top -= n;                                                    \
+    if(dst) {                                                       \
+        memcpy(dst, &s->data[s->top], sizeof(TYPE)*n);             \
+    }                                                               \
+}                                                                   \
+                                                                    \
 
 
 
@@ -19,95 +19,169 @@
  */
 
 #include "dstring.h"
+#include "arena.h"
 
-int str_init(string_t *string) {
-    string->str = NULL;
-    string->str = (char *)malloc(sizeof(char)*STR_INIT_SPACE);
-    if(!string->str) {
-        fprintf(stderr, "dstring: str_init: Cannot allocate memory!\n");
+#ifdef DSTRING_STATS
+str_stats_t str_stats = {0, 0, 0};
+#define COUNT(counter) str_stats.counter++
+#else
+#define COUNT(counter)
+#endif
+
+//String is stored in buffer inside its structure
+#define IS_SHORT(string) ((string)->alloc_size == STR_INIT_SPACE)
+
+
+/**
+ * @brief Returns data of string (str of short string is not used, because structure could be copied or moved)
+ * @note Structure is never written, so strings (e.g. in global symbol table) can be read by more threads at once
+ */ 
+static char *str_data(const string_t *string) {
+    return IS_SHORT(string) ? (char *)string->small : string->str;
+}
+
+
+/**
+ * @brief Changes allocated size of string (short string is moved to dynamic array)
+ */ 
+static int str_resize(string_t *string, size_t new_size) {
+    if(new_size <= STR_INIT_SPACE) { //Dynamic arrays are always bigger than buffer for short string
+        new_size = STR_INIT_SPACE * 2;
+    }
+
+    char *resized = NULL;
+    if(string->alloc_size > STR_INIT_SPACE) {
+        resized = (char *)mem_realloc(string->str, sizeof(char)*new_size);
+        COUNT(reallocs);
+    }
+    else {
+        resized = (char *)mem_alloc(sizeof(char)*new_size);
+        if(resized && IS_SHORT(string)) {
+            memcpy(resized, str_data(string), STR_INIT_SPACE);
+        }
+        else if(resized) { //String was not owned
+            resized[0] = '\0';
+            if(string->str) {
+                memcpy(resized, string->str, string->length + 1);
+            }
+        }
+
+        COUNT(to_heap);
+    }
+
+    if(!resized) {
         return STR_FAILURE;
     }
 
+    string->str = resized;
+    string->alloc_size = new_size;
+
+    return STR_SUCCESS;
+}
+
+
+int str_init(string_t *string) {
+    string->str = string->small;
     string->alloc_size = STR_INIT_SPACE;
     string->str[0] = '\0';
     string->length = 0;
 
+    COUNT(inits);
+
     return STR_SUCCESS;
 }
 
 
+int str_init_cap(string_t *string, size_t capacity) {
+    str_init(string);
+
+    return str_reserve(string, capacity);
+}
+
+
 int extend_string(string_t *string) {
-    size_t new_size = string->alloc_size*2;
-    string->str = (char *)realloc(string->str, sizeof(char)*new_size);
-    if(!string->str) {
+    if(str_resize(string, string->alloc_size*2) != STR_SUCCESS) {
         fprintf(stderr, "dstring: str_init: Cannot extend string!\n");
         return STR_FAILURE;
     } 
 
-    string->alloc_size = new_size;
-
     return STR_SUCCESS;
 }
 
 
 int app_char(char c, string_t *string) {
     //There must be always place for '\0' character
-    if(string->alloc_size - 1 < string->length + 1) {
-        size_t new_size = string->alloc_size*2; //Double place for string
-        string->str = (char *)realloc(string->str, sizeof(char)*new_size);
-        if(!string->str) {
-            fprintf(stderr, "dstring: str_init: Cannot extend string!\n");
+    if(string->alloc_size < string->length + 2) {
+        if(extend_string(string) != STR_SUCCESS) { //Double place for string
             return STR_FAILURE;
-        } 
-
-        string->alloc_size = new_size;
+        }
     }
 
-    string->str[string->length++] = c;
-    string->str[string->length] = '\0';
+    char *data = str_data(string);
+    data[string->length++] = c;
+    data[string->length] = '\0';
     
     return STR_SUCCESS;
 }
 
 
 int app_str(string_t *dst, const char *src) {
-    for(int i = 0; i < strlen(src); i++) {
-        int ret = app_char(src[i], dst);
-        if(ret == STR_FAILURE) {
-            return STR_FAILURE;
-        }
+    size_t src_len = strlen(src);
+    if(str_grow(dst, dst->length + src_len) != STR_SUCCESS) {
+        return STR_FAILURE;
     }
 
+    memcpy(to_str(dst) + dst->length, src, src_len + 1);
+    dst->length += src_len;
+
     return STR_SUCCESS;
 }
 
 
+int str_reserve(string_t *string, size_t capacity) {
+    if(string->alloc_size >= capacity + 1) {
+        return STR_SUCCESS;
+    }
+
+    if(str_resize(string, capacity + 1) != STR_SUCCESS) {
+        fprintf(stderr, "dstring: str_reserve: Cannot extend string!\n");
+        return STR_FAILURE;
+    }
+
+    return STR_SUCCESS;
+}
+
+
+int str_grow(string_t *string, size_t capacity) {
+    if(string->alloc_size < capacity + 1 && string->alloc_size * 2 > capacity + 1) {
+        capacity = string->alloc_size * 2 - 1;
+    }
+
+    return str_reserve(string, capacity);
+}
+
+
 void cut_string(string_t *string, size_t new_length) {
     if(new_length >= string->length) {
         return;
     }
 
     string->length = new_length;
-    string->str[string->length] = '\0';
+    str_data(string)[string->length] = '\0';
 }
 
 
 int prep_char(char c, string_t *string) {
-    if(string->alloc_size - 1 < string->length + 1) {
-        size_t new_size = string->alloc_size*2; //Double place for string
-        string->str = (char *)realloc(string->str, sizeof(char)*new_size);
-        if(!string->str) {
-            fprintf(stderr, "dstring: str_init: Cannot extend string!\n");
+    if(string->alloc_size < string->length + 2) {
+        if(extend_string(string) != STR_SUCCESS) { //Double place for string
             return STR_FAILURE;
-        } 
-        string->alloc_size = new_size;
-    }
-
-    for(int i = strlen(string->str); i >= 0; i--) {
-        string->str[i + 1] = string->str[i];
+        }
     }
 
-    string->str[0] = c;
+    char *data = str_data(string);
+    memmove(&data[1], data, string->length + 1);
+    data[0] = c;
+    string->length++;
 
     return STR_SUCCESS;
 }
@@ -126,14 +200,14 @@ int prep_str(string_t *dst, const char *src) {
 
 
 void str_clear(string_t *string) {
-    string->str[0] = '\0';
+    str_data(string)[0] = '\0';
     string->length = 0;
 }
 
 
 void str_dtor(string_t *string) {
-    if(string->alloc_size > 0 && string->str != NULL) {
-        free(string->str);
+    if(string->alloc_size > STR_INIT_SPACE && string->str != NULL) { //Short strings and strings, that are not owned are not freed
+        mem_free(string->str);
     }
 
     string->str = NULL;
@@ -142,8 +216,8 @@ void str_dtor(string_t *string) {
 }
 
 
-char * to_str(string_t *string) {
-    return string->str;
+char * to_str(const string_t *string) {
+    return str_data(string);
 }
 
 
@@ -158,7 +232,7 @@ bool str_search(const char c, const char *str) {
 
 
 int str_cpy(char **dst, const char *src, size_t length) {
-    *dst = (char *)malloc(sizeof(char) * (length + 1)); //Length of source + \0
+    *dst = (char *)mem_alloc(sizeof(char) * (length + 1)); //Length of source + \0
     if(!(*dst)) {
         fprintf(stderr, "dstring: str_cpy: Cannot copy a string!\n");
         return STR_FAILURE;
@@ -174,27 +248,28 @@ int str_cpy(char **dst, const char *src, size_t length) {
 
 int str_cpy_tostring(string_t* dst, const char *src, size_t length) {
     str_clear(dst);
-    for(size_t i = 0; i < length; i++) {
-        if(app_char(src[i], dst) == STR_FAILURE) {
-            fprintf(stderr, "dstring: str_cpy: Cannot copy a string!\n");
-            return STR_FAILURE;
-        }
+    if(str_reserve(dst, length) != STR_SUCCESS) {
+        fprintf(stderr, "dstring: str_cpy: Cannot copy a string!\n");
+        return STR_FAILURE;
+    }
+
+    char *data = to_str(dst);
+    if(length > 0) {
+        memcpy(data, src, length);
     }
+
+    data[length] = '\0';
+    dst->length = length;
     
     return STR_SUCCESS;
 }
 
 
 int cpy_strings(string_t* dst, string_t *src, bool zero_term) {
-    str_clear(dst);
-    for(size_t i = 0; zero_term ? src->str[i] != '\0' : i < src->length; i++) {
-        if(app_char(src->str[i], dst) == STR_FAILURE) {
-            fprintf(stderr, "dstring: str_cpy: Cannot copy a string!\n");
-            return STR_FAILURE;
-        }
-    }
-    
-    return STR_SUCCESS;
+    const char *src_data = to_str(src);
+    size_t length = zero_term ? strlen(src_data) : src->length;
+
+    return str_cpy_tostring(dst, src_data, length);
 }
 
 
@@ -209,7 +284,7 @@ size_t len(string_t *str) {
 
 
 int dstring_cmp(string_t* str1, string_t* str2) {
-    return strcmp(str1->str, str2->str);
+    return strcmp(to_str(str1), to_str(str2));
 }
 
 
@@ -232,4 +307,26 @@ int get_chtype(const char c) {
 }
 
 
+uint64_t hash_bytes(const void *data, size_t length, uint64_t hash) {
+    const unsigned char *bytes = data;
+    for(size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull; //FNV prime
+    }
+
+    return hash;
+}
+
+
+uint64_t check_bytes(const void *data, size_t length, uint64_t hash) {
+    const unsigned char *bytes = data;
+    for(size_t i = 0; i < length; i++) {
+        hash = (hash + bytes[i] + 1) * 0xff51afd7ed558ccdull; //Multiplier from finalizer of MurmurHash3
+        hash ^= hash >> 29;
+    }
+
+    return hash;
+}
+
+
 /***                             End of dstring.c                          ***/
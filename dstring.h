@@ -24,22 +24,45 @@
 #include <stdbool.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
 
-#define STR_INIT_SPACE 8 /**< Initial allocated size for string */
+#define STR_INIT_SPACE 16 /**< Initial allocated size for string (it is buffer inside string structure) */
 
 //Return codes of string processing functions
 #define STR_SUCCESS 0
 #define STR_FAILURE 1
 
  
-//Dnamic string is implemented as dynamic array
+/**
+ * Dnamic string is implemented as dynamic array, short strings (shorter than STR_INIT_SPACE)
+ * are stored inside structure, so they don't need any allocation
+ * @note String is short if its alloc_size is STR_INIT_SPACE (dynamic arrays are always bigger),
+ *       string with zero alloc_size is not owned (it is not freed)
+ * @warning Structure of short string can be copied, so str of the copy points to data of the original, 
+ *          to get data of string use to_str()
+ */
 typedef struct string {
     size_t length; /**< Length of string */
     size_t alloc_size; /**< Allocated space for string */
     char * str; /**< String data */
+    char small[STR_INIT_SPACE]; /**< Data of short string */
 } string_t;
 
 
+#ifdef DSTRING_STATS
+/**
+ * @brief Counters of allocations of strings (only for measurement, @see dstring_bench.c)
+ */
+typedef struct str_stats {
+    size_t inits; /**< Number of initialized strings (each of them needed allocation before) */
+    size_t to_heap; /**< Number of strings, that were moved to dynamic array */
+    size_t reallocs; /**< Number of reallocations of dynamic arrays */
+} str_stats_t;
+
+extern str_stats_t str_stats;
+#endif
+
+
 //Character classes
 enum char_type {
     ALPHA, DIGIT, WHITESPACE, CONTROL, OTHER_CHARACTER
@@ -52,6 +75,12 @@ enum char_type {
  */
 int str_init(string_t *string);
 
+/**
+ * @brief Initializes string with space for at least capacity characters (without '\0')
+ * @note Use it if final length of string is known in advance, so string is not extended during appending
+ */
+int str_init_cap(string_t *string, size_t capacity);
+
 
 int extend_string(string_t *string);
 
@@ -78,6 +107,18 @@ int prep_char(char c, string_t *string);
  */ 
 int prep_str(string_t *dst, const char *src);
 
+/**
+ * @brief Ensures, that string has space for at least capacity characters (without '\0')
+ * @note Content of string is not changed
+ */ 
+int str_reserve(string_t *string, size_t capacity);
+
+/**
+ * @brief Same as str_reserve(), but string grows at least twice (for appending, that would be quadratic otherwise)
+ * @note Exact size is reserved only by str_reserve() and str_init_cap()
+ */ 
+int str_grow(string_t *string, size_t capacity);
+
 /**
  * @brief Cuts string to given length
  * @note if given length is same or greater than current length of string it does nothing
@@ -98,8 +139,9 @@ void str_dtor(string_t *string);
 
 /**
  * @brief Returns pointer to array of characters
+ * @note Pointer to short string is valid only until the string structure is moved
  */ 
-char * to_str(string_t *string);
+char * to_str(const string_t *string);
 
 /**
  * @brief Tries to find character in string
@@ -154,6 +196,24 @@ size_t len(string_t *str);
 int dstring_cmp(string_t* str1, string_t* str2);
 
 
+#define HASH_INIT 14695981039346656037ull /**< Initial value for hash_bytes() */
+
+/**
+ * @brief Computes 64-bit FNV-1a hash of given bytes
+ * @param hash Result of previous call (to hash more buffers at once) or HASH_INIT
+ */ 
+uint64_t hash_bytes(const void *data, size_t length, uint64_t hash);
+
+
+#define CHECK_INIT 0x6a09e667f3bcc908ull /**< Initial value for check_bytes() */
+
+/**
+ * @brief Computes 64-bit hash, that is independent on hash_bytes() (collision of both hashes is needed to confuse them)
+ * @param hash Result of previous call (to hash more buffers at once) or CHECK_INIT
+ */ 
+uint64_t check_bytes(const void *data, size_t length, uint64_t hash);
+
+
 #endif
 
 /***                             End of dstring.h                        ***/
@@ -0,0 +1,58 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                              dstring_bench.c
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *   Purpose: Microbenchmark, that counts allocations of strings during compilation
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file dstring_bench.c
+ * @brief Microbenchmark, that counts allocations of strings during compilation
+ * @note Usage: make dstring_bench && ./dstring_bench < program.tl
+ *       (all modules are compiled with DSTRING_STATS, so they count operations with strings)
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#include <time.h>
+#include "compiler.h"
+#include "scanner.h"
+
+
+int main() {
+    char *src = NULL;
+    size_t src_len = 0;
+    if(read_stream(stdin, &src, &src_len) != EXIT_SUCCESS) {
+        fprintf(stderr, "dstring_bench: Cannot read input!\n");
+        return INTERNAL_ERROR;
+    }
+
+    compile_result_t result;
+    clock_t start = clock();
+    compile_buffer(src, src_len, NULL, &result);
+    double time = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    //Before short strings were stored inside structure, every initialized string was allocated
+    size_t avoided = str_stats.inits - str_stats.to_heap;
+    printf("Return code:            %d\n", result.ret_code);
+    printf("Compilation time:       %.3f s\n", time);
+    printf("Initialized strings:    %lu\n", (unsigned long)str_stats.inits);
+    printf("Moved to dynamic array: %lu\n", (unsigned long)str_stats.to_heap);
+    printf("Reallocations:          %lu\n", (unsigned long)str_stats.reallocs);
+    printf("Allocations avoided:    %lu (%.1f %%)\n", (unsigned long)avoided,
+           str_stats.inits ? 100.0 * avoided / str_stats.inits : 0.0);
+
+    compile_result_dtor(&result);
+    free(src);
+
+    return EXIT_SUCCESS;
+}
+
+
+/***                          End of dstring_bench.c                       ***/
@@ -0,0 +1,513 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                               funccache.c
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *   Purpose: Cache of generated code of functions (incremental compilation)
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file funccache.c
+ * @brief Cache of generated code of functions (incremental compilation)
+ * @note For more documentation about functions and structures @see funccache.h
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#include "funccache.h"
+#include "tables.h"
+
+#include <string.h>
+
+#define FCACHE_INIT_SIZE 64
+
+//States of global symbol (they are stored as one byte)
+#define SYM_PRESENT 0x1 /**< Symbol is in global symbol table */
+#define SYM_USED 0x2 /**< Function was called */
+
+
+/**
+ * @brief Header of sidecar file (it is followed by entries)
+ */
+typedef struct sidecar_header {
+    char magic[sizeof(FCACHE_MAGIC) - 1];
+    uint64_t version; /**< Hash of version of compiler, that created sidecar */
+    uint64_t entry_num;
+} sidecar_header_t;
+
+/**
+ * @brief Header of one entry in sidecar file (it is followed by effects and code)
+ */
+typedef struct sidecar_entry {
+    uint64_t key;
+    uint64_t check;
+    uint64_t key_len;
+    uint64_t effects_len;
+    uint64_t code_len;
+} sidecar_entry_t;
+
+
+/**
+ * @brief Code of functions can't be reused by other version of compiler (@see codegen_salt())
+ */
+static uint64_t version_hash(fcache_t *fc) {
+    uint64_t salt = codegen_salt();
+
+    return hash_bytes(&fc->variant, sizeof(fc->variant), salt);
+}
+
+
+void fcache_init(fcache_t *fc) {
+    fc->data = NULL;
+    fc->loaded = NULL;
+    fc->loaded_num = 0;
+    fc->fresh = NULL;
+    fc->fresh_num = 0;
+    fc->fresh_alloc_size = 0;
+    fc->hits = 0;
+    fc->misses = 0;
+    fc->variant = 0;
+}
+
+
+static int entry_cmp(const void *a, const void *b) {
+    uint64_t key_a = ((const fcache_entry_t *)a)->key;
+    uint64_t key_b = ((const fcache_entry_t *)b)->key;
+
+    return (key_a > key_b) - (key_a < key_b);
+}
+
+
+/**
+ * @brief Checks, that effects are sequence of states and names terminated by '\0'
+ */
+static bool valid_effects(const char *effects, size_t len) {
+    size_t i = 0;
+    while(i < len) {
+        const char *name_end = memchr(effects + i + 1, '\0', len - i - 1);
+        if(i + 1 >= len || !name_end || name_end == effects + i + 1) {
+            return false;
+        }
+
+        i = name_end - effects + 1;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Splits content of sidecar file to entries
+ */
+static bool decode(fcache_t *fc, size_t len) {
+    sidecar_header_t h;
+    if(len < sizeof(h)) {
+        return false;
+    }
+
+    memcpy(&h, fc->data, sizeof(h));
+    if(memcmp(h.magic, FCACHE_MAGIC, sizeof(h.magic)) != 0 || h.version != version_hash(fc) ||
+       h.entry_num > len / sizeof(sidecar_entry_t)) {
+        return false;
+    }
+
+    fc->loaded = malloc(h.entry_num * sizeof(fcache_entry_t) + 1);
+    if(!fc->loaded) {
+        return false;
+    }
+
+    size_t pos = sizeof(h);
+    for(size_t i = 0; i < h.entry_num; i++) {
+        sidecar_entry_t e;
+        if(len - pos < sizeof(e)) {
+            return false;
+        }
+
+        memcpy(&e, fc->data + pos, sizeof(e));
+        pos += sizeof(e);
+        if(e.effects_len > len - pos || e.code_len > len - pos - e.effects_len) {
+            return false;
+        }
+
+        fcache_entry_t *entry = &fc->loaded[fc->loaded_num++];
+        entry->key = e.key;
+        entry->check = e.check;
+        entry->key_len = e.key_len;
+        entry->effects = fc->data + pos;
+        entry->effects_len = e.effects_len;
+        entry->code = entry->effects + e.effects_len;
+        entry->code_len = e.code_len;
+        entry->owned = false;
+
+        if(!valid_effects(entry->effects, entry->effects_len)) {
+            return false;
+        }
+
+        pos += e.effects_len + e.code_len;
+    }
+
+    qsort(fc->loaded, fc->loaded_num, sizeof(fcache_entry_t), entry_cmp);
+
+    return pos == len;
+}
+
+
+int fcache_read(fcache_t *fc, FILE *f) {
+    size_t len;
+    if(read_stream(f, &fc->data, &len) != EXIT_SUCCESS) {
+        return INTERNAL_ERROR;
+    }
+
+    if(!decode(fc, len)) {
+        free(fc->loaded);
+        free(fc->data);
+        fc->loaded = NULL;
+        fc->loaded_num = 0;
+        fc->data = NULL;
+
+        return INTERNAL_ERROR;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+int fcache_write(fcache_t *fc, FILE *f) {
+    sidecar_header_t h;
+    memcpy(h.magic, FCACHE_MAGIC, sizeof(h.magic));
+    h.version = version_hash(fc);
+    h.entry_num = fc->fresh_num;
+
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    for(size_t i = 0; ok && i < fc->fresh_num; i++) {
+        fcache_entry_t *entry = &fc->fresh[i];
+        sidecar_entry_t e = {.key = entry->key,
+                             .check = entry->check,
+                             .key_len = entry->key_len,
+                             .effects_len = entry->effects_len,
+                             .code_len = entry->code_len};
+
+        ok = fwrite(&e, sizeof(e), 1, f) == 1 &&
+             fwrite(entry->effects, sizeof(char), entry->effects_len, f) == entry->effects_len &&
+             fwrite(entry->code, sizeof(char), entry->code_len, f) == entry->code_len;
+    }
+
+    return ok ? EXIT_SUCCESS : INTERNAL_ERROR;
+}
+
+
+/**
+ * @brief Adds entry to entries of current compilation
+ */
+static bool add_fresh(fcache_t *fc, fcache_entry_t *entry) {
+    if(fc->fresh_num == fc->fresh_alloc_size) {
+        size_t new_size = fc->fresh_alloc_size ? fc->fresh_alloc_size * 2 : FCACHE_INIT_SIZE;
+        fcache_entry_t *extended = realloc(fc->fresh, new_size * sizeof(fcache_entry_t));
+        if(!extended) {
+            return false;
+        }
+
+        fc->fresh = extended;
+        fc->fresh_alloc_size = new_size;
+    }
+
+    fc->fresh[fc->fresh_num++] = *entry;
+
+    return true;
+}
+
+
+/**
+ * @brief Finds index of 'end', that closes block starting at given token
+ * @return False if there is no such 'end' (file is not complete)
+ */
+static bool find_end(const tok_record_t *records, size_t len, size_t start, size_t *end) {
+    size_t depth = 0;
+    for(size_t i = start; i < len; i++) {
+        const token_t *t = &records[i].token;
+        if(t->token_type != KEYWORD) {
+            continue;
+        }
+
+        if(t->attr_id == KW_FUNCTION || t->attr_id == KW_IF || t->attr_id == KW_WHILE) {
+            depth++;
+        }
+        else if(t->attr_id == KW_END && --depth == 0) {
+            *end = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+static int view_cmp(const void *a, const void *b) {
+    const attr_view_t *view_a = a, *view_b = b;
+    size_t min_len = view_a->len < view_b->len ? view_a->len : view_b->len;
+
+    int res = memcmp(view_a->str, view_b->str, min_len);
+
+    return res != 0 ? res : (view_a->len > view_b->len) - (view_a->len < view_b->len);
+}
+
+
+/**
+ * @brief Collects sorted unique identifiers of function to names of func
+ */
+static bool collect_names(fcache_func_t *func, scanner_t *sc) {
+    size_t id_num = 0;
+    for(size_t i = func->start; i <= func->end; i++) {
+        id_num += sc->replay[i].token.token_type == IDENTIFIER;
+    }
+
+    attr_view_t *ids = malloc(id_num * sizeof(attr_view_t) + 1);
+    if(!ids) {
+        return false;
+    }
+
+    size_t names_len = 0;
+    for(size_t i = func->start, j = 0; i <= func->end; i++) {
+        token_t t = sc->replay[i].token;
+        if(t.token_type == IDENTIFIER) {
+            ids[j++] = get_attr_view(&t, sc);
+            names_len += ids[j - 1].len + 1;
+        }
+    }
+
+    qsort(ids, id_num, sizeof(attr_view_t), view_cmp);
+
+    func->names = malloc(names_len + 1);
+    func->before = malloc(id_num + 1);
+    if(!func->names || !func->before) {
+        free(ids);
+        return false;
+    }
+
+    char *dst = func->names;
+    for(size_t i = 0; i < id_num; i++) {
+        if(i > 0 && view_cmp(&ids[i - 1], &ids[i]) == 0) {
+            continue;
+        }
+
+        memcpy(dst, ids[i].str, ids[i].len);
+        dst[ids[i].len] = '\0';
+        dst += ids[i].len + 1;
+        func->name_num++;
+    }
+
+    free(ids);
+
+    return true;
+}
+
+
+static unsigned char sym_state(tree_node_t *symbol) {
+    if(!symbol) {
+        return 0;
+    }
+
+    return SYM_PRESENT | (symbol->data.was_used ? SYM_USED : 0);
+}
+
+
+/**
+ * @brief Adds bytes to key of function (and to its independent hash)
+ */
+static void key_bytes(fcache_func_t *func, const void *data, size_t length) {
+    func->key = hash_bytes(data, length, func->key);
+    func->check = check_bytes(data, length, func->check);
+    func->key_len += length;
+}
+
+
+bool fcache_begin(fcache_t *fc, scanner_t *sc, symtab_t *global, fcache_func_t *func) {
+    func->names = NULL;
+    func->name_num = 0;
+    func->before = NULL;
+    func->entry = NULL;
+
+    if(!sc->replay) {
+        return false;
+    }
+
+    func->start = scanner_replay_pos(sc);
+    if(func->start >= sc->replay_len || sc->replay[func->start].token.attr_id != KW_FUNCTION ||
+       !find_end(sc->replay, sc->replay_len, func->start, &func->end) ||
+       !collect_names(func, sc)) {
+
+        fcache_func_dtor(func);
+        return false;
+    }
+
+    //Key is made from all tokens of function...
+    func->key = HASH_INIT;
+    func->check = CHECK_INIT;
+    func->key_len = 0;
+    for(size_t i = func->start; i <= func->end; i++) {
+        token_t t = sc->replay[i].token;
+        attr_view_t view = get_attr_view(&t, sc);
+
+        key_bytes(func, &t.token_type, sizeof(t.token_type));
+        key_bytes(func, &view.len, sizeof(view.len));
+        key_bytes(func, view.str, view.len);
+    }
+
+    //...and from global symbols with the same names as identifiers in function (e.g. signatures of callees)
+    char *name = func->names;
+    for(size_t i = 0; i < func->name_num; i++) {
+        tree_node_t *symbol = search(global, name);
+        func->before[i] = sym_state(symbol);
+
+        key_bytes(func, name, strlen(name) + 1);
+        key_bytes(func, &func->before[i], 1);
+        if(symbol) {
+            key_bytes(func, to_str(&symbol->data.params), len(&symbol->data.params) + 1);
+            key_bytes(func, to_str(&symbol->data.ret_types), len(&symbol->data.ret_types) + 1);
+        }
+
+        name += strlen(name) + 1;
+    }
+
+    if(fc->loaded_num > 0) {
+        fcache_entry_t wanted = {.key = func->key};
+        func->entry = bsearch(&wanted, fc->loaded, fc->loaded_num, sizeof(fcache_entry_t), entry_cmp);
+
+        //Keys are only hashes, so entry must match also in independent hash and in length of hashed data
+        if(func->entry && (func->entry->check != func->check || func->entry->key_len != func->key_len)) {
+            func->entry = NULL;
+        }
+    }
+
+    return true;
+}
+
+
+void fcache_reuse(fcache_t *fc, fcache_func_t *func, scanner_t *sc,
+                  symtab_t *global, prog_t *dst, instr_t *code_start) {
+
+    const fcache_entry_t *entry = func->entry;
+
+    cut_program(dst, code_start);
+    app_instr_raw(dst, entry->code, entry->code_len);
+
+    scanner_replay_seek(sc, func->end + 1);
+
+    //Body of function would add used builtins to global symbol table and mark called functions
+    const char *effect = entry->effects;
+    while(effect < entry->effects + entry->effects_len) {
+        unsigned char state = (unsigned char)effect[0];
+        char *name = (char *)effect + 1;
+
+        tree_node_t *symbol = search(global, name);
+        if(!symbol && (state & SYM_PRESENT) && check_builtin(name, global)) {
+            symbol = search(global, name);
+        }
+
+        if(symbol && (state & SYM_USED)) {
+            symbol->data.was_used = true;
+        }
+
+        effect = name + strlen(name) + 1;
+    }
+
+    fc->hits++;
+    if(!add_fresh(fc, (fcache_entry_t *)entry)) {
+        dst->int_error = true;
+    }
+}
+
+
+/**
+ * @brief Appends bytes (that can contain '\0') to string
+ */
+static bool app_bytes(string_t *dst, const char *src, size_t length) {
+    if(str_grow(dst, len(dst) + length) != STR_SUCCESS) {
+        return false;
+    }
+
+    memcpy(to_str(dst) + dst->length, src, length);
+    dst->length += length;
+    to_str(dst)[dst->length] = '\0';
+
+    return true;
+}
+
+
+int fcache_finish(fcache_t *fc, fcache_func_t *func, symtab_t *global,
+                  prog_t *dst, instr_t *code_start) {
+
+    fc->misses++;
+
+    //Data are taken over by entry, so they must be in dynamic array (not inside string structure)
+    string_t data;
+    if(str_init(&data) != STR_SUCCESS || str_reserve(&data, STR_INIT_SPACE) != STR_SUCCESS) {
+        return INTERNAL_ERROR;
+    }
+
+    //Effects are changes of global symbols with names used in function
+    bool ok = true;
+    char *name = func->names;
+    for(size_t i = 0; i < func->name_num; i++) {
+        char after = (char)sym_state(search(global, name));
+        if(after != (char)func->before[i]) {
+            ok = ok && app_bytes(&data, &after, 1) && app_bytes(&data, name, strlen(name) + 1);
+        }
+
+        name += strlen(name) + 1;
+    }
+
+    size_t effects_len = len(&data);
+    for(instr_t *instr = get_next(code_start); ok && instr; instr = get_next(instr)) {
+        ok = app_bytes(&data, instr->content.str, strlen(instr->content.str)) &&
+             (!get_next(instr) || app_bytes(&data, "\n", 1));
+    }
+
+    fcache_entry_t entry = {.key = func->key,
+                            .check = func->check,
+                            .key_len = func->key_len,
+                            .effects = data.str,
+                            .effects_len = effects_len,
+                            .code = data.str + effects_len,
+                            .code_len = len(&data) - effects_len,
+                            .owned = true};
+
+    if(!ok || dst->int_error || !add_fresh(fc, &entry)) {
+        str_dtor(&data);
+        return INTERNAL_ERROR;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+void fcache_func_dtor(fcache_func_t *func) {
+    free(func->names);
+    free(func->before);
+    func->names = NULL;
+    func->before = NULL;
+    func->name_num = 0;
+}
+
+
+void fcache_dtor(fcache_t *fc) {
+    for(size_t i = 0; i < fc->fresh_num; i++) {
+        if(fc->fresh[i].owned) {
+            mem_free((char *)fc->fresh[i].effects);
+        }
+    }
+
+    free(fc->fresh);
+    free(fc->loaded);
+    free(fc->data);
+
+    fcache_init(fc);
+}
+
+
+/***                            End of funccache.c                         ***/
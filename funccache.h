@@ -0,0 +1,138 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                               funccache.h
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *   Purpose: Cache of generated code of functions (incremental compilation)
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file funccache.h
+ * @brief Cache of generated code of functions (incremental compilation)
+ * @note Every global function is identified by key, that is computed from its tokens and from
+ *       global symbols, that are named inside it (signatures of callees, builtins that are already used...).
+ *       If key of function is found in sidecar file from previous compilation, its body is not parsed
+ *       and its code is taken from sidecar. Only functions compiled without warnings are stored.
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#ifndef FUNCCACHE_H
+#define FUNCCACHE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "scanner.h"
+#include "symtable.h"
+#include "generator.h"
+
+#define FCACHE_MAGIC "IFJ21FN2" /**< The first bytes of sidecar file */
+
+
+/**
+ * @brief Generated code of one function together with its effects on global symbol table
+ */
+typedef struct fcache_entry {
+    uint64_t key;
+    uint64_t check; /**< Second hash of function (to detect collisions of keys) */
+    uint64_t key_len; /**< Number of bytes, that key was computed from */
+    const char *effects; /**< Sequence of [state of symbol after compilation of function][name]['\0'] */
+    size_t effects_len;
+    const char *code; /**< Generated code (instructions separated by '\n') */
+    size_t code_len;
+    bool owned; /**< Entry was created by current compilation (effects and code are in one allocated block) */
+} fcache_entry_t;
+
+
+/**
+ * @brief Entries from previous compilation (sidecar) and entries of current compilation
+ */
+typedef struct fcache {
+    char *data; /**< Content of sidecar file (loaded entries point into it) */
+    fcache_entry_t *loaded; /**< Entries from sidecar sorted by key */
+    size_t loaded_num;
+    fcache_entry_t *fresh; /**< Entries of functions of current compilation (they will be written to sidecar) */
+    size_t fresh_num;
+    size_t fresh_alloc_size;
+    size_t hits; /**< Number of functions, whose code was taken from sidecar */
+    size_t misses; /**< Number of functions, that were compiled */
+    uint64_t variant; /**< Options, that change generated code (e. g. level of optimizations), sidecar of other variant is not loaded */
+} fcache_t;
+
+
+/**
+ * @brief Function, that is being compiled
+ */
+typedef struct fcache_func {
+    size_t start; /**< Index of 'function' keyword in recorded token stream */
+    size_t end; /**< Index of corresponding 'end' keyword */
+    uint64_t key; /**< Hash of tokens of function and of global symbols used by it (@see hash_bytes()) */
+    uint64_t check; /**< Independent hash of the same data (@see check_bytes()) */
+    uint64_t key_len; /**< Number of hashed bytes */
+    char *names; /**< Identifiers used in function (each is terminated by '\0') */
+    size_t name_num;
+    unsigned char *before; /**< State of global symbols with names from names before compilation of function */
+    const fcache_entry_t *entry; /**< Entry of function found in sidecar (NULL if function must be compiled) */
+} fcache_func_t;
+
+
+/**
+ * @brief Sets initial values to cache (it is empty)
+ */
+void fcache_init(fcache_t *fc);
+
+/**
+ * @brief Loads entries from sidecar file
+ * @return EXIT_SUCCESS or INTERNAL_ERROR if file is not valid sidecar of this version of compiler (cache stays empty)
+ */
+int fcache_read(fcache_t *fc, FILE *f);
+
+/**
+ * @brief Writes entries of current compilation to sidecar file
+ */
+int fcache_write(fcache_t *fc, FILE *f);
+
+/**
+ * @brief Computes key of function, that starts at the next token of scanner, and tries to find it in loaded entries
+ * @note Scanner must be in replay mode (@see scanner_replay()), because the whole function must be known in advance
+ * @return False if function can't be cached (e.g. it has no end), func should not be used then
+ */
+bool fcache_begin(fcache_t *fc, scanner_t *sc, symtab_t *global, fcache_func_t *func);
+
+/**
+ * @brief Uses code from found entry instead of compiling the body of function
+ * @param code_start The last instruction before code of function (code generated after it is replaced)
+ * @note Scanner continues after the end of function and effects of function on global symbols are applied
+ */
+void fcache_reuse(fcache_t *fc, fcache_func_t *func, scanner_t *sc,
+                  symtab_t *global, prog_t *dst, instr_t *code_start);
+
+/**
+ * @brief Creates new entry from compiled function
+ * @param code_start The last instruction before code of function
+ * @return INTERNAL_ERROR if allocation failed
+ */
+int fcache_finish(fcache_t *fc, fcache_func_t *func, symtab_t *global,
+                  prog_t *dst, instr_t *code_start);
+
+/**
+ * @brief Frees resources of function structure
+ */
+void fcache_func_dtor(fcache_func_t *func);
+
+/**
+ * @brief Frees all resources held by cache
+ */
+void fcache_dtor(fcache_t *fc);
+
+
+#endif
+
+/***                            End of funccache.h                         ***/
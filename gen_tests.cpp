@@ -9,6 +9,7 @@ extern "C" {
 
 #include "gtest/gtest.h"
 #include <string>
+#include <vector>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -99,6 +100,163 @@ TEST_F(test_fixture, only_parse) {
 
 
 
+TEST(instr_pool, moved_pools) {
+    prog_t program;
+    init_new_prog(&program);
+    app_instr(&program, "LABEL %s", "main");
+
+    prog_t expr; //Has more chunks, that are moved to program
+    init_new_prog(&expr);
+    for(int i = 0; i < 10000; i++) { //Instructions don't fit to one chunk
+        app_instr(&expr, "PUSHS int@%d", i);
+    }
+    app_prog(&program, &expr);
+    EXPECT_EQ(expr.pool, (instr_pool_t *)NULL);
+
+    prog_t other; //Has its own pool, that is moved to program
+    init_new_prog(&other);
+    std::string long_text(2 * INSTR_CHUNK_SIZE, 'a');
+    app_instr_raw(&other, long_text.c_str(), long_text.length());
+    app_prog(&program, &other);
+    EXPECT_EQ(other.pool, (instr_pool_t *)NULL);
+
+    app_instr(&program, "CLEARS");
+    EXPECT_FALSE(program.int_error);
+
+    std::vector<std::string> got;
+    for(instr_t *i = program.first_instr; i; i = get_next(i)) {
+        got.push_back(to_str(&i->content));
+    }
+
+    ASSERT_EQ(got.size(), 10003u);
+    EXPECT_EQ(got[0], "LABEL main");
+    EXPECT_EQ(got[1], "PUSHS int@0");
+    EXPECT_EQ(got[10000], "PUSHS int@9999");
+    EXPECT_EQ(got[10001], long_text);
+    EXPECT_EQ(got[10002], "CLEARS");
+
+    program_dtor(&program); //Releases instructions of all programs
+    EXPECT_EQ(program.pool, (instr_pool_t *)NULL);
+}
+
+
+
+TEST(dstring, short_strings) {
+    string_t s;
+    str_init(&s);
+    ASSERT_EQ(app_str(&s, "0123456789abcde"), STR_SUCCESS); //Short string (it fits to buffer in structure)
+    EXPECT_EQ(s.alloc_size, (size_t)STR_INIT_SPACE);
+
+    string_t copy = s; //Copy of short string has its own data
+    EXPECT_STREQ(to_str(&copy), "0123456789abcde");
+    EXPECT_EQ(to_str(&copy), copy.small);
+
+    ASSERT_EQ(app_char('f', &s), STR_SUCCESS); //String is moved to dynamic array
+    EXPECT_GT(s.alloc_size, (size_t)STR_INIT_SPACE);
+    EXPECT_STREQ(to_str(&s), "0123456789abcdef");
+    EXPECT_STREQ(to_str(&copy), "0123456789abcde");
+
+    str_clear(&copy);
+    ASSERT_EQ(prep_str(&copy, "E+E"), STR_SUCCESS);
+    EXPECT_STREQ(to_str(&copy), "E+E");
+    EXPECT_EQ(len(&copy), 3u);
+
+    str_dtor(&copy);
+    str_dtor(&s);
+}
+
+
+
+TEST(dstring, reserved_capacity) {
+    string_t s;
+    ASSERT_EQ(str_init_cap(&s, 100), STR_SUCCESS);
+    EXPECT_EQ(s.alloc_size, 101u); //Reserved exactly
+    EXPECT_STREQ(to_str(&s), "");
+
+    std::string text(101, 'x');
+    ASSERT_EQ(app_str(&s, text.c_str()), STR_SUCCESS); //Appending grows string geometrically
+    EXPECT_EQ(s.alloc_size, 202u);
+    ASSERT_EQ(app_str(&s, text.c_str() + 1), STR_SUCCESS); //It fits
+    EXPECT_EQ(s.alloc_size, 202u);
+    EXPECT_EQ(std::string(to_str(&s)), text + text.substr(1));
+    str_dtor(&s);
+}
+
+
+
+TEST(to_ascii, escape_sequences) {
+    string_t out;
+    str_init(&out);
+
+    ASSERT_EQ(to_ascii("\"a b#c\\n\\t\\\"\\\\\\065\tz\"", &out), STR_SUCCESS);
+    EXPECT_STREQ(to_str(&out), "a\\032b\\035c\\010\\009\\034\\092\\065\\009z");
+
+    str_clear(&out);
+    ASSERT_EQ(to_ascii("\"\"", &out), STR_SUCCESS);
+    EXPECT_STREQ(to_str(&out), "");
+
+    str_dtor(&out);
+}
+
+
+TEST(to_ascii, long_literal) {
+    std::string literal = "\"";
+    std::string expected;
+    for(size_t i = 0; i < 100000; i++) {
+        literal += "ab \\n";
+        expected += "ab\\032\\010";
+    }
+    literal += "\"";
+
+    string_t out;
+    str_init(&out);
+
+    ASSERT_EQ(to_ascii(literal.c_str(), &out), STR_SUCCESS);
+    EXPECT_EQ(std::string(to_str(&out)), expected);
+    EXPECT_EQ(len(&out), expected.length());
+
+    str_dtor(&out);
+}
+
+
+TEST(write_hex_float, same_as_printf) {
+    std::vector<double> values = {0.0, 1.0, 0.5, 0.1, 2.0, 1e300, 1e-300, DBL_MAX, DBL_MIN, 4.9e-324, 2.5e-310, 123.456};
+
+    srand(42);
+    for(size_t i = 0; i < 100000; i++) { //Random bit patterns of finite doubles
+        uint64_t bits = ((uint64_t)rand() << 40) ^ ((uint64_t)rand() << 20) ^ (uint64_t)rand();
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if(!isinf(value) && !isnan(value)) {
+            values.push_back(value);
+        }
+    }
+
+    char expected[64], got[64];
+    for(double value : values) {
+        snprintf(expected, sizeof(expected), "%a", value);
+        size_t length = write_hex_float(got, value);
+
+        EXPECT_STREQ(got, expected);
+        EXPECT_EQ(length, strlen(expected));
+    }
+}
+
+
+TEST(write_int, same_as_printf) {
+    std::vector<long long> values = {0, 1, 9, 10, 123456789, -1, -100, LLONG_MAX, LLONG_MIN};
+
+    char expected[32], got[32];
+    for(long long value : values) {
+        snprintf(expected, sizeof(expected), "%lld", value);
+        size_t length = write_int(got, value);
+
+        EXPECT_STREQ(got, expected);
+        EXPECT_EQ(length, strlen(expected));
+    }
+}
+
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
 
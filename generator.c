@@ -23,87 +23,200 @@
 
 /***                 Functions for internal represenation                  ***/
 
-DSTACK(instr_t *, instr,)
-
 DSTACK(prog_t, prog,)
 
 
-instr_t *new_instruction() {
-    instr_t *instr = NULL;
+void init_new_prog(prog_t *program) {
+    program->first_instr = NULL;
+    program->last_instr = NULL;
 
-    instr = (instr_t *)malloc(sizeof(instr_t));
-    if(!instr) {
-        fprintf(stderr,"Allocation error!\n");
-        return NULL;
+    program->int_error = false;
+
+    program->pool = NULL;
+}
+
+
+/**
+ * @brief Returns pool of program (if program has no pool, new pool is created)
+ */ 
+static instr_pool_t *get_pool(prog_t *program) {
+    if(!program->pool) {
+        program->pool = (instr_pool_t *)mem_alloc(sizeof(instr_pool_t));
+        if(!program->pool) {
+            return NULL;
+        }
+
+        program->pool->chunks = NULL;
     }
 
-    instr->next = NULL;
-    instr->prev = NULL;
+    return program->pool;
+}
 
-    if(str_init(&instr->content) != STR_SUCCESS) {
-        free(instr);
-        return NULL;
+
+/**
+ * @brief Frees all chunks of pool and pool itself
+ */ 
+static void pool_dtor(instr_pool_t *pool) {
+    instr_chunk_t *chunk = pool->chunks;
+    while(chunk) {
+        instr_chunk_t *next = chunk->next;
+        mem_free(chunk);
+        chunk = next;
     }
 
-    return instr;
+    mem_free(pool);
 }
 
 
-int set_instruction(instr_t *instr, const char *const _Format, va_list args) {
-    size_t written = 0;
-    string_t *cont = &(instr->content);
+void program_dtor(prog_t *program) {
+    //Instructions are not freed one by one (and in arena mode they are released together with arena)
+    if(program->pool && !arena_active()) {
+        pool_dtor(program->pool);
+    }
 
-    va_list args_tmp;
-    va_copy(args_tmp, args); //Saving args for multiple use
+    program->pool = NULL;
 
-    written = vsnprintf(cont->str, cont->alloc_size, _Format, args); //First attemt to store 
+    program->first_instr = NULL;
+    program->last_instr = NULL;
+}
 
-    while(written >= cont->alloc_size) { //Capacity of dynamic string is too small
-        str_clear(cont);
-        
-        if(extend_string(cont) != STR_SUCCESS) {
-            return INTERNAL_ERROR;
+
+/**
+ * @brief Moves chunks of pool of src program to pool of dst program
+ */ 
+static void merge_pool(prog_t *dst, prog_t *src) {
+    if(!dst->pool) {
+        dst->pool = src->pool;
+    }
+    else {
+        instr_chunk_t *last = src->pool->chunks;
+        if(last) {
+            while(last->next) {
+                last = last->next;
+            }
+
+            //Chunks are put behind the current chunk of dst, so it can be still used for allocation
+            if(dst->pool->chunks) {
+                last->next = dst->pool->chunks->next;
+                dst->pool->chunks->next = src->pool->chunks;
+            }
+            else {
+                dst->pool->chunks = src->pool->chunks;
+            }
         }
-    
-        va_copy(args, args_tmp); //Restore args (its undefined)
-        written = vsnprintf(cont->str, cont->alloc_size, _Format, args); //Next attempt
+
+        mem_free(src->pool);
     }
 
-    return EXIT_SUCCESS;
+    src->pool = NULL;
 }
 
 
-void instr_dtor(instr_t *instr) {
-    instr->next = NULL;
-    instr->prev = NULL;
+//Every block allocated from chunk starts at address aligned as this type
+typedef union pool_align {
+    void *ptr;
+    size_t size;
+    double dbl;
+} pool_align_t;
 
-    str_dtor(&instr->content);
-    free(instr);
+#define POOL_ALIGN(size) (((size) + sizeof(pool_align_t) - 1) / sizeof(pool_align_t) * sizeof(pool_align_t))
+
+
+/**
+ * @brief Returns number of bytes, that can be used for text of instruction allocated from given chunk
+ */ 
+static size_t chunk_text_space(instr_chunk_t *chunk) {
+    if(!chunk || chunk->size - chunk->used <= sizeof(instr_t)) {
+        return 0;
+    }
+
+    return chunk->size - chunk->used - sizeof(instr_t);
 }
 
 
-void init_new_prog(prog_t *program) {
-    program->first_instr = NULL;
-    program->last_instr = NULL;
+/**
+ * @brief Returns pointer to the first free byte of chunk
+ */ 
+static char *chunk_free(instr_chunk_t *chunk) {
+    return (char *)(chunk + 1) + chunk->used;
+}
+
+
+/**
+ * @brief Allocates instruction from pool of program (text with given length is right after it)
+ * @note If text_size is 0, content of instruction is not initialized
+ */ 
+static instr_t *pool_instr(prog_t *dst, size_t text_size) {
+    instr_pool_t *pool = get_pool(dst);
+    if(!pool) {
+        return NULL;
+    }
+
+    size_t needed = POOL_ALIGN(sizeof(instr_t) + text_size);
+    instr_chunk_t *chunk = pool->chunks;
+    if(!chunk || chunk->size - chunk->used < needed) {
+        size_t size = needed > INSTR_CHUNK_SIZE ? needed : INSTR_CHUNK_SIZE;
+        chunk = (instr_chunk_t *)mem_alloc(sizeof(instr_chunk_t) + size);
+        if(!chunk) {
+            return NULL;
+        }
+
+        chunk->size = size;
+        chunk->used = 0;
+
+        if(size > INSTR_CHUNK_SIZE && pool->chunks) { //Big chunk is used only once, so the current chunk stays
+            chunk->next = pool->chunks->next;
+            pool->chunks->next = chunk;
+        }
+        else {
+            chunk->next = pool->chunks;
+            pool->chunks = chunk;
+        }
+    }
+
+    instr_t *instr = (instr_t *)chunk_free(chunk);
+    chunk->used += needed;
+
+    instr->next = NULL;
+    instr->prev = NULL;
+
+    //Text is owned by pool (string with zero allocated size is not freed)
+    instr->content.str = text_size > 0 ? (char *)(instr + 1) : NULL;
+    instr->content.length = text_size > 0 ? text_size - 1 : 0;
+    instr->content.alloc_size = 0;
 
-    program->cycle_nest_lvl = 0;
+    return instr;
 }
 
 
-void program_dtor(prog_t *program) {
-    instr_t *current = program->last_instr;
-    instr_t *next_deletion;
+/**
+ * @brief Creates instruction with formatted content in pool of program
+ * @note Text is formatted directly to free space of current chunk, if it is too small, it is formatted again to new chunk
+ *       (block of exactly needed size), it happens only with the last instructions of chunk (~0.3 % of them),
+ *       so it is cheaper than computing length of every instruction in advance
+ */ 
+static instr_t *pool_format(prog_t *dst, const char *const _Format, va_list args) {
+    va_list args_tmp;
+    va_copy(args_tmp, args); //Saving args for second attempt
 
-    while(current) { //Deletion of every instruction in given program from its end
-        next_deletion = current->prev; 
- 
-        instr_dtor(current);
+    instr_chunk_t *chunk = dst->pool ? dst->pool->chunks : NULL;
+    size_t space = chunk_text_space(chunk);
 
-        current = next_deletion;
+    char *text = space > 0 ? chunk_free(chunk) + sizeof(instr_t) : NULL;
+    int written = vsnprintf(text, space, _Format, args);
+
+    instr_t *instr = NULL;
+    if(written >= 0) {
+        instr = pool_instr(dst, (size_t)written + 1);
+
+        if(instr && (size_t)written >= space) { //Text was not written (or it was truncated)
+            vsnprintf(instr->content.str, (size_t)written + 1, _Format, args_tmp);
+        }
     }
 
-    program->first_instr = NULL;
-    program->last_instr = NULL;
+    va_end(args_tmp);
+
+    return instr;
 }
 
 
@@ -127,23 +240,10 @@ instr_t *get_prev(instr_t *instr) {
 }
 
 
-void app_instr(prog_t *dst, const char *const _Format, ...) {
-    //Creation of new instruction
-    instr_t *new_instr = new_instruction();
-    if(new_instr == NULL) {
-        exit(INTERNAL_ERROR);
-    }
-
-    va_list args;
-    va_start(args, _Format);
-
-    if(set_instruction(new_instr, _Format, args) != EXIT_SUCCESS) {
-        exit(INTERNAL_ERROR);
-    }
-
-    va_end(args);
-    
-    //Putting instruction to the end of program
+/**
+ * @brief Puts instruction to the end of program
+ */ 
+static void link_instr(prog_t *dst, instr_t *new_instr) {
     if(dst->first_instr == NULL) {
         dst->first_instr = new_instr;
     }
@@ -153,177 +253,100 @@ void app_instr(prog_t *dst, const char *const _Format, ...) {
     }
 
     dst->last_instr = new_instr;
-
 }
 
 
-void app_prog(prog_t *dst, prog_t *prog) {
-    if(get_first(dst) != NULL) { //Destination program can be empty
-        
-        if(get_first(prog) != NULL) { //Apended program can be empty
-            prog->first_instr->prev = dst->last_instr;
-        }
-
-        dst->last_instr->next = prog->first_instr;     
-    }
-    else {
-        dst->first_instr = prog->first_instr;
-    }
-
-    dst->last_instr = prog->last_instr;
-}
-
-
-void ins_after(prog_t *dst, instr_t *instr, const char *const _Format, ...) {
-    if(instr == NULL) {
-        return;
-    }
-
-    //Creation of new instruction
-    instr_t *new_instr  = new_instruction();
-    if(new_instr == NULL) {
-        exit(INTERNAL_ERROR);
-    }
-
+void app_instr(prog_t *dst, const char *const _Format, ...) {
     va_list args;
     va_start(args, _Format);
 
-    if(set_instruction(new_instr, _Format, args) != EXIT_SUCCESS) {
-        exit(INTERNAL_ERROR);
-    }
+    //Creation of new instruction
+    instr_t *new_instr = pool_format(dst, _Format, args);
 
     va_end(args);
 
-    instr_t * instr_after = instr->next;
-
-    //Putting instruction inside list of instructions (program)
-    instr->next = new_instr;
-    new_instr->prev = instr;
-    if(instr_after != NULL) {
-        instr_after->prev = new_instr;
-        new_instr->next = instr_after;
-    }
-    else {
-        dst->last_instr = new_instr;
-        new_instr->next = NULL;
+    if(new_instr == NULL) {
+        dst->int_error = true;
+        return;
     }
+    
+    link_instr(dst, new_instr);
 }
 
 
-void ins_before(prog_t *dst, instr_t *instr, const char *const _Format, ...) {
-    if(instr == NULL) {
-        return;
-    }
-
-    instr_t *new_instr  = new_instruction();
+void app_instr_raw(prog_t *dst, const char *content, size_t length) {
+    instr_t *new_instr = pool_instr(dst, length + 1);
     if(new_instr == NULL) {
-        exit(INTERNAL_ERROR);
-    }
-
-    va_list args;
-    va_start(args, _Format);
-
-    if(set_instruction(new_instr, _Format, args) != EXIT_SUCCESS) {
-        exit(INTERNAL_ERROR);
+        dst->int_error = true;
+        return;
     }
 
-    va_end(args);
+    memcpy(new_instr->content.str, content, length);
+    new_instr->content.str[length] = '\0';
 
-    instr_t * instr_before = instr->prev;
-
-    //Putting instruction inside list of instructions (program)
-    instr->prev = new_instr;
-    new_instr->next = instr;
-    if(instr_before != NULL) {
-        instr_before->next = new_instr;
-        new_instr->prev = instr_before;
-    }
-    else {
-        dst->first_instr = new_instr;
-        new_instr->prev = NULL;
-    }
+    link_instr(dst, new_instr);
 }
 
 
-instr_t * fill_stack(instr_stack_t *to_be_filled, prog_t *dst, 
-                     instr_t *from, instr_t *to) {
-
-    instr_t * current = from;
-    while(current) {
-        if(!instr_push(to_be_filled, current)) {
-            return NULL;
-        }
-
-        if(current == to) {
-            break;
-        }
-
-        current = current->next;
+void app_instr_static(prog_t *dst, const char *text, size_t length) {
+    instr_t *new_instr = pool_instr(dst, 0);
+    if(new_instr == NULL) {
+        dst->int_error = true;
+        return;
     }
 
-    return current;
+    //Text is not owned by instruction (string with zero allocated size is not freed)
+    new_instr->content.str = (char *)text;
+    new_instr->content.length = length;
+
+    link_instr(dst, new_instr);
 }
 
 
-void revert(prog_t *dst, instr_t *from, instr_t *to) {
-    if(from == NULL || to == NULL) {
-        return;
-    }
+void app_prog(prog_t *dst, prog_t *prog) {
+    dst->int_error = dst->int_error || prog->int_error;
 
-    instr_stack_t stack;
-    if(!instr_stack_init(&stack)) {
-        return;
+    if(prog->pool) {
+        merge_pool(dst, prog);
     }
 
-    instr_t * instr_before = from->prev;
-    instr_t * instr_after = to->next;
-    
-    if(!fill_stack(&stack, dst, from, to)) { //Fill stack with instructions that will be reverted
-        instr_stack_dtor(&stack);
+    if(get_first(prog) == NULL) { //Nothing to append (the last instruction of dst must be kept)
         return;
     }
 
-    instr_t *last = NULL;
-    instr_t *current = NULL;
-    if(!instr_is_empty(&stack)) { //Handling instruction before
-        current = instr_top(&stack);
-
-        if(instr_before) {
-            instr_before->next = instr_pop(&stack);
-            current->prev = instr_before;
-        }
-        else {
-            dst->first_instr = instr_pop(&stack);
-            current->prev = NULL;
+    if(get_first(dst) != NULL) { //Destination program can be empty
+        
+        if(get_first(prog) != NULL) { //Apended program can be empty
+            prog->first_instr->prev = dst->last_instr;
         }
+
+        dst->last_instr->next = prog->first_instr;     
     }
-    while(!instr_is_empty(&stack)) //Inserts instructions from stack (in reversed order)
-    {
-        current->next = instr_top(&stack);
-        last = current;
-        current = instr_pop(&stack);
-        current->prev = last;
-    }
-    if(current) { //Handling instruction after
-        if(instr_after) {
-            current->next = instr_after;
-            instr_after->prev = current;
-        }
-        else {
-            dst->last_instr = current;
-            current->next = NULL;
-        }
+    else {
+        dst->first_instr = prog->first_instr;
     }
 
-    instr_stack_dtor(&stack);
+    dst->last_instr = prog->last_instr;
+}
+
+
+void cut_program(prog_t *dst, instr_t *last) {
+    //Instructions are only unlinked, they are freed with pool
+    last->next = NULL;
+    dst->last_instr = last;
 }
 
 
 void print_program(prog_t *source) {
+    fprint_program(stdout, source);
+}
+
+
+void fprint_program(FILE *dst, prog_t *source) {
     instr_t *current_instr = source->first_instr;
 
     while(current_instr) {
-        fprintf(stdout, "%s\n", to_str(&current_instr->content));
+        fprintf(dst, "%s\n", to_str(&current_instr->content));
 
         current_instr = current_instr->next;
     }
@@ -332,7 +355,7 @@ void print_program(prog_t *source) {
 /***                 End of functions for internal representation          ***/
 
 
-void generate_init(prog_t *dst){
+void render_prelude(prog_t *dst){
     
     app_instr(dst,".IFJcode21");
     app_instr(dst,"CREATEFRAME");
@@ -364,8 +387,8 @@ void generate_init(prog_t *dst){
     generate_operation_function_mod(dst);
 }
 
-function_name_t *get_builtin_by_name(char *name) {
-    static function_name_t builtin[] = {
+const function_name_t *get_builtin_by_name(char *name) {
+    static const function_name_t builtin[] = {
         {"chr",generate_chr_function},
         {"ord",generate_ord_function},
         {"readi",generate_readi_function},
@@ -385,26 +408,6 @@ function_name_t *get_builtin_by_name(char *name) {
     return NULL;
 }
 
-int generate_builtin(prog_t *dst, symtab_t *symtab){
-    //symtab should be global
-    // bool is_builtin = check_builtin(get_attr(&id_fc, parser->scanner), &parser->sym.global);
-    for (size_t i = 0; i < BUILTIN_TABLE_SIZE; i++)
-    {
-        /* code */
-        sym_data_t *data = builtin_functions(i);
-        if(search(symtab, data->name.str) != NULL) {
-            //if used we generate it
-            function_name_t *func = get_builtin_by_name(data->name.str);
-            if(func == NULL){
-                return INTERNAL_ERROR;
-            }else{
-                func->function_ptr(dst);
-            }
-        }
-    }
-    return 0;
-}
-
 /**
  * *---------FUNCTIONS---------
  */ 
@@ -418,23 +421,6 @@ void generate_start_function(prog_t *dst, const char * name){
 }
 
 
-void generate_parameters( prog_t *dst, void *sym_stack,symtab_t *symtab , void *param_names, scanner_t * scanner){
-
-    tok_stack_t *params = param_names;
-    
-    while (!tok_is_empty(params))
-    {
-        //get it from the token name
-        token_t name_token = tok_pop(params);
-        string_t name_unique = get_unique_name(sym_stack, symtab,&name_token,scanner);
-
-        generate_parameter(dst,name_unique.str);
-
-    }
-
-}
-
-
 void generate_parameter(prog_t *dst, const char * name){
     app_instr(dst,"#define param %s",name);
     app_instr(dst,"DEFVAR %s%s",VAR_FORMAT,name); //creates temporary variable
@@ -515,20 +501,9 @@ void generate_reverse_stack(prog_t *dst, size_t n_values) {
  * *---------VARIABLES---------
  */
 
-void generate_declare_variable(prog_t *dst,  void *sym_stack,symtab_t *symtab , token_t *var_id, scanner_t * scanner){
-    string_t name = get_unique_name(sym_stack,symtab,var_id,scanner);
-    if(dst->cycle_nest_lvl == 0) {
-        //we are not in a while loop, we append it
-        app_instr(dst,"DEFVAR %s%s",VAR_FORMAT,name.str);
-        app_instr(dst,"MOVE %s%s nil@nil",VAR_FORMAT,name.str);
-    }
-    else{ 
-        //if we are in a while loop we insert it before the while loops start
-        ins_before(dst,instr_top(&dst->cycle_stack),"DEFVAR %s%s",VAR_FORMAT,name.str);
-        ins_before(dst,instr_top(&dst->cycle_stack),"MOVE %s%s nil@nil",VAR_FORMAT,name.str);
-        //will actually print them in reverse order because we are using ins_before
-        //BUT it will keep MOVE after DEFVAR
-    }
+void generate_declare_variable(prog_t *dst, const char *name){
+    app_instr(dst,"DEFVAR %s%s",VAR_FORMAT,name);
+    app_instr(dst,"MOVE %s%s nil@nil",VAR_FORMAT,name);
 }
 
 
@@ -539,8 +514,12 @@ void generate_multiple_assignment(prog_t *dst,  void *sym_stack, symtab_t *symta
         //get it from the token name
         token_t name_token = tok_pop(params);
         string_t name_unique = get_unique_name(sym_stack,symtab,&name_token,scanner);
+        if(to_str(&name_unique) == NULL) {
+            dst->int_error = true;
+            return;
+        }
         
-        generate_assign_value(dst,name_unique.str);
+        generate_assign_value(dst,to_str(&name_unique));
     }
 }
 
@@ -558,89 +537,112 @@ void generate_value_push(prog_t *dst,  sym_type_t type, sym_dtype_t dtype, const
     }else if(type == VAL){
         if(dtype == STR){
             string_t token_s;
-            str_init(&token_s);
-            to_ascii(token, &token_s);
+            if(str_init(&token_s) != STR_SUCCESS || to_ascii(token, &token_s) != STR_SUCCESS) {
+                str_dtor(&token_s);
+                dst->int_error = true;
+                return;
+            }
+
             app_instr(dst,"#here");
-            app_instr(dst,"PUSHS %s@%s",convert_type(dtype), token_s.str);
+            app_instr(dst,"PUSHS %s@%s",convert_type(dtype), to_str(&token_s));
             
             str_dtor(&token_s);
-        }else if(dtype == NUM){
-            char *rest = NULL;
-            double num = strtod(token, &rest);
-
-            if(errno == ERANGE) { //Prevent inf
-                if(GEN_WARNING) {
-                    fprintf(stderr, "\t|\033[1;33m Warning: \033[0m");
-                    fprintf(stderr, "Numeric literal '\033[1;33m%s\033[0m' is out of compilers range. It will be truncated to %e\n", token, DBL_MAX);
-                    fprintf(stderr, "\t| Check your interpret if it supports as big numbers as this!\n");
-                }
-                
-                num = DBL_MAX;
-            }
-
-            app_instr(dst,"PUSHS %s@%a",convert_type(dtype), num);
         }else{
             app_instr(dst,"PUSHS %s@%s",convert_type(dtype), token);
         }
     }else{
-        fprintf(stderr,"Code generation: Error not supported yet\n");
+        dst->int_error = true; //Not supported type of value
     }
 
 }
 
+#define PUSHS_PREFIX_LEN (sizeof("PUSHS float@") - 1)
+
+void generate_num_push(prog_t *dst, sym_dtype_t dtype, num_value_t value){
+    //Prefix + the longest hex float (e.g. 0x1.fffffffffffffp+1023) or the longest integer fits to it
+    char instr[PUSHS_PREFIX_LEN + 32];
+    size_t length;
+
+    if(dtype == NUM){
+        double num = value.number;
+        if(isinf(num)) { //Prevent inf (warning is printed by precedence parser)
+            num = DBL_MAX;
+        }
+
+        length = PUSHS_PREFIX_LEN;
+        memcpy(instr, "PUSHS float@", length);
+        length += write_hex_float(&instr[length], num);
+    }else if(dtype == INT){
+        length = sizeof("PUSHS int@") - 1;
+        memcpy(instr, "PUSHS int@", length);
+        length += write_int(&instr[length], value.integer);
+    }else{
+        dst->int_error = true; //Only numeric literals have parsed value
+        return;
+    }
+
+    app_instr_raw(dst, instr, length);
+}
+
 /**
  * *--------CONDIONS--------
  */ 
-void generate_if_condition(prog_t *dst, size_t n){
-    app_instr(dst,"#if %i",n);
-    //convert other types to bool
-    generate_call_function(dst,"$BUILTIN$tobool");
+/**
+ * @brief Jumps to label (prefix$f_name$n) if condition is not satisfied
+ */
+static void generate_cond_jump(prog_t *dst, cond_kind_t kind, const char *prefix, const char *f_name, size_t n){
+    if(kind == COND_EQ || kind == COND_NEQ){
+        //operands are compared directly by jump (as EQS, that is done by "==")
+        generate_call_function(dst,"$BUILTIN$sametypes");
+        app_instr(dst,"%s %s$%s$%i",kind == COND_EQ ? "JUMPIFNEQS" : "JUMPIFEQS",prefix,f_name,n);
+        return;
+    }
+
+    if(kind == COND_ANY){
+        //convert other types to bool
+        generate_call_function(dst,"$BUILTIN$tobool");
+    }
 
     app_instr(dst,"PUSHS bool@true");
-    app_instr(dst,"JUMPIFNEQS $ELSE$START$%i",n);
+    app_instr(dst,"JUMPIFNEQS %s$%s$%i",prefix,f_name,n);
 }
 
-void generate_if_end(prog_t *dst, size_t n){
+void generate_if_condition(prog_t *dst, const char *f_name, size_t n, cond_kind_t kind){
+    app_instr(dst,"#if %i",n);
+    generate_cond_jump(dst,kind,"$ELSE$START",f_name,n);
+}
+
+void generate_if_end(prog_t *dst, const char *f_name, size_t n){
     app_instr(dst,"#end of if %i",n);
-    app_instr(dst,"JUMP $ELSE$END$%i",n);
-    app_instr(dst,"LABEL $ELSE$START$%i",n);
+    app_instr(dst,"JUMP $ELSE$END$%s$%i",f_name,n);
+    app_instr(dst,"LABEL $ELSE$START$%s$%i",f_name,n);
 }
 
-void generate_else_end(prog_t *dst, size_t n){
+void generate_else_end(prog_t *dst, const char *f_name, size_t n){
     app_instr(dst,"#end of else and the whole if %i statement",n);
-    app_instr(dst,"LABEL $ELSE$END$%i",n);
+    app_instr(dst,"LABEL $ELSE$END$%s$%i",f_name,n);
 }
 
 /**
  * *LOOPS
  */ 
 
-void generate_while_condition_beginning(prog_t *dst, size_t n){
-    app_instr(dst,"#while %i, nest level %i",n,dst->cycle_nest_lvl);
-    app_instr(dst,"LABEL $WHILE$COND$%i",n);
-    if(dst->cycle_nest_lvl == 0){
-        instr_push(&dst->cycle_stack, get_last(dst));
-    }
-    dst->cycle_nest_lvl++;
+void generate_while_start(prog_t *dst, size_t n, size_t nest_lvl){
+    app_instr(dst,"#while %i, nest level %i",n,nest_lvl);
 }
 
-void generate_while_condition_evaluate(prog_t *dst, size_t n){
-    //convert other types to bool
-    generate_call_function(dst,"$BUILTIN$tobool");
-    
-    app_instr(dst,"PUSHS bool@true");
-    app_instr(dst,"JUMPIFNEQS $WHILE$END$%i",n);
+void generate_while_condition_beginning(prog_t *dst, const char *f_name, size_t n){
+    app_instr(dst,"LABEL $WHILE$COND$%s$%i",f_name,n);
 }
 
-void generate_while_end(prog_t *dst, size_t n){
-    app_instr(dst,"#end of while %i loop",n);
-    app_instr(dst,"JUMP $WHILE$COND$%i",n);
-    app_instr(dst,"LABEL $WHILE$END$%i",n);
-    dst->cycle_nest_lvl--;
+void generate_while_condition_evaluate(prog_t *dst, const char *f_name, size_t n, cond_kind_t kind){
+    generate_cond_jump(dst,kind,"$WHILE$END",f_name,n);
+}
 
-    if(!instr_is_empty(&dst->cycle_stack)) {
-        instr_pop(&dst->cycle_stack);
-    }
+void generate_while_end(prog_t *dst, const char *f_name, size_t n){
+    app_instr(dst,"#end of while %i loop",n);
+    app_instr(dst,"JUMP $WHILE$COND$%s$%i",f_name,n);
+    app_instr(dst,"LABEL $WHILE$END$%s$%i",f_name,n);
 }
 
 
@@ -1570,7 +1572,8 @@ string_t get_unique_name( void *sym_stack,symtab_t *symtab , token_t *var_id, sc
     //search it in the table
     tree_node_t *name_element = deep_search(sym_stack, symtab, name);
     if(name_element == NULL){
-        exit(INTERNAL_ERROR);
+        string_t not_found = {.length = 0, .alloc_size = 0, .str = NULL};
+        return not_found;
     }
     
     string_t name_unique = name_element->data.name;
@@ -1588,44 +1591,155 @@ bool is_prefix_of(char * prefix, char * str){
     return true;
 }
 
-void to_ascii(const char * str, string_t * out){
-    char c ='\0';
-    bool escape_sequence = c;
-    for (size_t i = 1; i < strlen(str)-1; i++)
-    {
-        bool escape_sequence_previous = false;
-        c = str[i];
-        if(c == ' '){
-            app_str(out,"\\032");
-        }else if(escape_sequence){
-                escape_sequence_previous = true;
-                escape_sequence = false;
-            switch (c)
-            {
+/**
+ * @brief Writes escape sequence \ddd with code of given character
+ * @return Pointer behind written sequence
+ */ 
+char *write_escape(char *dst, unsigned char c) {
+    dst[0] = '\\';
+    dst[1] = '0' + c / 100;
+    dst[2] = '0' + (c / 10) % 10;
+    dst[3] = '0' + c % 10;
+
+    return dst + 4;
+}
+
+
+int to_ascii(const char * str, string_t * out){
+    size_t length = strlen(str);
+    if(length < 2) { //There must be at least quotes
+        return STR_SUCCESS;
+    }
+
+    const char *end = &str[length - 1]; //Without closing quote
+
+    //Every character is written as 4 characters at most, so there is no need to check space
+    if(str_reserve(out, out->length + (length - 2) * 4) != STR_SUCCESS) {
+        return STR_FAILURE;
+    }
+
+    char *w = &to_str(out)[out->length];
+    for(const char *r = &str[1]; r < end; r++) {
+        unsigned char c = *r;
+        if(c == '\\' && r + 1 < end) { //Escape sequences of Teal
+            r++;
+            switch(*r) {
             case 'n':
-                app_str(out,"010");
+                c = '\n';
+                break;
+            case 't':
+                c = '\t';
                 break;
             case '"':
-                app_str(out,"034");
+                c = '"';
                 break;
             case '\\':
-                app_str(out,"092");
-                break;
-            case 't':
-                app_str(out,"009");
-                break;
-            default:
-                app_char(c,out);    
+                c = '\\';
                 break;
+            default: 
+                if(isdigit((unsigned char)*r)) { //\ddd has same format in IFJcode21
+                    *w++ = '\\';
+                    for(size_t i = 0; i < 3 && r < end && isdigit((unsigned char)*r); i++) {
+                        *w++ = *r++;
+                    }
+                }
+                else { //Invalid escape sequence (scanner does not allow it), backslash is taken as normal character
+                    w = write_escape(w, '\\');
+                }
+
+                r--;
+                continue;
             }
-        }else{
-            app_char(c,out);
+
+            w = write_escape(w, c);
+        }
+        else if(c <= ' ' || c == '#' || c == '\\') { //Characters, that can't be in IFJcode21 string directly
+            w = write_escape(w, c);
+        }
+        else {
+            *w++ = c;
         }
-        if(!escape_sequence_previous && c == 92)
-            escape_sequence = true;
     }
+
+    out->length = w - to_str(out);
+    *w = '\0';
+
+    return STR_SUCCESS;
 }
 
+size_t write_int(char *dst, long long value) {
+    char digits[24];
+    size_t n = 0, length = 0;
+
+    unsigned long long abs_value = value < 0 ? -(unsigned long long)value : (unsigned long long)value;
+    do { //Digits are got in reversed order
+        digits[n++] = '0' + abs_value % 10;
+        abs_value /= 10;
+    } while(abs_value > 0);
+
+    if(value < 0) {
+        dst[length++] = '-';
+    }
+
+    while(n > 0) {
+        dst[length++] = digits[--n];
+    }
+
+    dst[length] = '\0';
+
+    return length;
+}
+
+
+#define MANTISSA_BITS 52
+#define EXP_BIAS 1023
+
+size_t write_hex_float(char *dst, double value) {
+    static const char hex[] = "0123456789abcdef";
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    size_t length = 0;
+    if(bits >> 63) {
+        dst[length++] = '-';
+    }
+
+    uint64_t mantissa = bits & ((1ull << MANTISSA_BITS) - 1);
+    int exp = (int)((bits >> MANTISSA_BITS) & 0x7ff);
+
+    if(exp == 0x7ff) { //Special values (same output as printf has)
+        strcpy(&dst[length], mantissa ? "nan" : "inf");
+        return length + 3;
+    }
+
+    dst[length++] = '0';
+    dst[length++] = 'x';
+    if(exp == 0) { //Zero and subnormal numbers have implicit 0 before point
+        dst[length++] = '0';
+        exp = (mantissa == 0) ? 0 : 1 - EXP_BIAS;
+    }
+    else {
+        dst[length++] = '1';
+        exp -= EXP_BIAS;
+    }
+
+    if(mantissa != 0) { //Fraction part without trailing zeros
+        dst[length++] = '.';
+        for(int shift = MANTISSA_BITS - 4; mantissa != 0; shift -= 4) {
+            dst[length++] = hex[(mantissa >> shift) & 0xf];
+            mantissa &= ((uint64_t)1 << shift) - 1;
+        }
+    }
+
+    dst[length++] = 'p';
+    dst[length++] = exp < 0 ? '-' : '+';
+    length += write_int(&dst[length], exp < 0 ? -exp : exp);
+
+    return length;
+}
+
+
 const char *convert_type(sym_dtype_t dtype){
     switch (dtype)
     {
@@ -25,6 +25,9 @@
 #include <stdarg.h>
 #include <errno.h>
 #include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
 #include "symtable.h"
 #include "scanner.h"
 
@@ -45,7 +48,24 @@ typedef struct instruction {
 } instr_t;
 
 
-DSTACK_DECL(instr_t *, instr)
+#define INSTR_CHUNK_SIZE 32768 /**< Default size of data of one chunk of instruction pool (in bytes) */
+
+/**
+ * @brief Block of memory, from which instructions and their text are allocated
+ * @note Data of chunk are right after this structure
+ */
+typedef struct instr_chunk {
+    struct instr_chunk *next; /**< Chunk, that was used before this one */
+    size_t size; /**< Size of data of chunk */
+    size_t used; /**< Number of already allocated bytes of data */
+} instr_chunk_t;
+
+/**
+ * @brief Pool of memory for instructions (they are not freed one by one, but all at once with pool)
+ */
+typedef struct instr_pool {
+    instr_chunk_t *chunks; /**< Chunk, that is currently used for allocation (older chunks are linked behind it) */
+} instr_pool_t;
 
 /**
  * @brief Double linked list that represents target program 
@@ -54,12 +74,21 @@ DSTACK_DECL(instr_t *, instr)
 typedef struct program {
     instr_t *first_instr; /**< First instruction of program (DLL) */
     instr_t *last_instr;  /**< Last instruction of program (DLL) */
-    size_t cycle_nest_lvl;   //number of whiles we are currently in
-    instr_stack_t cycle_stack; //pointer to the while which is first in the current scope
+    bool int_error; /**< Flag that signalizes internal error (e.g. allocation error) during generating */
+    instr_pool_t *pool; /**< Memory of instructions (it is created with the first instruction) */
 } prog_t;
 
 DSTACK_DECL(prog_t, prog)
 
+/**
+ * @brief Code rendered at build time, that is put to program without copying (@see app_instr_static())
+ */
+typedef struct prelude_blob {
+    const char *name; /**< Name of builtin function */
+    const char *text; /**< Instructions separated by '\n' (terminated by '\0') */
+    size_t len;
+} prelude_blob_t;
+
 /**
  * @brief stores pair of function name and pointer to function which should be generated in order to use it in the target code
  */
@@ -69,25 +98,6 @@ typedef struct funtions_array {
 } function_name_t;
 
 
-/**
- * @brief Creates new empty intruction
- * @return Pointer to newly created instruction or null if an error occured
- */ 
-instr_t *new_instruction();
-
-/**
- * @brief Sets content of instruction (uses dynamic string @see dstring.h)
- * @return EXIT_SUCCESS, if everything was OK (otherwise INTERNAL_ERROR)
- */ 
-int set_instruction(instr_t *instr, const char *const _Format, va_list args);
-
-
-/**
- * @brief Correctly frees all resources held by intruction
- */ 
-void instr_dtor(instr_t *instr);
-
-
 /**
  * @brief Inits new program structure
  * @param program Pointer to program that will be initialized
@@ -98,6 +108,8 @@ void init_new_prog(prog_t *program);
 /**
  * @brief Frees all resources held by given program structure
  * @note After calling it, program will have same state as it has after initialization
+ * @note Instructions are released all at once with pool of program (including instructions of appended programs)
+ * @note If arena is used (@see arena.h), pool stays in arena and only the program structure is cleared
  * @param program Pointer to program that will be deleted
  */ 
 void program_dtor(prog_t *program);
@@ -135,40 +147,39 @@ instr_t *get_prev(instr_t *instr);
  */ 
 void app_instr(prog_t *dst, const char *const _Format, ...);
 
+/**
+ * @brief Appends new instruction with given content (it is copied without any formatting)
+ */ 
+void app_instr_raw(prog_t *dst, const char *content, size_t length);
+
+/**
+ * @brief Puts static text (e.g. pre-rendered code) to the end of program as one instruction
+ * @note Text is not copied, so it must be valid until program is destroyed
+ */
+void app_instr_static(prog_t *dst, const char *text, size_t length);
+
 /**
  * @brief Appends program (instruction sequence) to another program
+ * @note If appended program has its own pool, the pool is moved to destination program
  * @warning Appended program cannot be destroyed! (something can be double freed)
  */ 
 void app_prog(prog_t *dst, prog_t *prog);
 
 /**
- * @brief Inserts new instruction after given instruction
- * @note It's variadic function, so it can be used as standard printf
- * @warning If given pointer to instruction in argument is NULL it does nothing
+ * @brief Removes all instructions after given instruction
+ * @note Their memory is released together with pool of program
  */ 
-void ins_after(prog_t *dst, instr_t *instr, const char *const _Format, ...);
-
-
-/**
- * @brief Inserts new instruction before given instruction
- * @note It's variadic function, so it can be used as standard printf
- * @warning If given pointer to instruction in argument is NULL it does nothing
- */
-void ins_before(prog_t *dst, instr_t *instr, const char *const _Format, ...);
-
+void cut_program(prog_t *dst, instr_t *last);
 
 /**
- * @brief Reverts instructions in given interval (including borders)
- * @note Interval is given by to pointers to instructions, use 
- *       get_next/get_prev to make reversion only inside this interval
- * @warning If an error occured during the reversing, it does nothing
+ * @brief Prints program to standard output and adds '\n' after every instruction 
  */
-void revert(prog_t *dst, instr_t *from, instr_t *to);
+void print_program(prog_t *source);
 
 /**
- * @brief Prints program to standard output and adds '\n' after every instruction 
+ * @brief Prints program to given stream and adds '\n' after every instruction 
  */
-void print_program(prog_t *source);
+void fprint_program(FILE *dst, prog_t *source);
 
 
 
@@ -178,14 +189,36 @@ void print_program(prog_t *source);
 
 /**
  * @brief inicializes the code
+ * @note Header and helper functions are rendered at build time (@see mkprelude.c), so they are spliced 
+ *       to program as one static instruction (it is defined in prelude.c)
  */ 
 void generate_init(prog_t *dst);
 
 /**
  * @brief generates builtin functions if they are in symtab
+ * @note Code of builtin functions is rendered at build time as well as code from generate_init()
  */ 
 int generate_builtin(prog_t *dst, symtab_t *symtab);
 
+/**
+ * @brief Returns hash, that identifies generated code (keys of cached code are salted by it)
+ * @note It is derived from version of compiler and from hash of all sources of compiler computed by make
+ *       (build_salt.h), so it changes with every change of them
+ */ 
+uint64_t codegen_salt();
+
+/**
+ * @brief Generates header of program and helper functions, that are needed by every program
+ * @note It is used only at build time by mkprelude to render static prelude (@see generate_init())
+ */ 
+void render_prelude(prog_t *dst);
+
+/**
+ * @brief Finds function, that generates code of builtin function with given name
+ * @return Pointer to static pair of name and generating function or NULL if there is no such builtin function
+ */ 
+const function_name_t *get_builtin_by_name(char *name);
+
 /**
  * *---------FUNCTIONS---------
  */ 
@@ -196,13 +229,6 @@ int generate_builtin(prog_t *dst, symtab_t *symtab);
  */ 
 void generate_start_function(prog_t *dst,const char * name);
 
-/**
- * @brief generates parameters of a function
- * @note they are declared reversely because they're popped from stack
- * @param param_names TYPE: tok_stack_t - the stack of tokens with parameter names
- */ 
-void generate_parameters(prog_t *dst, void *sym_stack,symtab_t *symtab , void *param_names, scanner_t * scanner);
-
 /**
  * @brief generates one parameter
  * @param name of the parameter
@@ -246,10 +272,10 @@ void generate_reverse_stack(prog_t *dst, size_t n_values);
 
 /**
  * @brief declares a variable
- * @param var_id identifier of the variable
- * @note we will search the actual unique identifier in the symtab
+ * @param name unique name of the variable
+ * @note variables declared in loops are declared before the outermost loop (@see codegen.c)
  */ 
-void generate_declare_variable( prog_t *dst,void *sym_stack,symtab_t *symtab , token_t *var_id, scanner_t * scanner);
+void generate_declare_variable(prog_t *dst, const char *name);
 
 /**
  * @brief assigns variables from stack to variables
@@ -271,25 +297,56 @@ void generate_assign_value(prog_t *dst,const char * name);
  */ 
 void generate_value_push( prog_t *dst,sym_type_t type, sym_dtype_t dtype, const char * name );
 
+/**
+ * @brief pushes numeric literal to the stack
+ * @param value value of literal parsed by scanner (it is not converted from text again)
+ * @note used in expression parsing, out of range numbers are pushed as DBL_MAX
+ */ 
+void generate_num_push(prog_t *dst, sym_dtype_t dtype, num_value_t value);
+
 
 /**
  * *--------CONDIONS--------
+ * @note Labels contain name of function and number of statement in that function (it is numbered from zero in every function)
  */ 
-void generate_if_condition(prog_t *dst,size_t n);
 
-void generate_if_end(prog_t *dst,size_t n);
+/**
+ * @brief Kind of condition of if statement or while loop (it determines what is on the stack before jump)
+ */
+typedef enum cond_kind {
+    COND_ANY, /**< Value of any type (it is converted to bool by $BUILTIN$tobool) */
+    COND_BOOL, /**< Bool or nil (nil is not equal to true, so it does not need conversion) */
+    COND_EQ, /**< Both operands of "==" (comparison is fused with jump) */
+    COND_NEQ, /**< Both operands of "~=" (comparison is fused with jump) */
+} cond_kind_t;
+
+/**
+ * @brief Jumps to else branch if condition (of given kind) on the top of the stack is not satisfied
+ */
+void generate_if_condition(prog_t *dst, const char *f_name, size_t n, cond_kind_t kind);
+
+void generate_if_end(prog_t *dst, const char *f_name, size_t n);
 
-void generate_else_end(prog_t *dst, size_t n);
+void generate_else_end(prog_t *dst, const char *f_name, size_t n);
 
 
 /**
  * *--------LOOPS--------
  */ 
-void generate_while_condition_beginning(prog_t *dst,size_t n);
 
-void generate_while_condition_evaluate(prog_t *dst,size_t n);
+/**
+ * @brief generates comment before the loop (declarations from the loop body can follow it)
+ */ 
+void generate_while_start(prog_t *dst, size_t n, size_t nest_lvl);
 
-void generate_while_end(prog_t *dst,size_t n);
+void generate_while_condition_beginning(prog_t *dst, const char *f_name, size_t n);
+
+/**
+ * @brief Jumps after the loop if condition (of given kind) on the top of the stack is not satisfied
+ */
+void generate_while_condition_evaluate(prog_t *dst, const char *f_name, size_t n, cond_kind_t kind);
+
+void generate_while_end(prog_t *dst, const char *f_name, size_t n);
 
 
 /**
@@ -448,6 +505,7 @@ void generate_clears(prog_t *dst_code);
 /**
  * @brief gets the unique identifier from symtable
  * @param var_id the token which we're going to search
+ * @return Name of variable in target code (str attribute is NULL if variable was not found)
  */ 
 string_t get_unique_name( void *sym_stack,symtab_t *symtab , token_t *var_id, scanner_t * scanner );
 
@@ -466,10 +524,26 @@ const char *convert_type(sym_dtype_t dtype);
 
 /**
  * @brief converts string from token format ie. "this is a string" to "this\032is\032string"
+ * @note Whitespaces, control characters, '#' and '\' are written as escape sequences \ddd (in one pass)
  * @param str the input string
- * @param out pointer to the output string
+ * @param out pointer to the output string (result is appended to it)
+ * @return STR_SUCCESS or STR_FAILURE if allocation failed
+ */ 
+int to_ascii(const char * str, string_t * out);
+
+/**
+ * @brief Writes integer in decimal format to dst (terminated by '\0')
+ * @note dst must have space for at least 21 characters
+ * @return Number of written characters (without '\0')
+ */ 
+size_t write_int(char *dst, long long value);
+
+/**
+ * @brief Writes double in hexadecimal format to dst (the same output as printf("%a") has, terminated by '\0')
+ * @note dst must have space for at least 25 characters
+ * @return Number of written characters (without '\0')
  */ 
-void to_ascii(const char * str, string_t * out);
+size_t write_hex_float(char *dst, double value);
 
 
 
@@ -20,25 +20,189 @@
 
 #include "parser_topdown.h"
 #include "scanner.h"
+#include "batch.h"
+#include "compiler.h"
+#include "cache.h"
 
+#include <string.h>
 
-int main() {
-    scanner_t scanner;
-    if(scanner_init(&scanner) != EXIT_SUCCESS) {
-        return INTERNAL_ERROR;
+
+/**
+ * @brief Prints usage of compiler to stderr
+ */
+void print_usage(const char *exe) {
+    fprintf(stderr, "Usage: %s [options] < source.tl > result.code\n", exe);
+    fprintf(stderr, "       %s [-j workers] [--cache dir] source.tl ...\n", exe);
+    fprintf(stderr, "In the second (batch) mode files are compiled concurrently ");
+    fprintf(stderr, "and for every source.tl is created source.code\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  --dump-tokens file  Dumps token stream of source to file\n");
+    fprintf(stderr, "  --load-tokens file  Uses token stream from file instead of scanning source\n");
+    fprintf(stderr, "                      (if it is stale, source is scanned)\n");
+    fprintf(stderr, "  --cache dir         Takes results from cache in given directory (or stores them there)\n");
+    fprintf(stderr, "  --cache-size MB     Size limit of cache (default is %d MB)\n", CACHE_DEFAULT_SIZE / (1024 * 1024));
+    fprintf(stderr, "  --incremental file  Compiles only functions changed since previous compilation\n");
+    fprintf(stderr, "                      (code of others is taken from sidecar file, that is updated)\n");
+    fprintf(stderr, "  --memory mode       Management of memory: heap (default), arena (released at once)\n");
+    fprintf(stderr, "                      or exit (arena, that is not released before exit of compiler)\n");
+    fprintf(stderr, "  --codegen-jobs n    Number of threads generating code of functions (default is 1, 0 means\n");
+    fprintf(stderr, "                      number of processors), it is ignored in incremental mode\n");
+    fprintf(stderr, "  -O0, -O1, -O2       Level of optimizations of functions (default is -O0, -O1 propagates\n");
+    fprintf(stderr, "                      constants and copies and removes dead code, -O2 also reuses computed values)\n");
+}
+
+
+/**
+ * @brief Command line arguments
+ */
+typedef struct args {
+    compile_opts_t opts;
+    unsigned workers; /**< Number of workers in batch mode (0 means number of processors) */
+    char **paths; /**< Source files (batch mode) */
+    int path_num;
+} args_t;
+
+
+/**
+ * @brief Processes command line arguments
+ * @return False if arguments are not valid
+ */
+bool parse_args(int argc, char **argv, args_t *args) {
+    compile_opts_init(&args->opts);
+    args->workers = 0;
+
+    int i = 1;
+    for(; i < argc && argv[i][0] == '-'; i++) {
+        if(strcmp(argv[i], "-O0") == 0 || strcmp(argv[i], "-O1") == 0 || strcmp(argv[i], "-O2") == 0) {
+            args->opts.opt_level = (opt_level_t)(argv[i][2] - '0'); //Level of optimizations has no value
+            continue;
+        }
+
+        if(i + 1 >= argc) { //Other options have value
+            return false;
+        }
+
+        const char *opt = argv[i++], *value = argv[i];
+
+        if(strcmp(opt, "-j") == 0) {
+            char *end = NULL;
+            long n = strtol(value, &end, 10);
+            if(*end != '\0' || n < 0) {
+                return false;
+            }
+
+            args->workers = (unsigned)n;
+        }
+        else if(strcmp(opt, "--codegen-jobs") == 0) {
+            char *end = NULL;
+            long n = strtol(value, &end, 10);
+            if(*end != '\0' || n < 0) {
+                return false;
+            }
+
+            args->opts.codegen_workers = (unsigned)n;
+        }
+        else if(strcmp(opt, "--dump-tokens") == 0) {
+            args->opts.dump_tokens = value;
+        }
+        else if(strcmp(opt, "--load-tokens") == 0) {
+            args->opts.load_tokens = value;
+        }
+        else if(strcmp(opt, "--incremental") == 0) {
+            args->opts.incremental = value;
+        }
+        else if(strcmp(opt, "--memory") == 0) {
+            if(strcmp(value, "heap") == 0) {
+                args->opts.memory = MEM_HEAP;
+            }
+            else if(strcmp(value, "arena") == 0) {
+                args->opts.memory = MEM_ARENA;
+            }
+            else if(strcmp(value, "exit") == 0) {
+                args->opts.memory = MEM_EXIT;
+            }
+            else {
+                return false;
+            }
+        }
+        else if(strcmp(opt, "--cache") == 0) {
+            args->opts.cache_dir = value;
+        }
+        else if(strcmp(opt, "--cache-size") == 0) {
+            char *end = NULL;
+            long mb = strtol(value, &end, 10);
+            if(*end != '\0' || mb <= 0) {
+                return false;
+            }
+
+            args->opts.cache_max_size = (size_t)mb * 1024 * 1024;
+        }
+        else {
+            return false;
+        }
     }
 
-    parser_t parser;
-    if(parser_setup(&parser, &scanner) != EXIT_SUCCESS) {
+    args->paths = &argv[i];
+    args->path_num = argc - i;
+
+    bool has_tok_opts = args->opts.dump_tokens || args->opts.load_tokens || args->opts.incremental;
+    if(args->path_num > 0 && has_tok_opts) { //Token stream (and sidecar) belongs to one source
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Compiles source code from stdin and prints result to stdout
+ */
+int stdin_mode(compile_opts_t *opts) {
+    char *src = NULL;
+    size_t src_len;
+    if(read_stream(stdin, &src, &src_len) != EXIT_SUCCESS) {
         return INTERNAL_ERROR;
     }
 
-    int return_value = parse_program(&parser);
+    int return_value;
+    if(opts->cache_dir) { //Whole result is needed for cache
+        compile_result_t res;
+        return_value = compile_buffer(src, src_len, opts, &res);
+        fwrite(res.code, sizeof(char), res.code_len, stdout);
+        fwrite(res.diag, sizeof(char), res.diag_len, stderr);
+        if(opts->memory != MEM_EXIT) {
+            compile_result_dtor(&res);
+        }
+    }
+    else {
+        return_value = compile_stream(src, src_len, opts, stdout, stderr);
+    }
+
+    if(opts->memory != MEM_EXIT) { //Process ends right after compilation, so memory is left to the system
+        free(src);
+    }
 
-    scanner_dtor(&scanner);
-    
     return return_value;
 }
 
 
+int main(int argc, char **argv) {
+    args_t args;
+    if(!parse_args(argc, argv, &args)) {
+        print_usage(argv[0]);
+        return INTERNAL_ERROR;
+    }
+
+    if(args.path_num > 0) {
+        if(args.opts.memory == MEM_EXIT) { //Memory of every file must be released, there can be many of them
+            args.opts.memory = MEM_ARENA;
+        }
+
+        return batch_compile(args.paths, args.path_num, args.workers, &args.opts, stderr, NULL);
+    }
+
+    return stdin_mode(&args.opts);
+}
+
+
 /**************************       End of main.c      *************************/
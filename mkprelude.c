@@ -0,0 +1,105 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                mkprelude.c
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *  Purpose: Build tool, that renders helper and builtin functions of target
+ *                      code to C header with static blobs
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file mkprelude.c
+ * @brief Build tool, that renders helper and builtin functions of target code to C header with static blobs
+ * @note Usage: ./mkprelude > prelude_blobs.h (header is included only by prelude.c)
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#include "generator.h"
+#include "symtable.h"
+
+#define BYTES_PER_LINE 16
+
+
+/**
+ * @brief Prints byte of blob (as part of array initializer)
+ */
+static void print_byte(unsigned char c, size_t *cnt) {
+    printf("%s0x%02x,", (*cnt)++ % BYTES_PER_LINE == 0 ? "\n    " : "", c);
+}
+
+
+/**
+ * @brief Prints code of program as static array of characters (instructions are separated by '\n')
+ * @note Array is not written as string literal, because it can be longer than C99 compilers must support
+ */
+static void print_blob(const char *id, prog_t *prog) {
+    printf("static const char %s[] = {", id);
+
+    size_t cnt = 0;
+    for(instr_t *instr = prog->first_instr; instr; instr = get_next(instr)) {
+        for(const char *c = to_str(&instr->content); *c; c++) {
+            print_byte((unsigned char)*c, &cnt);
+        }
+
+        if(get_next(instr)) {
+            print_byte('\n', &cnt);
+        }
+    }
+
+    print_byte('\0', &cnt);
+    printf("\n};\n\n");
+}
+
+
+int main() {
+    printf("/* Generated by mkprelude (do not edit, it is rendered again by make) */\n\n");
+
+    prog_t prog;
+    init_new_prog(&prog);
+    render_prelude(&prog);
+    if(prog.int_error) {
+        return INTERNAL_ERROR;
+    }
+
+    print_blob("prelude_text", &prog);
+    program_dtor(&prog);
+
+    //Builtin functions are in the same order as in table of builtin functions
+    for(size_t i = 0; i < BUILTIN_TABLE_SIZE; i++) {
+        const function_name_t *func = get_builtin_by_name(to_str(&builtin_functions(i)->name));
+        if(!func) {
+            fprintf(stderr, "mkprelude: Missing generator of builtin function %s!\n", to_str(&builtin_functions(i)->name));
+            return INTERNAL_ERROR;
+        }
+
+        init_new_prog(&prog);
+        func->function_ptr(&prog);
+        if(prog.int_error) {
+            return INTERNAL_ERROR;
+        }
+
+        char id[MAX_CNT_LEN];
+        snprintf(id, MAX_CNT_LEN, "builtin_text_%lu", (unsigned long)i);
+        print_blob(id, &prog);
+        program_dtor(&prog);
+    }
+
+    printf("static const prelude_blob_t builtin_blobs[] = {\n");
+    for(size_t i = 0; i < BUILTIN_TABLE_SIZE; i++) {
+        printf("    {\"%s\", builtin_text_%lu, sizeof(builtin_text_%lu) - 1},\n",
+               to_str(&builtin_functions(i)->name), (unsigned long)i, (unsigned long)i);
+    }
+
+    printf("};\n");
+
+    return EXIT_SUCCESS;
+}
+
+
+/***                            End of mkprelude.c                         ***/
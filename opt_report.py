@@ -0,0 +1,82 @@
+#Report of effects of optimizations (-O1, -O2) on test cases
+#For every level prints number of instructions in generated code and number of executed instructions
+#Usage: python3 opt_report.py [compiler] [interpreter] (run it in root directory of repository after make)
+
+import os
+import subprocess
+import sys
+
+compiler = sys.argv[1] if len(sys.argv) > 1 else "./IFJ21"
+interpreter = sys.argv[2] if len(sys.argv) > 2 else "./ic21int"
+test_dir = "examples/test_cases"
+levels = ["-O0", "-O1", "-O2"]
+
+
+#Counts instructions of code (comments and empty lines are skipped)
+def static_count(code):
+    count = 0
+    for line in code.splitlines():
+        line = line.strip()
+        if line and not line.startswith("#") and not line.startswith(".IFJcode21"):
+            count += 1
+
+    return count
+
+
+#Runs code in interpreter and counts executed instructions (interpreter prints every one of them in verbose mode)
+def executed_count(code_path, input_path):
+    with open(input_path, "rb") as input_file:
+        try:
+            res = subprocess.run([interpreter, "-v", code_path], stdin=input_file, stdout=subprocess.DEVNULL,
+                                 stderr=subprocess.PIPE, timeout=60)
+        except subprocess.TimeoutExpired:
+            return None
+
+    return res.stderr.count(b"Executing instruction")
+
+
+totals = {level: [0, 0] for level in levels}
+print("%-24s" % "test case" + "".join("%12s%12s" % (level + " code", level + " exec") for level in levels))
+for test in sorted(os.listdir(test_dir)):
+    path = os.path.join(test_dir, test)
+    program_path = os.path.join(path, "program.tl")
+    if not os.path.isfile(program_path):
+        continue
+
+    row = []
+    for level in levels:
+        with open(program_path, "rb") as program:
+            res = subprocess.run([compiler, level], stdin=program, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+
+        if res.returncode != 0: #Programs with compile errors are skipped
+            row = None
+            break
+
+        code_path = "/tmp/opt_report%s.code" % level
+        with open(code_path, "wb") as code_file:
+            code_file.write(res.stdout)
+
+        executed = executed_count(code_path, os.path.join(path, "input"))
+        if executed is None:
+            row = None
+            break
+
+        row.append((static_count(res.stdout.decode("latin-1")), executed))
+
+    if row is None:
+        continue
+
+    for level, (static, executed) in zip(levels, row):
+        totals[level][0] += static
+        totals[level][1] += executed
+
+    print("%-24s" % test + "".join("%12d%12d" % counts for counts in row))
+
+
+print("%-24s" % "total" + "".join("%12d%12d" % tuple(totals[level]) for level in levels))
+for level in levels[1:]:
+    base_static, base_executed = totals[levels[0]]
+    static, executed = totals[level]
+    print("%s: %d instructions less in code (%.1f %%), %d instructions less executed (%.1f %%)" %
+          (level, base_static - static, 100.0 * (base_static - static) / max(base_static, 1),
+           base_executed - executed, 100.0 * (base_executed - executed) / max(base_executed, 1)))
@@ -25,42 +25,80 @@
 
 #define RULESET_GLOBAL_LENGTH 4 /**< Number of rules that can be used for parsing rules in global scopes */
 
-rule_t * get_global_rule(size_t index) {
+static const rule_t ruleset_global[RULESET_GLOBAL_LENGTH] = {
+    {parse_function_dec,        {KEYWORD, UNSET, 0, "global"},   true },
+    {parse_function_def,        {KEYWORD, UNSET, 0, "function"}, true },
+    {parse_global_identifier,   {IDENTIFIER, UNSET, 0, NULL},    false},
+    {EOF_global_rule,           {EOF_TYPE, UNSET, 0, NULL},      false},
+};
+
+const rule_t * get_global_rule(size_t index) {
     if(index >= RULESET_GLOBAL_LENGTH) { //Safety check
         return NULL;
     }
 
-    static rule_t ruleset_global[RULESET_GLOBAL_LENGTH] = {
-        {parse_function_dec,        {KEYWORD, UNSET, "global"},   true },
-        {parse_function_def,        {KEYWORD, UNSET, "function"}, true },
-        {parse_global_identifier,   {IDENTIFIER, UNSET, NULL},    false},
-        {EOF_global_rule,           {EOF_TYPE, UNSET, NULL},      false},
+    return &ruleset_global[index];
+}
+
+
+const rule_dispatch_t * get_global_dispatch() {
+    //Must correspond with ruleset_global
+    static const rule_dispatch_t dispatch_global = {
+        .by_type = {
+            [IDENTIFIER] = &ruleset_global[2],
+            [EOF_TYPE] = &ruleset_global[3],
+        },
+        .by_keyword = {
+            [KW_GLOBAL] = &ruleset_global[0],
+            [KW_FUNCTION] = &ruleset_global[1],
+        },
     };
 
-    return &ruleset_global[index];
+    return &dispatch_global;
 }
 
 
 
 #define RULESET_INSIDE_LENGTH 8 /**< Number of rules that can be used for parsing rules in local scopes */
 
-rule_t * get_inside_rule(size_t index) {
+static const rule_t ruleset_inside[RULESET_INSIDE_LENGTH] = {
+    {parse_local_var,   {KEYWORD, UNSET, 0, "local"},  true  },
+    {parse_if,          {KEYWORD, UNSET, 0, "if"},     true  },
+    {parse_else,        {KEYWORD, UNSET, 0, "else"},   true  },
+    {parse_while,       {KEYWORD, UNSET, 0, "while"},  true  },
+    {parse_return,      {KEYWORD, UNSET, 0, "return"}, true  },
+    {parse_end,         {KEYWORD, UNSET, 0, "end"},    true  },
+    {parse_identifier,  {IDENTIFIER, UNSET, 0, NULL},  false },
+    {EOF_fun_rule,      {EOF_TYPE, UNSET, 0, NULL},    false },
+};
+
+const rule_t * get_inside_rule(size_t index) {
     if(index >= RULESET_INSIDE_LENGTH) { //Safety check
         return NULL;
     }
 
-    static rule_t ruleset_inside[RULESET_INSIDE_LENGTH] = {
-        {parse_local_var,   {KEYWORD, UNSET, "local"},  true  },
-        {parse_if,          {KEYWORD, UNSET, "if"},     true  },
-        {parse_else,        {KEYWORD, UNSET, "else"},   true  },
-        {parse_while,       {KEYWORD, UNSET, "while"},  true  },
-        {parse_return,      {KEYWORD, UNSET, "return"}, true  },
-        {parse_end,         {KEYWORD, UNSET, "end"},    true  },
-        {parse_identifier,  {IDENTIFIER, UNSET, NULL},  false },
-        {EOF_fun_rule,      {EOF_TYPE, UNSET, NULL},    false },
+    return &ruleset_inside[index];
+}
+
+
+const rule_dispatch_t * get_inside_dispatch() {
+    //Must correspond with ruleset_inside
+    static const rule_dispatch_t dispatch_inside = {
+        .by_type = {
+            [IDENTIFIER] = &ruleset_inside[6],
+            [EOF_TYPE] = &ruleset_inside[7],
+        },
+        .by_keyword = {
+            [KW_LOCAL] = &ruleset_inside[0],
+            [KW_IF] = &ruleset_inside[1],
+            [KW_ELSE] = &ruleset_inside[2],
+            [KW_WHILE] = &ruleset_inside[3],
+            [KW_RETURN] = &ruleset_inside[4],
+            [KW_END] = &ruleset_inside[5],
+        },
     };
 
-    return &ruleset_inside[index];
+    return &dispatch_inside;
 }
 
 
@@ -87,8 +125,49 @@ bool is_global_ctx(parser_t *parser) {
     return symtabs_is_empty(&(parser->sym.symtab_st));
 }
 
+
+bool is_codegen_deferred(parser_t *parser) {
+    return parser->codegen_workers != 1 && !parser->fcache;
+}
+
+
+void append_node(parser_t *parser, ast_node_t *node) {
+    *parser->ast_tail = node;
+    parser->ast_tail = &node->next;
+}
+
+
+/**
+ * @brief Returns static data type of condition (only the first value of expression is used)
+ */
+static sym_dtype_t cond_type(string_t *dtypes) {
+    return char_to_dtype(len(dtypes) > 0 ? to_str(dtypes)[0] : '\0');
+}
+
+
+/**
+ * @brief Creates node of variable with unique name (name in target code) of given identifier
+ */
+static ast_node_t *var_node(parser_t *parser, token_t *var_id) {
+    string_t unique_name = get_unique_name(&parser->sym.symtab_st, &parser->sym.symtab, var_id, parser->scanner);
+    if(to_str(&unique_name) == NULL) {
+        return NULL;
+    }
+
+    ast_node_t *var = ast_node(&parser->ast, AST_VAR);
+    if(!var || !(var->u.name = ast_str(&parser->ast, to_str(&unique_name)))) {
+        return NULL;
+    }
+
+    return var;
+}
+
 int parser_setup(parser_t *parser, scanner_t *scanner) {
     parser->scanner = scanner;
+    parser->out = stdout;
+    parser->fcache = NULL;
+    parser->codegen_workers = 1;
+    parser->opt_level = OPT_NONE;
 
     //Initialization of symbol tables
     symtab_t global_tab;
@@ -106,6 +185,12 @@ int parser_setup(parser_t *parser, scanner_t *scanner) {
 
     parser->reached_EOF = false;
     parser->found_return = false;
+    parser->curr_func_id = NULL;
+
+    parser->first_err = PARSE_SUCCESS;
+    parser->err_cnt = 0;
+    parser->err_reported = false;
+    parser->block_depth = 0;
 
     parser->return_code = PARSE_SUCCESS;
 
@@ -114,11 +199,14 @@ int parser_setup(parser_t *parser, scanner_t *scanner) {
     init_new_prog(&dst_code);
     parser->dst_code = dst_code;
 
+    ast_init(&parser->ast);
+    parser->ast_tail = &parser->ast.first;
+
     if(!symtabs_stack_init(&parser->sym.symtab_st) ||
        !tok_stack_init(&parser->decl_func) ||
-       !instr_stack_init(&parser->dst_code.cycle_stack)) {
+       !tok_stack_init(&parser->id_names)) {
 
-        int_error("Error during parser initialization!");
+        int_error(parser, "Error during parser initialization!");
         return INTERNAL_ERROR;
     }
 
@@ -127,6 +215,12 @@ int parser_setup(parser_t *parser, scanner_t *scanner) {
 
 
 void parser_dtor(parser_t *parser) {
+    ast_dtor(&parser->ast); //Tree has its own arena (code was already generated from it)
+
+    if(arena_active()) { //Symbol tables and stacks are released together with arena
+        return;
+    }
+
     destroy_tab(&parser->sym.symtab);
     destroy_tab(&parser->sym.global);
 
@@ -137,7 +231,7 @@ void parser_dtor(parser_t *parser) {
 
     symtabs_stack_dtor(&(parser->sym.symtab_st));
     tok_stack_dtor(&(parser->decl_func));
-    instr_stack_dtor(&parser->dst_code.cycle_stack);
+    tok_stack_dtor(&(parser->id_names));
 }
 
 
@@ -189,24 +283,36 @@ int parse_program(parser_t *parser) {
     
     //Run parsing
     res = (res == PARSE_SUCCESS) ?  global_statement_list(parser) : res;
+    if(parser->err_cnt > 0) { //Parser recovered from errors, result is code of the first one
+        res = parser->first_err;
+    }
 
     debug_print("Finished! return code: %i, at: (%lu, %lu)\n", res, parser->scanner->cursor_pos[ROW], parser->scanner->cursor_pos[COL]);
 
     res = (res == PARSE_SUCCESS) ? check_if_defined(parser) : res;
+
+    if(res == PARSE_SUCCESS && is_codegen_deferred(parser)) { //Functions are generated concurrently
+        codegen_parallel(&parser->dst_code, &parser->ast, parser->codegen_workers, parser->opt_level);
+    }
     
     //check which builtin functions are called
     generate_builtin(&parser->dst_code,&parser->sym.global);
 
+    if((parser->dst_code.int_error || parser->ast.int_error) && res == PARSE_SUCCESS) {
+        int_error(parser, "Error during code generation!");
+        res = INTERNAL_ERROR;
+    }
+
     parser_dtor(parser);
 
-    if(parser->return_code != 0) {
+    if(parser->return_code != 0 && parser->err_cnt == 0) {
         res = parser->return_code;
     }
 
 
     //Print generated code
-    if(res == PARSE_SUCCESS && parser->return_code == PARSE_SUCCESS) {
-        print_program(&parser->dst_code);
+    if(res == PARSE_SUCCESS && parser->return_code == PARSE_SUCCESS && parser->err_cnt == 0) {
+        fprint_program(parser->out, &parser->dst_code);
     }
 
     program_dtor(&parser->dst_code);
@@ -218,43 +324,156 @@ int parse_program(parser_t *parser) {
 
 //<global-statement-list> -> <global-statement> <global-statement-list>
 int global_statement_list(parser_t *parser) {
-    int ret = PARSE_SUCCESS;
-    ret = global_statement(parser);
-    if(ret != PARSE_SUCCESS)
-        return ret;
+    //The rule is right recursive, but it is parsed in loop to keep the depth of the C stack independent of program length
+    while(true) {
+        scanner_reclaim(parser->scanner); //Attributes of tokens from previous statement are not needed anymore
 
-    if(parser->reached_EOF)
-        return PARSE_SUCCESS;
+        int ret = global_statement(parser);
+        if(ret != PARSE_SUCCESS && !recover_global(parser, ret))
+            return ret;
 
-    return global_statement_list(parser);
+        if(parser->reached_EOF)
+            return PARSE_SUCCESS;
+    }
 }
 
 
 //<statement-list>        -> <statement> <statement-list>
 int statement_list(parser_t *parser) {
-    int ret = statement(parser);
+    size_t base_depth = parser->block_depth;
 
-    if(ret != PARSE_SUCCESS) {
-        return ret;
-    }
+    //Parsed in loop (as global statement list), recursion is used only for nested blocks
+    while(true) {
+        scanner_reclaim(parser->scanner);
 
-    token_t t = lookahead(parser->scanner);
-    if(is_error_token(&t, &ret)) {
-        return ret;
-    }
+        int ret = statement(parser);
 
-    if(compare_token(t, KEYWORD)) {
-        if(compare_token_attr(parser, t, KEYWORD, "end")) {
+        if(ret != PARSE_SUCCESS && !recover_inside(parser, ret, base_depth)) {
+            return ret;
+        }
+
+        token_t t = lookahead(parser->scanner);
+        if(is_error_token(&t, &ret) && !recover_inside(parser, ret, base_depth)) {
+            return ret;
+        }
+
+        t = lookahead(parser->scanner);
+        if(compare_keyword(t, KW_END)) {
             debug_print("got end\n");
             return PARSE_SUCCESS;
         }
-        else if(compare_token_attr(parser, t, KEYWORD, "else")) {
+        else if(compare_keyword(t, KW_ELSE)) {
             debug_print("got else\n");
             return PARSE_SUCCESS;
         }
     }
+}
+
+
+void report_error(parser_t *parser, int err_code) {
+    if(parser->err_cnt == 0) {
+        //Lexical errors found by lookahead are saved in return_code and they were before error, that is reported
+        parser->first_err = (parser->return_code != PARSE_SUCCESS) ? parser->return_code : err_code;
+    }
+
+    parser->err_cnt++;
+}
+
+
+bool can_recover(parser_t *parser, int err_code) {
+    return err_code != INTERNAL_ERROR && parser->err_cnt < MAX_ERRORS;
+}
+
+
+int skip_to_sync(parser_t *parser, size_t depth, bool inside) {
+    while(true) {
+        token_t t = lookahead(parser->scanner);
+        if(t.token_type == INT_ERR_TYPE) {
+            return INTERNAL_ERROR;
+        }
+        else if(t.token_type == EOF_TYPE) {
+            parser->reached_EOF = true;
+            return PARSE_SUCCESS;
+        }
+        else if(compare_keyword(t, KW_FUNCTION) || compare_keyword(t, KW_GLOBAL)) {
+            return PARSE_SUCCESS;
+        }
+        else if(depth == 0 && inside && (compare_keyword(t, KW_LOCAL) || 
+                compare_keyword(t, KW_END) || compare_keyword(t, KW_ELSE) ||
+                compare_keyword(t, KW_IF) || compare_keyword(t, KW_WHILE) || 
+                compare_keyword(t, KW_RETURN))) {
+            return PARSE_SUCCESS; //Beginning of the next statement (or end of current block)
+        }
+
+        get_next_token(parser->scanner); //Token is skipped (lexical errors were already printed by scanner)
+        if(compare_keyword(t, KW_IF) || compare_keyword(t, KW_WHILE)) {
+            depth++;
+        }
+        else if(compare_keyword(t, KW_END)) {
+            if(depth == 0) { //End of function, where error ocurred
+                return PARSE_SUCCESS;
+            }
+
+            depth--;
+        }
+    }
+}
+
+
+bool recover_inside(parser_t *parser, int err_code, size_t base_depth) {
+    if(parser->err_reported) { //Error from nested block, that must be propagated to global scope
+        return false;
+    }
+
+    report_error(parser, err_code);
+    parser->err_reported = true;
+    if(!can_recover(parser, err_code)) {
+        return false;
+    }
+
+    //Blocks opened by erroneous statement must be skipped with their 'end'
+    size_t depth = parser->block_depth - base_depth;
+    if(skip_to_sync(parser, depth, true) != PARSE_SUCCESS) {
+        report_error(parser, INTERNAL_ERROR);
+        return false;
+    }
+
+    token_t t = lookahead(parser->scanner);
+    if(parser->reached_EOF || compare_keyword(t, KW_FUNCTION) || compare_keyword(t, KW_GLOBAL)) {
+        return false; //Synchronization is possible only in global scope
+    }
+
+    parser->err_reported = false;
+    parser->block_depth = base_depth;
+
+    return true;
+}
+
+
+bool recover_global(parser_t *parser, int err_code) {
+    if(!parser->err_reported) {
+        report_error(parser, err_code);
+    }
+
+    parser->err_reported = false;
+    if(!can_recover(parser, err_code) || parser->reached_EOF) {
+        return false;
+    }
 
-    return statement_list(parser);
+    //Parser is back in global scope (nothing from function, where error ocurred, is valid)
+    while(!is_global_ctx(parser)) {
+        to_outer_ctx(parser);
+    }
+
+    parser->curr_func_id = NULL;
+    parser->block_depth = 0;
+
+    if(skip_to_sync(parser, 0, false) != PARSE_SUCCESS) {
+        report_error(parser, INTERNAL_ERROR);
+        return false;
+    }
+
+    return true;
 }
 
 
@@ -267,7 +486,7 @@ int global_statement(parser_t *parser) {
     }
 
     //Get the apropriate rule
-    rule_t* rule_to_use = determine_rule(parser, t, get_global_rule);
+    const rule_t* rule_to_use = determine_rule(parser, t, get_global_dispatch());
     if(rule_to_use == NULL) {
         return SYNTAX_ERROR;
     }
@@ -292,7 +511,7 @@ int statement(parser_t *parser) {
     }
 
     //get the apropriate rule
-    rule_t* rule_to_use = determine_rule(parser, t, get_inside_rule);
+    const rule_t* rule_to_use = determine_rule(parser, t, get_inside_dispatch());
     if(rule_to_use == NULL) {
         return SYNTAX_ERROR;
     }
@@ -312,7 +531,7 @@ bool is_convertable(sym_dtype_t var_type, sym_dtype_t r_side_type) {
 }
 
 
-bool is_valid_assign(prog_t *dst_code, sym_dtype_t var_type, sym_dtype_t r_side_type) {
+bool is_valid_assign(sym_dtype_t var_type, sym_dtype_t r_side_type) {
     if(var_type == r_side_type || r_side_type == NIL) { //Types are same or rvalue type is nil
         return true;
     }
@@ -402,24 +621,13 @@ int assignment_lside(parser_t *parser, token_t* start_id,
 }
 
 
-void prog_stack_deep_dtor(prog_stack_t *prog) {
-    while(!prog_is_empty(prog)) {
-        prog_t cur = prog_pop(prog);
-        program_dtor(&cur);
-    }
-
-    prog_stack_dtor(prog);
-}
-
-
 int assignment_expr(size_t *cnt, parser_t *parser, 
                     string_t *id_types, string_t *rside,
-                    bool *was_f_called, prog_stack_t *expr_progs) {
+                    bool *was_f_called, ast_node_t *assign) {
        
     size_t id_number = len(id_types);
 
-    prog_t cur_expr;
-    init_new_prog(&cur_expr); //Pointers are stored in program stack, so dont care about leaks
+    ast_node_t *expr;
 
     string_t ret_types;
     if(str_init(&ret_types) != STR_SUCCESS) {
@@ -429,18 +637,17 @@ int assignment_expr(size_t *cnt, parser_t *parser,
     //check for valid expression
     debug_print("Calling precedence parser...\n");
 
-    int expr_retval = parse_expression(parser->scanner, &parser->sym, &ret_types, was_f_called, &cur_expr);
+    int expr_retval = parse_expression(parser->scanner, &parser->sym, &ret_types, was_f_called, &parser->ast, &expr);
     debug_print("RET_TYPES: %s\n", to_str(&ret_types));
     debug_print("%d %d\n", *cnt, id_number);
     size_t u = 0;
     if(expr_retval == EXPRESSION_SUCCESS && *cnt < id_number) {
         for(; to_str(&ret_types)[u] != '\0' && u + *cnt < id_number; u++) { //If there is only function, it can return more than one values
             sym_dtype_t cur_dtype = char_to_dtype(to_str(&ret_types)[u]);
-            sym_dtype_t should_be = char_to_dtype(id_types->str[*cnt + u]);
+            sym_dtype_t should_be = char_to_dtype(to_str(id_types)[*cnt + u]);
             
-            if(!is_valid_assign(&cur_expr, should_be, cur_dtype)) { //Type checking in (multiple) assignment
+            if(!is_valid_assign(should_be, cur_dtype)) { //Type checking in (multiple) assignment
                 str_dtor(&ret_types);
-                program_dtor(&cur_expr);
 
                 if(!(*was_f_called)) {
                     error_semantic(parser, "Type of variable is not compatible with rvalue of assignment!");
@@ -454,14 +661,17 @@ int assignment_expr(size_t *cnt, parser_t *parser,
             else {
                 if(app_char(to_str(&ret_types)[u], rside) != STR_SUCCESS) {
                     str_dtor(&ret_types);
-                    program_dtor(&cur_expr);
                     return INTERNAL_ERROR;
                 }
                 //Assignment is ok
             }
 
             if(lookahead_token_attr(parser, SEPARATOR, ",")) { //If there is, after function call, only first return value is used
-                generate_dump_values(&cur_expr, 1, len(&ret_types) - 1);
+                if(!ast_dump(&parser->ast, &expr, 1, len(&ret_types) - 1)) {
+                    str_dtor(&ret_types);
+                    return INTERNAL_ERROR;
+                }
+
                 u = 1;
                 break;
             }
@@ -469,23 +679,18 @@ int assignment_expr(size_t *cnt, parser_t *parser,
 
 
         if(u < len(&ret_types) && !lookahead_token_attr(parser, SEPARATOR, ",")) { //Discard values that won't be used from stack
-            generate_dump_values(&cur_expr, u, len(&ret_types) - u);
+            if(!ast_dump(&parser->ast, &expr, u, len(&ret_types) - u)) {
+                str_dtor(&ret_types);
+                return INTERNAL_ERROR;
+            }
         }
 
-
-        if(!prog_push(expr_progs, cur_expr)) { //Saving expression code to stack
-            str_dtor(&ret_types);
-            return INTERNAL_ERROR;
-        }
+        ast_append(&assign->b, expr); //Values are evaluated from right to left (@see codegen.c)
 
         *cnt += u; //Increment rside value counter by return type amount
     }
-    else if(expr_retval == EXPRESSION_SUCCESS) {
-        program_dtor(&cur_expr);
-    }
-    else {
+    else if(expr_retval != EXPRESSION_SUCCESS) {
         debug_print("Error while parsing expression for multiple assignment\n");
-        program_dtor(&cur_expr);
         str_dtor(&ret_types);
         return expr_retval;
     }
@@ -496,40 +701,31 @@ int assignment_expr(size_t *cnt, parser_t *parser,
 
 
 
-int assignment_rside(parser_t *parser, string_t *id_types, string_t *rside) {
+int assignment_rside(parser_t *parser, string_t *id_types, string_t *rside, ast_node_t *assign) {
     size_t id_number = len(id_types); //Number of values is length of string with datatypes characters
     bool f_call = false;
 
-    prog_stack_t expr_progs;
-    if(!prog_stack_init(&expr_progs)) {
-        return INTERNAL_ERROR;
-    }
-
     size_t i = 0;
     int ret = EXPRESSION_SUCCESS;
     bool found_end = false;
     while(!found_end) {
         token_t t = lookahead(parser->scanner);
         if(is_error_token(&t, &ret)) {
-            prog_stack_deep_dtor(&expr_progs);
             return ret;
         }
 
         if(!is_expression(parser, t)) {
-            prog_stack_deep_dtor(&expr_progs);
             error_semantic(parser, "Missing rvalue in assignment (expected expression)!");
             return SEMANTIC_ERROR_ASSIGNMENT;
         }
 
-        ret = assignment_expr(&i, parser, id_types, rside, &f_call, &expr_progs);
+        ret = assignment_expr(&i, parser, id_types, rside, &f_call, assign);
         if(ret != PARSE_SUCCESS) {
-            prog_stack_deep_dtor(&expr_progs);
             return ret;
         }
 
         t = lookahead(parser->scanner);
         if(is_error_token(&t, &ret)) {
-            prog_stack_deep_dtor(&expr_progs);
             return ret;
         }
 
@@ -540,8 +736,6 @@ int assignment_rside(parser_t *parser, string_t *id_types, string_t *rside) {
         else {
             found_end = true;
             if(i < id_number) {
-                prog_stack_deep_dtor(&expr_progs);
-
                 if(f_call) {
                     error_semantic(parser, "Function in assignment doesn't return enough values!");
                     return SEMANTIC_ERROR_PARAMETERS;
@@ -554,13 +748,6 @@ int assignment_rside(parser_t *parser, string_t *id_types, string_t *rside) {
         }
     }
 
-    while(!prog_is_empty(&expr_progs)) { //Apends expression to main program (to evaluate it from right to left)
-        prog_t cur = prog_pop(&expr_progs);
-        app_prog(&parser->dst_code, &cur);
-    }
-    
-    prog_stack_deep_dtor(&expr_progs);
-
     return PARSE_SUCCESS;
 }
 
@@ -577,13 +764,10 @@ int assignment(parser_t *parser, token_t t) {
     }
 
     //Push names to the stack in lside
-    tok_stack_t var_names;
-    if(!tok_stack_init(&var_names)) {
-        str_dtor(&id_types);
-        return INTERNAL_ERROR;
-    }
+    tok_stack_t *var_names = &parser->id_names;
+    tok_clear(var_names);
 
-    int retval = assignment_lside(parser, &var_id, &id_types, &var_names);
+    int retval = assignment_lside(parser, &var_id, &id_types, var_names);
 
     debug_print("found %i assignment with types %s ...\n", len(&id_types), to_str(&id_types));
     
@@ -593,32 +777,42 @@ int assignment(parser_t *parser, token_t t) {
         return INTERNAL_ERROR;
     }
 
-    retval = (retval == PARSE_SUCCESS) ? assignment_rside(parser, &id_types, &rside_types) : retval;
-    
-    //Generate assignment of the values on stack
-    if(!tok_revert(&var_names)) {
+    ast_node_t *assign = ast_node(&parser->ast, AST_ASSIGN);
+    if(!assign) {
         retval = INTERNAL_ERROR;
     }
 
+    retval = (retval == PARSE_SUCCESS) ? assignment_rside(parser, &id_types, &rside_types, assign) : retval;
+    
+    //Variables are assigned from the stack in the same order as they are in lside
+    tok_revert(var_names); //Stack is reverted in place
+
     size_t cnt = 0;
-    while(!tok_is_empty(&var_names)) {
-        token_t name_token = tok_pop(&var_names);
-        string_t name_unique = get_unique_name(&parser->sym.symtab_st, &parser->sym.symtab, &name_token, parser->scanner);
+    ast_node_t **target = &assign->a;
+    while(retval == PARSE_SUCCESS && !tok_is_empty(var_names)) {
+        token_t name_token = tok_pop(var_names);
+        ast_node_t *var = var_node(parser, &name_token);
+        if(!var) {
+            retval = INTERNAL_ERROR;
+            break;
+        }
 
         if(is_convertable(char_to_dtype(to_str(&id_types)[cnt]), char_to_dtype(to_str(&rside_types)[cnt]))) {
-            impl_int2num(&parser->dst_code);
+            var->flags |= AST_CONVERT;
         }
 
         cnt++;
 
-        generate_assign_value(&parser->dst_code, name_unique.str);
+        *target = var;
+        target = &var->next;
     }
 
-    //generate_multiple_assignment(&parser->dst_code, &parser->sym.symtab_st, &parser->sym.symtab, &var_names, parser->scanner);
+    if(retval == PARSE_SUCCESS) {
+        append_node(parser, assign);
+    }
 
     str_dtor(&rside_types);
     str_dtor(&id_types);
-    tok_stack_dtor(&var_names);
 
     return retval;
 }
@@ -676,18 +870,18 @@ void ins_var(parser_t *parser, token_t *id_token,
 
     char *orig_name = get_attr(id_token, parser->scanner);
 
-    //Making unique name for target code
+    char conv_buff[DECLARATION_COUNTER_MAX_LEN];
+    snprintf(conv_buff, DECLARATION_COUNTER_MAX_LEN, "%ld", parser->decl_cnt);
+
+    //Making unique name for target code (its length is known, so it is allocated at once)
     string_t var_name;
-    str_init(&var_name);
+    str_init_cap(&var_name, cur_f_len + strlen(orig_name) + strlen(conv_buff) + 2);
 
     str_cpy_tostring(&var_name, f_name, cur_f_len); //'name_of_current_function'
     app_char('$', &var_name); //'name_of_current_function'$
     app_str(&var_name, orig_name); //'name_of_current_function'$'name_of_variable_in_ifj21'
     app_char('$', &var_name); //'name_of_current_function'$'name_of_variable_in_ifj21'$
 
-    char conv_buff[DECLARATION_COUNTER_MAX_LEN];
-    snprintf(conv_buff, DECLARATION_COUNTER_MAX_LEN, "%ld", parser->decl_cnt);
-
     app_str(&var_name, conv_buff);
     
     sym_data_t symdata_var = {.name = var_name, .type = VAR, 
@@ -715,7 +909,7 @@ void set_use_flag(tree_node_t *symbol, bool new_s) {
 
 //<value-assignment>
 int local_var_assignment(parser_t *parser, sym_status_t *status, 
-                         sym_dtype_t dtype, token_t *var_id) {
+                         sym_dtype_t dtype, token_t *var_id, ast_node_t *local) {
 
     if(lookahead_token_attr(parser, OPERATOR, "=")) {
         //Delete it temporarly, because it is hiding same name variables in outer scope (they can be used in initialization)
@@ -730,7 +924,7 @@ int local_var_assignment(parser_t *parser, sym_status_t *status,
         string_t ret_types;
         str_init(&ret_types);
         bool was_f_called;
-        int return_val = parse_expression(parser->scanner, &parser->sym, &ret_types, &was_f_called, &parser->dst_code);
+        int return_val = parse_expression(parser->scanner, &parser->sym, &ret_types, &was_f_called, &parser->ast, &local->a);
         if(return_val != EXPRESSION_SUCCESS) { //Check of return code of parsing expression
             str_dtor(&ret_types);
             return return_val;
@@ -739,7 +933,7 @@ int local_var_assignment(parser_t *parser, sym_status_t *status,
             *status = DEFINED; //Ok
         }
 
-        if(!is_valid_assign(&parser->dst_code, dtype, prim_dtype(&ret_types))) { //Check of data type compatibility in initialization
+        if(!is_valid_assign(dtype, prim_dtype(&ret_types))) { //Check of data type compatibility in initialization
             error_semantic(parser, "Incompatible data types in initialization of variable '\033[1;33m%s\033[0m'\n", id_char);
             str_dtor(&ret_types);
             return SEMANTIC_ERROR_ASSIGNMENT;
@@ -747,11 +941,7 @@ int local_var_assignment(parser_t *parser, sym_status_t *status,
 
         str_dtor(&ret_types);
 
-        ins_var(parser, var_id, *status, dtype); //After initialization, it must be inserted to the symtable again
-
-        //Generate assigment code
-        char * unique_name = get_unique_name(&parser->sym.symtab_st, &parser->sym.symtab, var_id, parser->scanner).str;
-        generate_assign_value(&parser->dst_code,unique_name);
+        ins_var(parser, var_id, *status, dtype); //After initialization, it must be inserted to the symtable again (with the same unique name)
     }
 
     return PARSE_SUCCESS;
@@ -827,12 +1017,18 @@ int parse_local_var(parser_t *parser) {
         return SEMANTIC_ERROR_DEFINITION;
     }
 
-    //Insert to symtab and generate code
+    //Insert to symtab and to the tree
     ins_var(parser, &var_id, status, var_type);
-    generate_declare_variable(&parser->dst_code, &parser->sym.symtab_st, &parser->sym.symtab, &var_id, parser->scanner);
+    ast_node_t *local = var_node(parser, &var_id);
+    if(!local) {
+        return INTERNAL_ERROR;
+    }
+
+    local->kind = AST_LOCAL;
+    append_node(parser, local);
 
     //There can be a value assignment
-    retval = (retval == PARSE_SUCCESS) ? local_var_assignment(parser, &status, var_type, &var_id) : retval;
+    retval = (retval == PARSE_SUCCESS) ? local_var_assignment(parser, &status, var_type, &var_id, local) : retval;
     
     //Incrementation of declaration counter to declare unique var names in target code
     if(!safe_increment(&parser->decl_cnt)) {
@@ -1069,6 +1265,7 @@ int check_if_declared(parser_t *parser, bool *was_decl, tree_node_t *symbol,
                       token_t *id_tok, sym_data_t *sym_data) {
 
     char *f_name = get_attr(id_tok, parser->scanner);
+    init_data(sym_data); //Data are initialized even in case of error, so they can be always freed by data_dtor()
     if(symbol) {
         *was_decl = true;
 
@@ -1077,7 +1274,6 @@ int check_if_declared(parser_t *parser, bool *was_decl, tree_node_t *symbol,
             return SEMANTIC_ERROR_DEFINITION;
         }
         else { //Function was declared but not defined
-            init_data(sym_data);
             cpy_strings(&sym_data->name, &symbol->data.name, false);
             cpy_strings(&sym_data->params, &symbol->data.params, false);
             cpy_strings(&sym_data->ret_types, &symbol->data.ret_types, false);
@@ -1085,7 +1281,6 @@ int check_if_declared(parser_t *parser, bool *was_decl, tree_node_t *symbol,
     }
     else {
         //Function was not declared nor defined
-        init_data(sym_data);
         str_cpy_tostring(&sym_data->name, f_name, strlen(f_name));
         *was_decl = false;
     }
@@ -1135,8 +1330,8 @@ int func_def_params(parser_t *p, token_t *id_token,
         return retval;
     }
 
-    tok_stack_t param_names;
-    tok_stack_init(&param_names);
+    tok_stack_t *param_names = &p->id_names;
+    tok_clear(param_names);
 
     if(t.token_type == IDENTIFIER) {
         debug_print("parsing function parameters...\n");
@@ -1146,12 +1341,11 @@ int func_def_params(parser_t *p, token_t *id_token,
             token_t param_id;
             int prolog_ret = func_def_params_prolog(p, &param_id);
             if(prolog_ret != PARSE_SUCCESS) {
-                tok_stack_dtor(&param_names);
                 return prolog_ret;
             }
 
             //Push it to param_names for code generation
-            tok_push(&param_names,param_id);
+            tok_push(param_names,param_id);
 
             //Should be DATATYPE
             t = get_next_token(p->scanner);
@@ -1161,7 +1355,6 @@ int func_def_params(parser_t *p, token_t *id_token,
 
             if(!is_datatype(p, t)) {
                 error_unexpected_token(p, "DATA TYPE", t);
-                tok_stack_dtor(&param_names);
                 return SYNTAX_ERROR;
             }
             else {
@@ -1175,15 +1368,13 @@ int func_def_params(parser_t *p, token_t *id_token,
                         error_semantic(p, "Parameter AMOUNT mismatch in definition of \033[1;33m%s\033[0m (there are to many of them)!", 
                                        get_attr(id_token, p->scanner));
 
-                        tok_stack_dtor(&param_names);
-                        return SEMANTIC_ERROR_DEFINITION;
+                                return SEMANTIC_ERROR_DEFINITION;
                     }
                     else if(dtype != keyword_to_dtype(&t, p->scanner)) { //There is data type mismatch
                         error_semantic(p, "Parameter DATA TYPE mismatch in definition of \033[1;33m%s\033[0m!", 
                                        get_attr(id_token, p->scanner));
 
-                        tok_stack_dtor(&param_names);
-                        return SEMANTIC_ERROR_DEFINITION;
+                                return SEMANTIC_ERROR_DEFINITION;
                     }
                 }
                 else {
@@ -1213,8 +1404,7 @@ int func_def_params(parser_t *p, token_t *id_token,
                     error_semantic(p, "Parameter AMOUNT mismatch in definition of \033[1;33m%s\033[0m (missing parameters)!", 
                                    get_attr(id_token, p->scanner));
 
-                    tok_stack_dtor(&param_names);
-                    return SEMANTIC_ERROR_DEFINITION;
+                        return SEMANTIC_ERROR_DEFINITION;
                 }
 
             }
@@ -1228,14 +1418,20 @@ int func_def_params(parser_t *p, token_t *id_token,
         error_semantic(p, "Return values AMOUNT mismatch in definition of function \033[1;33m%s\033[0m (missing parameters)!", 
                        get_attr(id_token, p->scanner));
 
-        tok_stack_dtor(&param_names);
         return SEMANTIC_ERROR_DEFINITION;
     }
 
-    //generate code for parameters
-    generate_parameters(&p->dst_code,&(p->sym.symtab_st), &p->sym.symtab, &param_names, p->scanner);
+    //Parameters are popped from the stack in target code, so they are defined in reversed order
+    while(!tok_is_empty(param_names)) {
+        token_t name_token = tok_pop(param_names);
+        ast_node_t *param = var_node(p, &name_token);
+        if(!param) {
+            return INTERNAL_ERROR;
+        }
+
+        append_node(p, param);
+    }
 
-    tok_stack_dtor(&param_names);
     return PARSE_SUCCESS;
 }
 
@@ -1347,15 +1543,6 @@ int func_def_epilogue(parser_t *parser) {
         return retval;
     }
 
-    //Generate function end
-    char *cur_func_name = get_attr(parser->curr_func_id, parser->scanner);
-    
-    //Generate implicit nil returns at the end and generate end
-    tree_node_t *symbol = search(&parser->sym.global, cur_func_name);
-    size_t ret_cnt = len(&symbol->data.ret_types);
-    generate_additional_returns(&parser->dst_code, ret_cnt);
-    generate_end_function(&parser->dst_code, cur_func_name);
-
     debug_print("parsing function finished! at: (%lu,%lu)\n", parser->scanner->cursor_pos[ROW], parser->scanner->cursor_pos[COL]); 
 
     if(t.token_type == KEYWORD) { //There must be end keyword
@@ -1385,7 +1572,12 @@ int check_return(parser_t *parser, tree_node_t *symbol) {
 }
 
  
-int parse_function_def(parser_t *parser) {
+/**
+ * @brief Parses function definition
+ * @param cached Function in cache of incremental compilation (NULL if it is not used), if it was found there, body is not parsed
+ * @param code_start The last instruction before code of function
+ */
+static int function_definition(parser_t *parser, fcache_func_t *cached, instr_t *code_start) {
     //This token is just 'function' so we skip it
     get_next_token(parser->scanner);
 
@@ -1405,8 +1597,19 @@ int parse_function_def(parser_t *parser) {
         return SEMANTIC_ERROR_DEFINITION;
     }
 
-    //Generate function start
-    generate_start_function(&parser->dst_code,f_name);
+    //Code of function is generated from its node after the whole definition is parsed (@see parse_function_def())
+    ast_node_t *func = ast_node(&parser->ast, AST_FUNCTION);
+    if(!func) {
+        return INTERNAL_ERROR;
+    }
+
+    append_node(parser, func);
+    parser->ast_tail = &func->a; //Parameters are appended to the function node
+
+    //Names and labels in target code are unique only inside function (they contain its name), so code of function doesn't depend on others
+    parser->decl_cnt = 0;
+    parser->cond_cnt = 0;
+    parser->loop_cnt = 0;
 
     parser->curr_func_id = &id_fc;
     parser->found_return = false;
@@ -1429,18 +1632,37 @@ int parse_function_def(parser_t *parser) {
 
     retval = (retval == PARSE_SUCCESS) ? func_def_returns(parser, &id_fc, was_declared, &func_d) : retval;
     
-    if(retval != PARSE_SUCCESS) { //Stop if an error ocurred
-        if(!was_declared) {
-            data_dtor(&func_d);
-        }
+    if(retval != PARSE_SUCCESS) { //Stop if an error ocurred (data are copies, so they must be freed even if function was declared)
+        data_dtor(&func_d);
 
         return retval;
     }
     
     ins_func(parser, &id_fc, &func_d);
 
+    //Identifier of function must outlive statements in its body (attribute buffer of scanner is reclaimed after them)
+    tree_node_t *func_symbol = search(&parser->sym.global, get_attr(&id_fc, parser->scanner));
+    if(!func_symbol) {
+        int_error(parser, "Function was not inserted to symbol table!");
+        return INTERNAL_ERROR;
+    }
+
+    id_fc.attr = func_symbol->key;
+    func->u.name = func_symbol->key;
+    func->n = len(&func_symbol->data.ret_types); //Implicit nils are returned at the end of function
+
+    if(cached && cached->entry) { //Function wasn't changed since previous compilation, so its code can be reused
+        to_outer_ctx(parser);
+        parser->curr_func_id = NULL;
+        func->flags |= AST_REUSED;
+
+        fcache_reuse(parser->fcache, cached, parser->scanner, &parser->sym.global, &parser->dst_code, code_start);
+        return PARSE_SUCCESS;
+    }
+
     //Parsing inside function
     debug_print("parsing inside function...\n");
+    parser->ast_tail = &func->b;
     retval = statement_list(parser);
     debug_print("parsing function finished! return code: %i, at: (%lu,%lu)\n", retval, parser->scanner->cursor_pos[ROW], parser->scanner->cursor_pos[COL]);
 
@@ -1456,6 +1678,41 @@ int parse_function_def(parser_t *parser) {
 }
 
 
+int parse_function_def(parser_t *parser) {
+    fcache_func_t cached;
+    bool is_cacheable = parser->fcache && 
+                        fcache_begin(parser->fcache, parser->scanner, &parser->sym.global, &cached);
+
+    instr_t *code_start = get_last(&parser->dst_code);
+    size_t warn_cnt = parser->scanner->warn_cnt;
+
+    ast_node_t **global_tail = parser->ast_tail;
+    int retval = function_definition(parser, is_cacheable ? &cached : NULL, code_start);
+
+    ast_node_t *func = *global_tail;
+    if(func) { //The next global statement is appended after the function (even if there was an error inside it)
+        parser->ast_tail = &func->next;
+    }
+
+    if(retval == PARSE_SUCCESS && !is_codegen_deferred(parser)) {
+        codegen_global(&parser->dst_code, func, parser->opt_level, &parser->ast);
+    }
+
+    if(is_cacheable) {
+        //Only functions without warnings are stored (warnings would not be printed if code was reused)
+        bool is_new = retval == PARSE_SUCCESS && !cached.entry && warn_cnt == parser->scanner->warn_cnt;
+        if(is_new && fcache_finish(parser->fcache, &cached, &parser->sym.global, &parser->dst_code, code_start) != EXIT_SUCCESS) {
+            int_error(parser, "Error during saving function to cache!");
+            retval = INTERNAL_ERROR;
+        }
+
+        fcache_func_dtor(&cached);
+    }
+
+    return retval;
+}
+
+
 //<statement>             -> [function-id](<argument-list>)
  //Function presumes that pointer to function symbol is not NULL!
 int parse_function_call(parser_t *parser, tree_node_t *func_sym) {
@@ -1463,27 +1720,31 @@ int parse_function_call(parser_t *parser, tree_node_t *func_sym) {
     bool opening_bracket = check_next_token_attr(parser, SEPARATOR, "(");
     
     if(opening_bracket) {
+        ast_node_t *call = ast_node(&parser->ast, AST_CALL);
+        if(!call) {
+            return INTERNAL_ERROR;
+        }
+
+        call->u.name = func_sym->key;
 
         //Parsing arguments should leave the arguments at the top of the stack 
-        int retval = parse_function_arguments(parser, func_sym);
+        int retval = parse_function_arguments(parser, func_sym, call);
         if(retval != PARSE_SUCCESS) {
             return retval;
         }
 
         debug_print("function args success %i\n", (int)retval);
 
-        //Find necessary data in symbol table
-        char *func_name = func_sym->key;
-
         char *params_str = to_str(&func_sym->data.params);
         bool is_variadic = (params_str[0] == '%') ? true : false;
 
-        //Generate function call unless variadic
-        if(!is_variadic) {
-            debug_print("function %s is not variadic", func_name);
-            generate_call_function(&parser->dst_code, func_name);
+        //Variadic function is called for each argument
+        if(is_variadic) {
+            call->flags |= AST_CALL_EACH;
         }
 
+        append_node(parser, call);
+
         //Update was_used
         set_use_flag(func_sym, true);
 
@@ -1496,7 +1757,7 @@ int parse_function_call(parser_t *parser, tree_node_t *func_sym) {
 
 
 //func_sym cannot be NULL!
-int parse_function_arguments(parser_t *parser, tree_node_t *func_sym) {
+int parse_function_arguments(parser_t *parser, tree_node_t *func_sym, ast_node_t *call) {
     bool closing_bracket = false;
 
     char *func_name = func_sym->key;
@@ -1517,8 +1778,9 @@ int parse_function_arguments(parser_t *parser, tree_node_t *func_sym) {
             string_t ret_types;
             str_init(&ret_types);
             bool was_f_called;
+            ast_node_t *arg;
             //There is expression in argument -> call precedence parser
-            int expr_retval = parse_expression(parser->scanner, &parser->sym, &ret_types, &was_f_called, &parser->dst_code);
+            int expr_retval = parse_expression(parser->scanner, &parser->sym, &ret_types, &was_f_called, &parser->ast, &arg);
             if(expr_retval != EXPRESSION_SUCCESS) {
                 str_dtor(&ret_types);
                 return expr_retval;
@@ -1527,7 +1789,7 @@ int parse_function_arguments(parser_t *parser, tree_node_t *func_sym) {
             if(!is_variadic) {
                 size_t u = 0;
                 while(argument_cnt < param_num && u < len(&ret_types)) {
-                    if(!is_compatible_in_arg(&parser->dst_code, params_str[argument_cnt], to_str(&ret_types)[u])) { //Type check of epxression and argument and declared type
+                    if(!is_compatible_in_arg(&parser->ast, &arg, params_str[argument_cnt], to_str(&ret_types)[u])) { //Type check of epxression and argument and declared type
                         error_semantic(parser, "Bad function call of \033[1;33m%s\033[0m! Bad data types of arguments!", func_name);    
                         str_dtor(&ret_types);
                         return SEMANTIC_ERROR_PARAMETERS;
@@ -1548,15 +1810,13 @@ int parse_function_arguments(parser_t *parser, tree_node_t *func_sym) {
                     argument_cnt += len(&ret_types) - u;  //Add difference to recognize too many arguments
                 }
 
-                if(u < len(&ret_types)) {
-                    generate_dump_values(&parser->dst_code, u, len(&ret_types) - u); //Remove return values that are not used in function call
+                if(u < len(&ret_types) && !ast_dump(&parser->ast, &arg, u, len(&ret_types) - u)) { //Remove return values that are not used in function call
+                    str_dtor(&ret_types);
+                    return INTERNAL_ERROR;
                 }
             }
-            else {
-                //If variadic call for each argument
-                generate_call_function(&parser->dst_code, func_name);
-            }
 
+            ast_append(&call->a, arg);
             str_dtor(&ret_types);
         }
         else if(compare_token_attr(parser, t, SEPARATOR, ")")) { //There is end of argument list
@@ -1619,14 +1879,17 @@ int parse_if(parser_t *parser) {
 
     //Go one token forward
     get_next_token(parser->scanner);
+    parser->block_depth++;
 
     debug_print("Calling precedence parser...\n");
 
     string_t ret_types;
     str_init(&ret_types);
     bool was_f_called;
+    ast_node_t *cond;
     //Parse expression in "if" condition
-    int expr_retval = parse_expression(parser->scanner, &parser->sym, &ret_types, &was_f_called,&parser->dst_code);
+    int expr_retval = parse_expression(parser->scanner, &parser->sym, &ret_types, &was_f_called, &parser->ast, &cond);
+    sym_dtype_t cond_dtype = cond_type(&ret_types);
     str_dtor(&ret_types);
     if(expr_retval != EXPRESSION_SUCCESS) {
         return expr_retval;
@@ -1636,8 +1899,17 @@ int parse_if(parser_t *parser) {
     if(!then) {
         return SYNTAX_ERROR;
     }
-    //Generate conditions and jumps 
-    generate_if_condition(&parser->dst_code,current_cond_cnt);
+
+    ast_node_t *if_node = ast_node(&parser->ast, AST_IF);
+    if(!if_node) {
+        return INTERNAL_ERROR;
+    }
+
+    if_node->a = cond;
+    if_node->n = current_cond_cnt; //Labels are numbered by the counter
+    if_node->m = cond_dtype;
+    append_node(parser, if_node);
+    parser->ast_tail = &if_node->b;
 
     to_inner_ctx(parser); //Switch the context
 
@@ -1657,15 +1929,14 @@ int parse_if(parser_t *parser) {
     }
 
     if(compare_token(t, KEYWORD)) {
-        //Generates end of if part statement
-        generate_if_end(&parser->dst_code, current_cond_cnt);
         if(compare_token_attr(parser, t, KEYWORD, "end")) {
             debug_print("Ended if\n");
-            //Generate end of the whole if - (else) statement
-            generate_else_end(&parser->dst_code, current_cond_cnt);
+            parser->block_depth--;
+            parser->ast_tail = &if_node->next;
             return PARSE_SUCCESS;
         }
         else if(compare_token_attr(parser, t, KEYWORD, "else")) {
+            parser->ast_tail = &if_node->u.c;
 
             to_inner_ctx(parser); //Switch the context
 
@@ -1683,8 +1954,8 @@ int parse_if(parser_t *parser) {
             to_outer_ctx(parser);
 
             t = get_next_token(parser->scanner);
-            //Generate end of the whole if - (else) statement
-            generate_else_end(&parser->dst_code, current_cond_cnt);
+            parser->block_depth--;
+            parser->ast_tail = &if_node->next;
             return PARSE_SUCCESS; //Back to higher level context
         }
 
@@ -1710,8 +1981,8 @@ int parse_return(parser_t *parser) {
     token_t* id_fc = parser->curr_func_id;
     tree_node_t *symbol = search(&parser->sym.global, get_attr(id_fc, parser->scanner));
     
-    prog_stack_t expr_progs;
-    if(!prog_stack_init(&expr_progs)) {
+    ast_node_t *ret = ast_node(&parser->ast, AST_RETURN);
+    if(!ret) {
         return INTERNAL_ERROR;
     }
 
@@ -1719,13 +1990,10 @@ int parse_return(parser_t *parser) {
     bool finished = false;
     //We need string of all data types that function should return
     char * returns_str = to_str(&symbol->data.ret_types);
-    prog_t cur_expr;
     int retval = EXPRESSION_SUCCESS;
     while(!finished) {
-        init_new_prog(&cur_expr);
         token_t t = lookahead(parser->scanner);
         if(is_error_token(&t, &retval)) {
-            prog_stack_deep_dtor(&expr_progs);
             return retval;
         }
 
@@ -1734,7 +2002,7 @@ int parse_return(parser_t *parser) {
             if(len(&symbol->data.ret_types) > 0) {
                 //Implicit nil return
                 size_t difference = len(&symbol->data.ret_types)  - returns_cnt;
-                generate_additional_returns(&parser->dst_code, difference);
+                ret->n += difference;
             }
 
             break;
@@ -1743,22 +2011,19 @@ int parse_return(parser_t *parser) {
             string_t ret_types;
             str_init(&ret_types);
             bool was_f_called;
+            ast_node_t *value;
             //There is expression in return statement -> call precedence parser
             debug_print("Calling precedence parser to parse return in %s...\n", get_attr(id_fc, parser->scanner));
 
-            int retval = parse_expression(parser->scanner, &parser->sym, &ret_types, &was_f_called, &cur_expr);
+            int retval = parse_expression(parser->scanner, &parser->sym, &ret_types, &was_f_called, &parser->ast, &value);
             if(retval != EXPRESSION_SUCCESS) {
                 str_dtor(&ret_types);
-                prog_stack_deep_dtor(&expr_progs);
-                program_dtor(&cur_expr);
                 return retval;
             }
             else {
                 sym_dtype_t dec_type = char_to_dtype(returns_str[returns_cnt]);
                 sym_dtype_t prim_dtype = char_to_dtype(to_str(&ret_types)[0]);
-                if(!is_valid_assign(&cur_expr, dec_type, prim_dtype)) { //Check compatibility of declared return type and got return type
-                    prog_stack_deep_dtor(&expr_progs);
-                    program_dtor(&cur_expr);
+                if(!is_valid_assign(dec_type, prim_dtype)) { //Check compatibility of declared return type and got return type
                     str_dtor(&ret_types);
 
                     if(was_f_called) { //There was only function call in return statement 
@@ -1772,20 +2037,13 @@ int parse_return(parser_t *parser) {
 
                     return SEMANTIC_ERROR_PARAMETERS;
                 }
-                else {
-                    if(is_convertable(dec_type, prim_dtype)) {
-                        impl_int2num(&cur_expr);
-                    }
-                    //Ok
+                else if(is_convertable(dec_type, prim_dtype) && !ast_int2num(&parser->ast, &value)) {
+                    str_dtor(&ret_types);
+                    return INTERNAL_ERROR;
                 }
             }
 
-            if(!prog_push(&expr_progs, cur_expr)) { //Saving expression code to stack
-                prog_stack_deep_dtor(&expr_progs);
-                str_dtor(&ret_types);
-                return INTERNAL_ERROR;
-            }
-
+            ast_append(&ret->a, value); //Values are evaluated from left to right
             str_dtor(&ret_types);
         }
 
@@ -1796,7 +2054,7 @@ int parse_return(parser_t *parser) {
             if(len(&symbol->data.ret_types) - 1 > returns_cnt) {
                 //Implicit nil return
                 size_t difference = (len(&symbol->data.ret_types) - 1) - returns_cnt;
-                generate_additional_returns(&parser->dst_code, difference);
+                ret->n += difference;
 
                 warn(parser, "Function '\033[1;33m%s\033[0m' returns %ld values but %ld specified were found. The rest of them is implicitly nil.", 
                      get_attr(id_fc, parser->scanner), 
@@ -1808,7 +2066,6 @@ int parse_return(parser_t *parser) {
             //We go one token forward
             get_next_token(parser->scanner);
             if(len(&symbol->data.ret_types) - 1 < returns_cnt + 1) {
-                prog_stack_deep_dtor(&expr_progs);
                 error_semantic(parser, "Function \033[1;33m%s\033[0m returns %d values but more return values were found!", 
                                get_attr(id_fc, parser->scanner), 
                                returns_cnt + 1, 
@@ -1823,20 +2080,7 @@ int parse_return(parser_t *parser) {
 
     parser->found_return = true;
 
-    if(!prog_revert(&expr_progs)) { //Reverse stack to evaluate expressions in return left to right
-        prog_stack_deep_dtor(&expr_progs);
-        return INTERNAL_ERROR;
-    }   
-
-    while(!prog_is_empty(&expr_progs)) { //Apends expression to main program (to evaluate it from right to left)
-        prog_t cur = prog_pop(&expr_progs);
-        app_prog(&parser->dst_code, &cur);
-    }
-
-    generate_reverse_stack(&parser->dst_code, returns_cnt);
-
-    generate_return(&parser->dst_code);
-    prog_stack_deep_dtor(&expr_progs);
+    append_node(parser, ret); //Implicit nils are pushed first, then values are reversed on stack (@see codegen.c)
     
     return PARSE_SUCCESS;
 }
@@ -1850,6 +2094,7 @@ int parse_end(parser_t *parser) {
 int parse_while(parser_t *parser) {
     //Go one token forward
     get_next_token(parser->scanner);
+    parser->block_depth++;
 
     //Save the counter to prevent overwriting in nested loops
     size_t current_cnt = parser->loop_cnt;
@@ -1857,15 +2102,14 @@ int parse_while(parser_t *parser) {
         return INTERNAL_ERROR;
     }
 
-    //Generate while beginning
-    generate_while_condition_beginning(&parser->dst_code, current_cnt);
-    
     debug_print("Calling precedence parser...\n");
 
     string_t ret_types;
     str_init(&ret_types);
     bool was_f_called;
-    int expr_retval = parse_expression(parser->scanner, &parser->sym, &ret_types, &was_f_called,&parser->dst_code);
+    ast_node_t *cond;
+    int expr_retval = parse_expression(parser->scanner, &parser->sym, &ret_types, &was_f_called, &parser->ast, &cond);
+    sym_dtype_t cond_dtype = cond_type(&ret_types);
     str_dtor(&ret_types);
     if(expr_retval != EXPRESSION_SUCCESS) { //Check the result of expression parsing
         return expr_retval;
@@ -1873,11 +2117,19 @@ int parse_while(parser_t *parser) {
 
     bool then = check_next_token_attr(parser, KEYWORD, "do");
     if(!then) {
-        return false;
+        return SYNTAX_ERROR;
+    }
+
+    ast_node_t *loop = ast_node(&parser->ast, AST_WHILE);
+    if(!loop) {
+        return INTERNAL_ERROR;
     }
 
-    //Generate additional condition check
-    generate_while_condition_evaluate(&parser->dst_code, current_cnt);
+    loop->a = cond;
+    loop->n = current_cnt;
+    loop->m = cond_dtype;
+    append_node(parser, loop);
+    parser->ast_tail = &loop->b;
 
     to_inner_ctx(parser); //Switch context
 
@@ -1896,8 +2148,8 @@ int parse_while(parser_t *parser) {
     if(compare_token(t, KEYWORD)) {
         if(compare_token_attr(parser, t, KEYWORD, "end")) {
 
-            //Generate end of while
-            generate_while_end(&parser->dst_code, current_cnt);
+            parser->block_depth--;
+            parser->ast_tail = &loop->next;
 
             debug_print("Ended while\n");
             return PARSE_SUCCESS;
@@ -1915,27 +2167,22 @@ int parse_while(parser_t *parser) {
 }
 
 
-rule_t *determine_rule(parser_t *p, token_t t, rule_t *(*ruleset_f)(size_t)) {
-    
-    // size_t rules_n = sizeof(ruleset) / sizeof(rule_t);
-    rule_t *rule = NULL;
-    for (size_t i = 0; (rule = ruleset_f(i)) != NULL; i++)
-    {
-        token_t to_be_checked = rule->rule_first;
-        if(rule->attrib_relevant) {
-            //The atribute is relevant (rules with same token types)
-            /** Here can be .attr because the value of token is certainly referenced by pointer */
-            if(compare_token_attr(p, t, to_be_checked.token_type, to_be_checked.attr)) {
-                return rule;
-            }
-        }
-        else {
-            //The atribute is irrelevant we check only for matching token type
-            if(compare_token(t, to_be_checked.token_type)) {
-                return rule;
-            }
+const rule_t *determine_rule(parser_t *p, token_t t, const rule_dispatch_t *dispatch) {
+    const rule_t *rule = NULL;
+    if(t.token_type == KEYWORD) {
+        //Rules starting with keyword are indexed by keyword id (attribute is relevant)
+        if(t.attr_id >= 0 && t.attr_id < KEYWORD_TABLE_SIZE) {
+            rule = dispatch->by_keyword[t.attr_id];
         }
     }
+    else if(t.token_type < TOK_TYPE_NUM) {
+        //The atribute is irrelevant, rule is chosen only by token type
+        rule = dispatch->by_type[t.token_type];
+    }
+
+    if(rule != NULL) {
+        return rule;
+    }
 
     error_unexpected_token(p, "NO RULE can be used to parse this token! Other", t);
     return NULL;
@@ -1972,7 +2219,13 @@ int parse_global_identifier(parser_t *parser) {
         return SEMANTIC_ERROR_DEFINITION;
     }
 
-    return parse_function_call(parser, func_valid);
+    ast_node_t **call = parser->ast_tail;
+    retval = parse_function_call(parser, func_valid);
+    if(retval == PARSE_SUCCESS && !is_codegen_deferred(parser)) {
+        codegen_global(&parser->dst_code, *call, parser->opt_level, &parser->ast);
+    }
+
+    return retval;
 }
 
 
@@ -2089,11 +2342,11 @@ int parse_datatype(parser_t *parser) {
 
 
 void error_unexpected_token(parser_t *parser, char * expected, token_t t) {
-    fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t|\033[0;31m Syntax error:\033[0m ", 
+    fprintf(parser->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t|\033[0;31m Syntax error:\033[0m ", 
             (parser->scanner->cursor_pos[ROW]), 
             (parser->scanner->cursor_pos[COL]));
 
-    fprintf(stderr, "Wrong token! '%s' expected, but token is: \033[1;33m%s\033[0m type: \033[0;33m%s\033[0m!\n", 
+    fprintf(parser->scanner->diag, "Wrong token! '%s' expected, but token is: \033[1;33m%s\033[0m type: \033[0;33m%s\033[0m!\n", 
             expected, 
             get_attr(&t, parser->scanner), 
             tok_type_to_str(t.token_type));
@@ -2103,35 +2356,37 @@ void error_unexpected_token(parser_t *parser, char * expected, token_t t) {
 void error_semantic(parser_t *parser, const char * _Format, ...) {
     va_list args;
     va_start(args,_Format);
-    fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t|\033[0;31m Semantic error: \033[0m", 
+    fprintf(parser->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t|\033[0;31m Semantic error: \033[0m", 
             (parser->scanner->cursor_pos[ROW]), 
             (parser->scanner->cursor_pos[COL]));
 
-    vfprintf(stderr, _Format, args);
-    fprintf(stderr,"\n");
+    vfprintf(parser->scanner->diag, _Format, args);
+    fprintf(parser->scanner->diag,"\n");
 }
 
 void warn(parser_t *parser, const char * _Format, ...) {
     if(PRINT_WARNINGS) {
         va_list args;
         va_start(args,_Format);
-        fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t|\033[1;33m Warning: \033[0m", 
+        parser->scanner->warn_cnt++;
+        fprintf(parser->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t|\033[1;33m Warning: \033[0m", 
                 (parser->scanner->cursor_pos[ROW]), 
                 (parser->scanner->cursor_pos[COL]));
 
-        vfprintf(stderr, _Format, args);
-        fprintf(stderr,"\n");
+        vfprintf(parser->scanner->diag, _Format, args);
+        fprintf(parser->scanner->diag,"\n");
     }
 }
 
 
-void int_error(const char * _Format, ...) {
+void int_error(parser_t *parser, const char * _Format, ...) {
     va_list args;
     va_start(args,_Format);
-    fprintf(stderr, "\033[1;31mInternal error:\033[0m ");
+    fprintf(parser->scanner->diag, "\033[1;31mInternal error:\033[0m ");
 
-    vfprintf(stderr, _Format, args);
-    fprintf(stderr,"\n");
+    vfprintf(parser->scanner->diag, _Format, args);
+    fprintf(parser->scanner->diag,"\n");
+    va_end(args);
 }
 
 
@@ -2199,11 +2454,16 @@ bool compare_token(token_t t, token_type_t expecting) {
 }
 
 
+bool compare_keyword(token_t t, keyword_id_t keyword) {
+    return t.token_type == KEYWORD && t.attr_id == (int)keyword;
+}
+
+
 bool compare_token_attr(parser_t *p, token_t t, 
                         token_type_t exp_type, char * exp_attr) {
 
     if(t.token_type == exp_type) {
-        if(str_cmp(get_attr(&t, p->scanner), exp_attr) == 0) {
+        if(attr_view_eq(get_attr_view(&t, p->scanner), exp_attr)) {
             return true;
         }
     }
@@ -34,11 +34,16 @@
 #include <stdarg.h>
 #include "symtable.h"
 #include "generator.h"
+#include "ast.h"
+#include "codegen.h"
+#include "ssa.h"
+#include "funccache.h"
 #include "dstack.h"
 
 
 #define DEBUG false /**< If true, prints debug log to stderr */
 #define PRINT_WARNINGS true /**< If true, prints warning to stderr about some implicit actions (see documentation for more)*/
+#define MAX_ERRORS 10 /**< Maximum number of errors reported in one pass (parser tries to recover from errors until it is reached) */
 
 /**
  * @brief Return codes of parser 
@@ -71,13 +76,25 @@ typedef struct parser {
     bool found_return; /**< Flag for propagation info about found returns */
 
     tok_stack_t decl_func; /**< Stack with declared functions (to check if they were defined)*/
+    tok_stack_t id_names; /**< Names of parameters or assigned variables (stack is cleared and reused to avoid allocations) */
 
     int return_code;
     bool reached_EOF;
 
-    scanner_t * scanner;
+    int first_err; /**< Return code of the first reported error (it is the result of parsing) */
+    size_t err_cnt; /**< Number of errors reported in current pass */
+    bool err_reported; /**< Error that is being propagated was already reported */
+    size_t block_depth; /**< Number of opened blocks (if, while) in current function (for synchronization after error) */
+
+    scanner_t * scanner; /**< Source of tokens (its diagnostic stream is used for error messages of parser) */
     symbol_tables_t sym;
     prog_t dst_code;
+    ast_t ast; /**< Tree of program (code of global statement is generated from it right after statement is parsed) */
+    ast_node_t **ast_tail; /**< End of list, where the next parsed statement (or parameter) is appended */
+    FILE *out; /**< Stream where is printed generated code (stdout by default) */
+    fcache_t *fcache; /**< Cache with code of functions for incremental compilation (NULL if all functions are compiled) */
+    unsigned codegen_workers; /**< Number of threads generating code after parsing (1 means that code is generated right after every global statement) */
+    opt_level_t opt_level; /**< Level of optimizations of tree before code is generated (@see ssa.h) */
 } parser_t;
 
 typedef struct rule {
@@ -91,12 +108,30 @@ int error_rule();
 /**
  * @return Pointer to rule that corresponds to given index (or NULL if index is to high)
  */
-rule_t * get_global_rule(size_t index);
+const rule_t * get_global_rule(size_t index);
 
 /**
  * @return Pointer to rule that corresponds to given index (or NULL if index is to high)
  */
-rule_t * get_inside_rule(size_t index);
+const rule_t * get_inside_rule(size_t index);
+
+/**
+ * @brief Table for direct dispatch of rules (rule is found by one lookup)
+ */
+typedef struct rule_dispatch {
+    const rule_t *by_type[TOK_TYPE_NUM]; /**< Rules, that are determined only by type of the first token */
+    const rule_t *by_keyword[KEYWORD_TABLE_SIZE]; /**< Rules starting with keyword (indexed by keyword_id_t) */
+} rule_dispatch_t;
+
+/**
+ * @return Pointer to dispatch table of rules for global scope
+ */
+const rule_dispatch_t * get_global_dispatch();
+
+/**
+ * @return Pointer to dispatch table of rules for function bodies
+ */
+const rule_dispatch_t * get_inside_dispatch();
 
 /**
  * @brief Sets symtab to elder symbol table of old outer context 
@@ -114,6 +149,17 @@ void to_inner_ctx(parser_t *parser);
  */ 
 bool is_global_ctx(parser_t *parser);
 
+/**
+ * @brief Returns true if code is generated after the whole program is parsed (by more threads)
+ * @note Incremental compilation needs code of every function right after it is parsed, so code is not deferred then
+ */
+bool is_codegen_deferred(parser_t *parser);
+
+/**
+ * @brief Appends node to the end of current list of statements (and moves the end after it)
+ */
+void append_node(parser_t *parser, ast_node_t *node);
+
 /**
  * @brief Inits parser to be used for program parsing
  * @return if initialization was succesful returns EXIT_SUCCESS, also can return INTERNAL_ERROR
@@ -122,6 +168,7 @@ int parser_setup(parser_t *parser, scanner_t *scanner);
 
 /**
  * @brief Frees all resources hold by parser and its components
+ * @note It does nothing if arena is used (@see arena.h), resources are released with arena
  */ 
 void parser_dtor(parser_t *parser);
 
@@ -164,6 +211,45 @@ int statement_list(parser_t *parser);
 int global_statement(parser_t *parser);
 
 
+/**
+ * @brief Saves error to parser (code of the first error is kept as result of parsing)
+ */
+void report_error(parser_t *parser, int err_code);
+
+
+/**
+ * @brief Checks if parser can continue after error (error is not internal and limit of errors was not reached)
+ */
+bool can_recover(parser_t *parser, int err_code);
+
+
+/**
+ * @brief Skips tokens until synchronization token is found (panic mode)
+ * @param depth Number of blocks, that are opened and must be skipped with their 'end'
+ * @param inside If true, parser is inside of function and local, end, else (and other keywords 
+ *               that starts statement) at depth 0 are synchronization tokens
+ * @return PARSE_SUCCESS or INTERNAL_ERROR
+ * @note Tokens function and global (and EOF) are always synchronization tokens, 
+ *       'end' at depth 0 is consumed in global scope (it is end of function with error)
+ */
+int skip_to_sync(parser_t *parser, size_t depth, bool inside);
+
+
+/**
+ * @brief Tries to recover from error inside function body (panic mode)
+ * @param base_depth Number of opened blocks at the beginning of current statement list
+ * @return True if parsing of statement list can continue, false if error must be propagated
+ */
+bool recover_inside(parser_t *parser, int err_code, size_t base_depth);
+
+
+/**
+ * @brief Tries to recover from error in global scope (panic mode)
+ * @return True if parsing of global statement list can continue
+ */
+bool recover_global(parser_t *parser, int err_code);
+
+
 /**
  * @brief Parses statements inside of a function
  */
@@ -180,8 +266,7 @@ bool is_convertable(sym_dtype_t var_type, sym_dtype_t r_side_type);
 /**
  * @brief Resolves compatibility of data types in assignment
  */ 
-bool is_valid_assign(prog_t *dst_code, sym_dtype_t var_type, 
-                     sym_dtype_t r_side_type);
+bool is_valid_assign(sym_dtype_t var_type, sym_dtype_t r_side_type);
 
 /**
  * @brief Parses one identifier on lside of assignments
@@ -201,22 +286,17 @@ int assignment_lside(parser_t *parser, token_t* start_id,
 
 /**
  * @brief Parses one expression in assignment and performs type checking
+ * @note Expression is appended to values of given assignment node (if its values are used)
  */ 
 int assignment_expr(size_t *cnt, parser_t *parser, 
                     string_t *id_types, string_t *rside,
-                    bool *was_f_called, prog_stack_t *expr_progs);
+                    bool *was_f_called, ast_node_t *assign);
 
 
 /**
  * @brief Parses right side of assignment
  */ 
-int assignment_rside(parser_t *parser, string_t *id_types, string_t *rside);
-
-
-/**
- * @brief Frees everything inside given stack of programs
- */
-void prog_stack_deep_dtor(prog_stack_t *prog);
+int assignment_rside(parser_t *parser, string_t *id_types, string_t *rside, ast_node_t *assign);
 
 
 /**
@@ -265,7 +345,7 @@ void set_use_flag(tree_node_t *symbol, bool new_s);
  * @note If everything went well, changes variable status to defined
  */
 int local_var_assignment(parser_t *parser, sym_status_t *status, 
-                         sym_dtype_t dtype, token_t *var_id);
+                         sym_dtype_t dtype, token_t *var_id, ast_node_t *local);
 
 
 /**
@@ -371,9 +451,10 @@ int parse_function_def(parser_t *parser);
 /**
  * @brief Parses function arguments when function is called
  * @param func_sym Pointer to smbol table where is the function (it cannot be NULL)
+ * @param call Node of call, where arguments are appended
  * @note Functon argument can be also expression as well as variable or immediate value
  */ 
-int parse_function_arguments(parser_t *parser, tree_node_t *func_sym);
+int parse_function_arguments(parser_t *parser, tree_node_t *func_sym, ast_node_t *call);
 
 
 /**
@@ -399,9 +480,9 @@ int parse_while(parser_t *parser);
  * @brief Finds the appropriate rule
  * @return Returns reference to rule function
  * @param t Token based on which is going to be decided what rule to use
- * @param ruleset_function is a function, that contains array with ruleset
+ * @param dispatch Dispatch table of ruleset (indexed by token type and keyword id)
  */
-rule_t *determine_rule(parser_t *p, token_t t, rule_t *(*ruleset_f)(size_t));
+const rule_t *determine_rule(parser_t *p, token_t t, const rule_dispatch_t *dispatch);
 
 /**
  * @brief parses an identifier inside a function
@@ -478,11 +559,11 @@ void error_semantic(parser_t *parser, const char * _Format, ...);
 /**
  * @brief Prints message in internal error format
  */ 
-void int_error(const char * _Format, ...);
+void int_error(parser_t *parser, const char * _Format, ...);
 
 
 /**
- * @brief Prints formated warnings to stderr
+ * @brief Prints formated warnings to diagnostic stream
  */ 
 void warn(parser_t *parser, const char * _Format, ...);
 
@@ -522,6 +603,13 @@ bool check_next_token_attr(parser_t *p, token_type_t exp_type, char * exp_attr);
  **/
 bool compare_token(token_t t, token_type_t expecting);
 
+/**
+ * @param keyword Id of expected keyword
+ * @brief Checks if token 't' is given keyword (without comparing strings)
+ * @return returns true if token is expected keyword
+ **/
+bool compare_keyword(token_t t, keyword_id_t keyword);
+
 /**
  * @param expecting_type The token type to expect
  * @param expecting_attr The token attribute to expect
@@ -2165,6 +2165,112 @@ TEST_F(prolog_in_middle, syntax){
 	ASSERT_EQ(parse_program(&pt), SYNTAX_ERROR);
 }
 
+class more_errors : public test_fixture{
+	protected:
+		void setData() override{
+			scanner_input =
+			R"(
+require "ifj21"
+function f(a : integer) : integer
+    local s : string = a
+    if a > 1 then
+        a = a +
+    end
+    local z : integer = 1 +
+    return a
+end
+
+function g(
+    write(1)
+end
+
+function main()
+    write(f(1), undefined_var)
+end
+main()
+			)";
+		}
+};
+
+TEST_F(more_errors, first_error_kept){
+	ASSERT_EQ(parse_program(&pt), SEMANTIC_ERROR_ASSIGNMENT);
+	ASSERT_EQ(pt.err_cnt, (size_t)5);
+}
+
+
+class too_many_errors : public test_fixture{
+	protected:
+		void setData() override{
+			scanner_input = "require \"ifj21\"\nfunction main()\n";
+			for(size_t i = 0; i < MAX_ERRORS * 2; i++) {
+				scanner_input += "    local a : integer = ;\n";
+			}
+
+			scanner_input += "end\n";
+		}
+};
+
+TEST_F(too_many_errors, limit){
+	ASSERT_EQ(parse_program(&pt), LEXICAL_ERROR);
+	ASSERT_EQ(pt.err_cnt, (size_t)MAX_ERRORS);
+}
+
+
+#define STRESS_STATEMENTS 100000 /**< Number of statements in stress tests of statement lists */
+#define STRESS_NESTING 1000 /**< Depth of nested blocks in stress tests */
+
+class long_flat_program : public test_fixture{
+	protected:
+		void setData() override{
+			scanner_input = "require \"ifj21\"\n";
+			scanner_input += "function f(x : integer) : integer\n";
+			scanner_input += "    local a : integer = x\n";
+			for(size_t i = 0; i < STRESS_STATEMENTS; i++) {
+				scanner_input += "    a = a + 1\n";
+			}
+
+			scanner_input += "    return a\nend\n";
+			for(size_t i = 0; i < STRESS_STATEMENTS; i++) {
+				scanner_input += "f(1)\n";
+			}
+		}
+};
+
+TEST_F(long_flat_program, syntax){
+	ASSERT_EQ(parse_program(&pt), PARSE_SUCCESS);
+}
+
+TEST_F(long_flat_program, bounded_attr_buffer){
+	ASSERT_EQ(parse_program(&pt), PARSE_SUCCESS);
+
+	//Attributes are reclaimed after every statement, so store must not grow with input
+	ASSERT_NE(uut.attr_store, nullptr);
+	EXPECT_EQ(uut.attr_store->next, nullptr);
+}
+
+
+class deeply_nested_program : public test_fixture{
+	protected:
+		void setData() override{
+			scanner_input = "require \"ifj21\"\nfunction main()\n";
+			scanner_input += "    local a : integer = 1\n";
+			for(size_t i = 0; i < STRESS_NESTING; i++) {
+				scanner_input += (i % 2) ? "while a < 2 do\n" : "if a == 1 then\n";
+			}
+
+			scanner_input += "a = a + 1\n";
+			for(size_t i = STRESS_NESTING; i > 0; i--) {
+				scanner_input += ((i - 1) % 2) ? "end\n" : "else a = 0 end\n";
+			}
+
+			scanner_input += "end\nmain()\n";
+		}
+};
+
+TEST_F(deeply_nested_program, syntax){
+	ASSERT_EQ(parse_program(&pt), PARSE_SUCCESS);
+}
+
 
 int main(int argc, char **argv) {
 	::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,27 @@
+#Generator of program with huge string literals to make performance tests
+#of compiler (especially encoding of string literals in generator)
+
+import random
+
+number_of_literals = 20
+literal_length = 200000
+
+chunks = ["word ", "\\n", "\\t", "\\\"", "\\\\", "#", "\\065", "x", "  "]
+
+print("require \"ifj21\"")
+print("")
+print("function main()")
+for l in range(0, number_of_literals):
+    literal = []
+    length = 0
+    while length < literal_length:
+        chunk = random.choice(chunks)
+        literal.append(chunk)
+        length += len(chunk)
+
+    print("    local s" + str(l) + " : string = \"" + "".join(literal) + "\"")
+    print("    write(#s" + str(l) + ")")
+
+print("end")
+print("")
+print("main()")
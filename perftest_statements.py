@@ -0,0 +1,33 @@
+#Generator of functions with huge amount of short statements to make
+#performance tests of parser (especially choosing of rules for statements)
+
+import random
+
+number_of_functions = 200
+number_of_statements = 500
+
+print("require \"ifj21\"")
+print("")
+
+for f in range(0, number_of_functions):
+    print("function f" + str(f) + "(n : integer) : integer")
+    print("    local a : integer = n")
+    for s in range(0, number_of_statements):
+        kind = random.randint(0, 4)
+        if kind == 0:
+            print("    local v" + str(s) + " : integer = a")
+        elif kind == 1:
+            print("    if a > " + str(s) + " then a = a - 1 else a = a + 1 end")
+        elif kind == 2:
+            print("    while a > " + str(s) + " do a = a - 1 end")
+        elif kind == 3:
+            print("    a = a * 2")
+        else:
+            print("    write(a)")
+
+    print("    return a")
+    print("end")
+    print("")
+
+for f in range(0, number_of_functions):
+    print("f" + str(f) + "(" + str(f) + ")")
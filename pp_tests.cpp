@@ -78,7 +78,8 @@ class test_fixture : public :: testing :: Test {
 
         scanner_t uut;
         symbol_tables_t syms;
-        prog_t prog;
+        ast_t ast; //Tree of parsed expression
+        ast_node_t *expr;
         bool init_success;
         bool was_only_f_call;
 
@@ -101,7 +102,7 @@ class test_fixture : public :: testing :: Test {
             init_tab(&syms.global);
             symtabs_stack_init(&syms.symtab_st);
 
-            init_new_prog(&prog);
+            ast_init(&ast);
 
             str_init(&ret_type);
         }
@@ -110,7 +111,7 @@ class test_fixture : public :: testing :: Test {
             remove(inp_filename.c_str());
             scanner_dtor(&uut);
 
-            program_dtor(&prog);
+            ast_dtor(&ast);
 
             symtabs_stack_dtor(&syms.symtab_st);
             destroy_tab(&syms.symtab);
@@ -121,7 +122,7 @@ class test_fixture : public :: testing :: Test {
 };
 
 TEST_F(test_fixture, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), UNDECLARED_IDENTIFIER);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), UNDECLARED_IDENTIFIER);
 }
 
 
@@ -135,7 +136,7 @@ class lexical_error : public test_fixture {
 };
 
 TEST_F(lexical_error, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), LEXICAL_ERROR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), LEXICAL_ERROR);
 }
 
 class basic : public test_fixture {
@@ -148,10 +149,23 @@ class basic : public test_fixture {
 };
 
 TEST_F(basic, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(char_to_dtype(to_str(&ret_type)[0]), INT);
 }
 
+TEST_F(basic, tree) {
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
+
+    //Operator with higher priority must be deeper in the tree
+    ASSERT_NE(expr, nullptr);
+    ASSERT_EQ(expr->kind, AST_OP);
+    ASSERT_EQ(expr->a->kind, AST_NUM);
+    ASSERT_EQ(expr->b->kind, AST_OP);
+    EXPECT_EQ(expr->b->a->kind, AST_NUM);
+    EXPECT_EQ(expr->b->b->kind, AST_NUM);
+    EXPECT_NE(expr->n, expr->b->n);
+}
+
 class str_parse : public test_fixture {
     protected:
         void setData() override {
@@ -162,7 +176,7 @@ class str_parse : public test_fixture {
 };
 
 TEST_F(str_parse, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(char_to_dtype(to_str(&ret_type)[0]), INT);
 }
 
@@ -176,7 +190,7 @@ class nested_parenthesis : public test_fixture {
 };
 
 TEST_F(nested_parenthesis, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 class relational_operators1 : public test_fixture {
@@ -189,7 +203,7 @@ class relational_operators1 : public test_fixture {
 };
 
 TEST_F(relational_operators1, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(char_to_dtype(to_str(&ret_type)[0]), BOOL);
 }
 
@@ -204,7 +218,7 @@ class relational_operators2 : public test_fixture {
 };
 
 TEST_F(relational_operators2, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(char_to_dtype(to_str(&ret_type)[0]), BOOL);
 }
 
@@ -219,7 +233,7 @@ class relational_operators3 : public test_fixture {
 };
 
 TEST_F(relational_operators3, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), SEM_ERROR_IN_EXPR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), SEM_ERROR_IN_EXPR);
 }
 
 class relational_operators4 : public test_fixture {
@@ -232,7 +246,7 @@ class relational_operators4 : public test_fixture {
 };
 
 TEST_F(relational_operators4, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), SEM_ERROR_IN_EXPR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), SEM_ERROR_IN_EXPR);
 }
 
 
@@ -246,7 +260,7 @@ class relational_operators5 : public test_fixture {
 };
 
 TEST_F(relational_operators5, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(char_to_dtype(to_str(&ret_type)[0]), BOOL);
 }
 
@@ -261,7 +275,7 @@ class relational_operators6 : public test_fixture {
 };
 
 TEST_F(relational_operators6, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), SEM_ERROR_IN_EXPR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), SEM_ERROR_IN_EXPR);
 }
 
 class relational_operators7 : public test_fixture {
@@ -274,7 +288,7 @@ class relational_operators7 : public test_fixture {
 };
 
 TEST_F(relational_operators7, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), SEM_ERROR_IN_EXPR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), SEM_ERROR_IN_EXPR);
 }
 
 class parenthesis_err : public test_fixture {
@@ -287,7 +301,7 @@ class parenthesis_err : public test_fixture {
 };
 
 TEST_F(parenthesis_err, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -301,7 +315,7 @@ class op_err1 : public test_fixture {
 };
 
 TEST_F(op_err1, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_FAILURE);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_FAILURE);
 }
 
 class op_err2 : public test_fixture {
@@ -314,7 +328,7 @@ class op_err2 : public test_fixture {
 };
 
 TEST_F(op_err2, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_FAILURE);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_FAILURE);
 }
 
 
@@ -328,9 +342,9 @@ class multiple_call1 : public test_fixture {
 };
 
 TEST_F(multiple_call1, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(char_to_dtype(to_str(&ret_type)[0]), INT);
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(char_to_dtype(to_str(&ret_type)[0]), INT);
 }
 
@@ -346,9 +360,9 @@ class multiple_call2 : public test_fixture {
 TEST_F(multiple_call2, only_parse) {
     insert_sym(&syms.symtab, "a", {{0, 0, (char *)"a"}, VAR, {0, 0, NULL}, {0, 0, NULL}, NUM, DECLARED});
     insert_sym(&syms.symtab, "b", {{0, 0, (char *)"b"}, VAR, {0, 0, NULL}, {0, 0, NULL}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(char_to_dtype(to_str(&ret_type)[0]), NUM);
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(char_to_dtype(to_str(&ret_type)[0]), INT);
 }
 
@@ -362,7 +376,7 @@ class op_no_err1 : public test_fixture {
 };
 
 TEST_F(op_no_err1, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS); /**< PP parser should return control to the topdown parser*/
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS); /**< PP parser should return control to the topdown parser*/
 }
 
 class op_no_err2 : public test_fixture {
@@ -375,7 +389,7 @@ class op_no_err2 : public test_fixture {
 };
 
 TEST_F(op_no_err2, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS); /**< PP parser should return control to the topdown parser*/
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS); /**< PP parser should return control to the topdown parser*/
 }
 
 class unary_minus : public test_fixture {
@@ -388,7 +402,7 @@ class unary_minus : public test_fixture {
 };
 
 TEST_F(unary_minus, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -404,7 +418,7 @@ class undeclared1 : public test_fixture {
 };
 
 TEST_F(undeclared1, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), UNDECLARED_IDENTIFIER);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), UNDECLARED_IDENTIFIER);
 }
 
 class undeclared2 : public test_fixture {
@@ -417,7 +431,7 @@ class undeclared2 : public test_fixture {
 };
 
 TEST_F(undeclared2, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), UNDECLARED_IDENTIFIER);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), UNDECLARED_IDENTIFIER);
 }
 
 class undeclared3 : public test_fixture {
@@ -430,7 +444,7 @@ class undeclared3 : public test_fixture {
 };
 
 TEST_F(undeclared3, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), UNDECLARED_IDENTIFIER); /**< PP parser should return control to the topdown parser*/
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), UNDECLARED_IDENTIFIER); /**< PP parser should return control to the topdown parser*/
 }
 
 class nested_parenthesis_undeclared : public test_fixture {
@@ -443,7 +457,7 @@ class nested_parenthesis_undeclared : public test_fixture {
 };
 
 TEST_F(nested_parenthesis_undeclared, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), UNDECLARED_IDENTIFIER);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), UNDECLARED_IDENTIFIER);
 }
 
 class declared1 : public test_fixture {
@@ -457,7 +471,7 @@ class declared1 : public test_fixture {
 
 TEST_F(declared1, only_parse) {
     insert_sym(&syms.symtab, "a", {{0, 0, (char *)"a"}, VAR, {0, 0, NULL}, {0, 0, NULL}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -473,7 +487,7 @@ class declared2 : public test_fixture {
 TEST_F(declared2, only_parse) {
     insert_sym(&syms.symtab, "a", {{0, 0, (char *)"a"}, VAR, {0, 0, NULL}, {0, 0, NULL}, INT, DECLARED});
     insert_sym(&syms.symtab, "b", {{0, 0, (char *)"b"}, VAR, {0, 0, NULL}, {0, 0, NULL}, NUM, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(char_to_dtype(to_str(&ret_type)[0]), NUM);
 }
 
@@ -490,7 +504,7 @@ class declared3_sem_err : public test_fixture {
 TEST_F(declared3_sem_err, only_parse) {
     insert_sym(&syms.symtab, "a", {{0, 0, (char *)"a"}, VAR, {0, 0, NULL}, {0, 0, NULL}, INT, DECLARED});
     insert_sym(&syms.symtab, "b", {{0, 0, (char *)"b"}, VAR, {0, 0, NULL}, {0, 0, NULL}, STR, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), SEM_ERROR_IN_EXPR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), SEM_ERROR_IN_EXPR);
 }
 
 class nil1 : public test_fixture {
@@ -504,7 +518,7 @@ class nil1 : public test_fixture {
 
 TEST_F(nil1, only_parse) {
     insert_sym(&syms.symtab, "a", {{0, 0, (char *)"a"}, VAR, {0, 0, NULL}, {0, 0, NULL}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -520,7 +534,7 @@ class nil2 : public test_fixture {
 };
 
 TEST_F(nil2, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -535,7 +549,7 @@ class nil3 : public test_fixture {
 
 TEST_F(nil3, only_parse) {
     insert_sym(&syms.symtab, "a", {{0, 0, (char *)"a"}, VAR, {0, 0, NULL}, {0, 0, NULL}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), NIL_ERROR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), NIL_ERROR);
 }
 
 
@@ -549,7 +563,7 @@ class zero1 : public test_fixture {
 };
 
 TEST_F(zero1, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -563,7 +577,7 @@ class zero2 : public test_fixture {
 };
 
 TEST_F(zero2, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), DIV_BY_ZERO);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), DIV_BY_ZERO);
 }
 
 
@@ -578,7 +592,7 @@ class zero3 : public test_fixture {
 
 TEST_F(zero3, only_parse) {
     insert_sym(&syms.symtab, "a", {{0, 0, (char *)"a"}, VAR, {0, 0, NULL}, {0, 0, NULL}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), DIV_BY_ZERO);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), DIV_BY_ZERO);
 }
 
 
@@ -592,7 +606,7 @@ class zero4 : public test_fixture {
 };
 
 TEST_F(zero4, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), DIV_BY_ZERO);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), DIV_BY_ZERO);
 }
 
 
@@ -606,7 +620,7 @@ class zero5 : public test_fixture {
 };
 
 TEST_F(zero5, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), DIV_BY_ZERO);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), DIV_BY_ZERO);
 }
 
 
@@ -621,7 +635,7 @@ class missing_par : public test_fixture {
 };
 
 TEST_F(missing_par, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_FAILURE);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_FAILURE);
 }
 
 
@@ -637,7 +651,7 @@ class missing_par1 : public test_fixture {
 };
 
 TEST_F(missing_par1, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_FAILURE);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_FAILURE);
 }
 
 
@@ -653,7 +667,7 @@ class missing_par2 : public test_fixture {
 };
 
 TEST_F(missing_par2, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_FAILURE);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_FAILURE);
 }
 
 
@@ -669,7 +683,7 @@ class missing_par3 : public test_fixture {
 };
 
 TEST_F(missing_par3, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_FAILURE);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_FAILURE);
 }
 
 
@@ -683,7 +697,7 @@ class missing_par4 : public test_fixture {
 };
 
 TEST_F(missing_par4, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -697,7 +711,7 @@ class minuses : public test_fixture {
 };
 
 TEST_F(minuses, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -711,7 +725,7 @@ class minuses2 : public test_fixture {
 };
 
 TEST_F(minuses2, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -726,7 +740,7 @@ class f_call1 : public test_fixture {
 
 TEST_F(f_call1, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {2, 0, (char *)"ii"}, {0, 0, (char *)"s"}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), SEMANTIC_ERROR_PARAMETERS_EXPR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), SEMANTIC_ERROR_PARAMETERS_EXPR);
 }
 
 
@@ -741,7 +755,7 @@ class f_call2 : public test_fixture {
 
 TEST_F(f_call2, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {2, 0, (char *)"ii"}, {0, 0, (char *)"si"}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -757,7 +771,7 @@ class f_call3 : public test_fixture {
 
 TEST_F(f_call3, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {2, 0, (char *)"ii"}, {0, 0, (char *)"s"}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), SEMANTIC_ERROR_PARAMETERS_EXPR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), SEMANTIC_ERROR_PARAMETERS_EXPR);
 }
 
 
@@ -773,7 +787,7 @@ class f_call4 : public test_fixture {
 
 TEST_F(f_call4, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {2, 0, (char *)"ii"}, {0, 0, (char *)""}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), SEMANTIC_ERROR_PARAMETERS_EXPR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), SEMANTIC_ERROR_PARAMETERS_EXPR);
 }
 
 
@@ -788,7 +802,7 @@ class f_call5 : public test_fixture {
 
 TEST_F(f_call5, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {2, 0, (char *)"ii"}, {0, 0, (char *)"i"}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), SEMANTIC_ERROR_PARAMETERS_EXPR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), SEMANTIC_ERROR_PARAMETERS_EXPR);
 }
 
 
@@ -803,7 +817,7 @@ class f_call6 : public test_fixture {
 
 TEST_F(f_call6, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {2, 0, (char *)"ii"}, {0, 0, (char *)"i"}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -818,8 +832,8 @@ class f_call7 : public test_fixture {
 
 TEST_F(f_call7, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {2, 0, (char *)"ss"}, {0, 0, (char *)"s"}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -835,9 +849,9 @@ class f_call8 : public test_fixture {
 
 TEST_F(f_call8, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {2, 0, (char *)"ss"}, {0, 0, (char *)"sii"}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(was_only_f_call, false);
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_FAILURE);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_FAILURE);
 }
 
 
@@ -853,7 +867,7 @@ class f_call9 : public test_fixture {
 
 TEST_F(f_call9, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {2, 0, (char *)"ss"}, {0, 0, (char *)"sii"}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(was_only_f_call, true);
 }
 
@@ -872,8 +886,8 @@ class f_call10 : public test_fixture {
 
 TEST_F(f_call10, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {2, 0, (char *)"ss"}, {0, 0, (char *)""}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_FAILURE);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_FAILURE);
     ASSERT_EQ(was_only_f_call, true);
 }
 
@@ -889,7 +903,7 @@ class f_call11 : public test_fixture {
 
 TEST_F(f_call11, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {7, 0, (char *)"iiiiiii"}, {0, 0, (char *)""}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
     ASSERT_EQ(was_only_f_call, false);
 }
 
@@ -905,7 +919,7 @@ class f_call12 : public test_fixture {
 
 TEST_F(f_call12, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {2, 0, (char *)"ss"}, {0, 0, (char *)"ssssii"}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), EXPRESSION_SUCCESS);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), EXPRESSION_SUCCESS);
 }
 
 
@@ -920,7 +934,7 @@ class lex_err1 : public test_fixture {
 
 TEST_F(lex_err1, only_parse) {
     insert_sym(&syms.global, "a", {{0, 0, (char *)"a"}, FUNC, {2, 0, (char *)"ss"}, {0, 0, (char *)""}, INT, DECLARED});
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), LEXICAL_ERROR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), LEXICAL_ERROR);
 }
 
 
@@ -934,7 +948,7 @@ class lex_err2 : public test_fixture {
 };
 
 TEST_F(lex_err2, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), LEXICAL_ERROR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), LEXICAL_ERROR);
 }
 
 
@@ -948,7 +962,7 @@ class lex_err3 : public test_fixture {
 };
 
 TEST_F(lex_err3, only_parse) {
-    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &prog), LEXICAL_ERROR);
+    ASSERT_EQ(parse_expression(&uut, &syms, &ret_type, &was_only_f_call, &ast, &expr), LEXICAL_ERROR);
 }
 
 
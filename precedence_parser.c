@@ -24,29 +24,29 @@ DSTACK(expr_el_t, pp, fprintf(stderr," %d", s->data[i].type)) /**< Operations wi
 
 bool is_allowed_separator(scanner_t *sc, token_t *token) {
     return token->token_type == SEPARATOR && 
-           (str_cmp(get_attr(token, sc), ")") == 0 || 
-           str_cmp(get_attr(token, sc), "(") == 0); //It must be left/right par
+           (attr_view_eq(get_attr_view(token, sc), ")") || 
+           attr_view_eq(get_attr_view(token, sc), "(")); //It must be left/right par
 }
 
 
 bool is_nil(scanner_t *sc, token_t *token) {
     return token->token_type == KEYWORD && 
-           (str_cmp(get_attr(token, sc), "nil") == 0);
+           attr_view_eq(get_attr_view(token, sc), "nil");
 }
 
 
 bool is_zero(scanner_t *sc, token_t *token) {
-    char *value = get_attr(token, sc);
+    attr_view_t value = get_attr_view(token, sc);
     if(token->token_type == INTEGER || token->token_type == NUMBER) {
-        for(int i = 0; i < strlen(value); i++) {
-            if(value[i] != '0' && value[i] != '.') { //It can be zero in number for
+        for(size_t i = 0; i < value.len; i++) {
+            if(value.str[i] != '0' && value.str[i] != '.') { //It can be zero in number for
                 return false;
             }
         }
     }
     else if(token->token_type == STRING) {
-        for(int i = 0; i < strlen(value); i++) { //Or empty string
-            if(value[i] != '"') {
+        for(size_t i = 0; i < value.len; i++) { //Or empty string
+            if(value.str[i] != '"') {
                 return false;
             }
         }
@@ -135,26 +135,26 @@ grm_sym_type_t operator_type(char first_c, char sec_c, tok_buffer_t *tok_b) {
 
 
 int tok_to_type(tok_buffer_t *tok_b, bool *was_only_f_call) {
-    token_t token = tok_b->current;
+    token_t *token = tok_b->current;
 
-    if(token.token_type == IDENTIFIER || token.token_type == NUMBER ||
-       token.token_type == STRING || token.token_type == INTEGER || 
-       is_nil(tok_b->scanner, &tok_b->current)) { 
+    if(token->token_type == IDENTIFIER || token->token_type == NUMBER ||
+       token->token_type == STRING || token->token_type == INTEGER || 
+       is_nil(tok_b->scanner, token)) { 
         
         //It is operand
-        if(token.token_type != IDENTIFIER) {
+        if(token->token_type != IDENTIFIER) {
             *was_only_f_call = false; //it can be still func call
         }
 
            return OPERAND;
     }
-    else if(token.token_type == OPERATOR || token.token_type == SEPARATOR) {
+    else if(token->token_type == OPERATOR || token->token_type == SEPARATOR) {
         //It is operator
         int char_num = 0;
-        char first_ch = (get_attr(&token, tok_b->scanner))[char_num++],
-        next_ch = (get_attr(&token, tok_b->scanner))[char_num];
+        char first_ch = (get_attr(token, tok_b->scanner))[char_num++],
+        next_ch = (get_attr(token, tok_b->scanner))[char_num];
 
-        if(token.token_type == OPERATOR) { 
+        if(token->token_type == OPERATOR) { 
             //It can be function call in parenthesis
             *was_only_f_call = false;
         }
@@ -182,12 +182,7 @@ sym_dtype_t prim_type(string_t *type_string) {
 }
 
 
-void int2num(prog_t *dst) {
-    impl_int2num(dst);
-}
-
-
-bool is_compatible_in_arg(prog_t *dst, char par_type, char arg_type) {
+bool is_compatible_in_arg(ast_t *ast, ast_node_t **arg, char par_type, char arg_type) {
     if(char_to_dtype(arg_type) == char_to_dtype(par_type)) {
         return true;
     }
@@ -195,7 +190,7 @@ bool is_compatible_in_arg(prog_t *dst, char par_type, char arg_type) {
         return true;
     }
     else if(char_to_dtype(arg_type) == INT && char_to_dtype(par_type) == NUM) {
-        int2num(dst);
+        ast_int2num(ast, arg); //If it fails, internal error is signalized by flag of tree
         return true;
     }
     else {
@@ -210,29 +205,29 @@ bool is_tok_type(token_type_t exp_type, token_t *t) {
 
 
 bool is_tok_attr(char *exp_attr, token_t *t, tok_buffer_t *tok_b) {
-    return str_cmp(get_attr(t, tok_b->scanner), exp_attr) == 0;
+    return attr_view_eq(get_attr_view(t, tok_b->scanner), exp_attr);
 }
 
 
 void fcall_sem_error(tok_buffer_t *tok_b, char *f_name, char *msg) {
-    fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSemantic error:\033[0m ", //Print err msg prolog
+    fprintf(tok_b->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSemantic error:\033[0m ", //Print err msg prolog
             tok_b->scanner->cursor_pos[ROW], tok_b->scanner->cursor_pos[COL]);
 
-    fprintf(stderr, "Bad function call of \033[1;33m%s\033[0m! ", f_name);
-    fprintf(stderr, "%s\n", msg);
+    fprintf(tok_b->scanner->diag, "Bad function call of \033[1;33m%s\033[0m! ", f_name);
+    fprintf(tok_b->scanner->diag, "%s\n", msg);
 }
 
 
 void fcall_syn_error(tok_buffer_t *tok_b, char *f_name, char *msg) {
-    fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSyntax error:\033[0m ", 
+    fprintf(tok_b->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSyntax error:\033[0m ", 
             tok_b->scanner->cursor_pos[ROW], tok_b->scanner->cursor_pos[COL]);
 
-    fprintf(stderr, "In function call of \033[1;33m%s\033[0m! ", f_name);
-    fprintf(stderr, "%s\n", msg);
+    fprintf(tok_b->scanner->diag, "In function call of \033[1;33m%s\033[0m! ", f_name);
+    fprintf(tok_b->scanner->diag, "%s\n", msg);
 }
 
 
-int parse_arg_expr(size_t *arg_cnt, prog_t *dst_code, 
+int parse_arg_expr(size_t *arg_cnt, ast_t *ast, ast_node_t *call,
                    symbol_tables_t *syms, tok_buffer_t *tok_b, 
                    tree_node_t *symbol) {
     
@@ -247,23 +242,25 @@ int parse_arg_expr(size_t *arg_cnt, prog_t *dst_code,
     }
 
     bool fcall;
-    int expr_retval = parse_expression(tok_b->scanner, syms, &ret_type, &fcall, dst_code);
+    ast_node_t *arg = NULL;
+    int expr_retval = parse_expression(tok_b->scanner, syms, &ret_type, &fcall, ast, &arg);
     if(expr_retval != EXPRESSION_SUCCESS) {
         str_dtor(&ret_type);
         return -expr_retval; /**< Negative return code means "Propagate it, but don't write err msg "*/
     }
 
     size_t u = 0;
-    token_t t = lookahead(tok_b->scanner);
+    tok_b->current = peek_token(tok_b->scanner, 0); //Nested parser took tokens of argument from scanner
+    token_t *t = tok_b->current;
     int ret = EXPRESSION_SUCCESS;
-    if(is_error_token(&t, &ret)) { 
+    if(is_error_token(t, &ret)) { 
         str_dtor(&ret_type);
         return ret;
     }
 
     if(!is_variadic) {
         while(*arg_cnt < param_num && u < len(&ret_type)) {
-            if(!is_compatible_in_arg(dst_code, params_s[*arg_cnt], to_str(&ret_type)[u])) { //Type check of epxression and argument and declared type
+            if(!is_compatible_in_arg(ast, &arg, params_s[*arg_cnt], to_str(&ret_type)[u])) { //Type check of epxression and argument and declared type
                 fcall_sem_error(tok_b, f_name, "Bad data types of arguments!");
                 str_dtor(&ret_type);
                 return SEMANTIC_ERROR_PARAMETERS_EXPR;
@@ -275,7 +272,7 @@ int parse_arg_expr(size_t *arg_cnt, prog_t *dst_code,
             u++;
             (*arg_cnt)++;
 
-            if(is_tok_type(SEPARATOR, &t), is_tok_attr(",", &t, tok_b)) { //If there is comma after, pick only one of function return values
+            if(is_tok_type(SEPARATOR, t), is_tok_attr(",", t, tok_b)) { //If there is comma after, pick only one of function return values
                 break;
             }
         }
@@ -284,11 +281,14 @@ int parse_arg_expr(size_t *arg_cnt, prog_t *dst_code,
             *arg_cnt += len(&ret_type) - u; //Add difference to recognize too many arguments (if they are comming from function, they can be disposed)
         }
 
-        if(u < len(&ret_type)) {
-            generate_dump_values(dst_code, u, len(&ret_type) - u); //Remove return values that are not used in function call
+        if(u < len(&ret_type) && !ast_dump(ast, &arg, u, len(&ret_type) - u)) { //Remove return values that are not used in function call
+            str_dtor(&ret_type);
+            return INTERNAL_ERROR;
         }
     }
-    
+
+    ast_append(&call->a, arg);
+
 
     str_dtor(&ret_type);
 
@@ -305,12 +305,12 @@ int after_argument(bool *closing_bracket, tree_node_t *symbol,
     bool is_variadic = (params_s[0] == '%') ? true : false; //In our case variadic means - with variable AMOUNT and TYPES of arguments
 
     //Check if there will be next argument
-    token_t t = lookahead(tok_b->scanner);
-    if(is_error_token(&t, &ret)) {
+    token_t *t = tok_b->current;
+    if(is_error_token(t, &ret)) {
         return ret;
     }
 
-    if(is_tok_type(SEPARATOR, &t) && is_tok_attr(",", &t, tok_b)) {
+    if(is_tok_type(SEPARATOR, t) && is_tok_attr(",", t, tok_b)) {
         if(cnt > strlen(params_s) && !is_variadic) { //Function needs less arguments
             fcall_sem_error(tok_b, f_name, "Too many arguments!");
             return SEMANTIC_ERROR_PARAMETERS_EXPR;
@@ -319,7 +319,7 @@ int after_argument(bool *closing_bracket, tree_node_t *symbol,
             //Ok
         }
     }
-    else if(is_tok_type(SEPARATOR, &t) && is_tok_attr(")", &t, tok_b)) {
+    else if(is_tok_type(SEPARATOR, t) && is_tok_attr(")", t, tok_b)) {
         *closing_bracket = true;
         if((cnt < strlen(params_s)) && !is_variadic) { //Function needs more arguments
             fcall_sem_error(tok_b, f_name, "Missing arguments!");
@@ -340,7 +340,7 @@ int after_argument(bool *closing_bracket, tree_node_t *symbol,
 }
 
 
-int argument_parser(prog_t *dst_code, tree_node_t *symbol, 
+int argument_parser(ast_t *ast, ast_node_t *call, tree_node_t *symbol, 
                     symbol_tables_t *syms, tok_buffer_t *tok_b) {
 
     int ret = EXPRESSION_SUCCESS;
@@ -354,20 +354,16 @@ int argument_parser(prog_t *dst_code, tree_node_t *symbol,
             return ret;
         }
 
-        token_t t = lookahead(tok_b->scanner);
-        if(is_error_token(&t, &ret)) {
-            return ret;
-        }
-        
-        if(!is_EOE(tok_b->scanner, &t) && !is_tok_attr(")", &t, tok_b)) {
+        token_t *t = tok_b->current;
+        if(!is_EOE(tok_b->scanner, t) && !is_tok_attr(")", t, tok_b)) {
             
-            ret = parse_arg_expr(&cnt, dst_code, syms, tok_b, symbol); //Check expression in argument
+            ret = parse_arg_expr(&cnt, ast, call, syms, tok_b, symbol); //Check expression in argument
             if(ret != EXPRESSION_SUCCESS) {
                 return ret;    
             }
 
         }
-        else if(is_tok_type(SEPARATOR, &t) && is_tok_attr(")", &t, tok_b)) { //End of argument list
+        else if(is_tok_type(SEPARATOR, t) && is_tok_attr(")", t, tok_b)) { //End of argument list
             closing_bracket = true;
             continue;
         }
@@ -390,28 +386,26 @@ int argument_parser(prog_t *dst_code, tree_node_t *symbol,
 }
 
 
-int fcall_parser(prog_t *dst_prog,
+int fcall_parser(ast_t *ast, ast_node_t *call,
                  tree_node_t *symbol, 
                  symbol_tables_t *syms, 
                  tok_buffer_t *tok_b) {
 
     int ret = EXPRESSION_SUCCESS;
-    if((ret = token_aging(tok_b)) != EXPRESSION_SUCCESS) {
+    token_t *t = peek_token(tok_b->scanner, 1); //Finding argument list and '(' after identifier
+    if(is_error_token(t, &ret)) {
         return ret;
     }
 
-    token_t t = lookahead(tok_b->scanner); //Finding argument list and '('
-    if(is_error_token(&t, &ret)) {
-        return ret;
-    }
-
-    if(!is_tok_type(SEPARATOR, &t) || !is_tok_attr("(", &t, tok_b)) { //Checking if there is '(' before arguments
-        tok_b->current = t;
+    if(!is_tok_type(SEPARATOR, t) || !is_tok_attr("(", t, tok_b)) { //Checking if there is '(' before arguments
         fcall_syn_error(tok_b, symbol->key, "Missing '(' after function indentifier!\n");
         return SYNTAX_ERROR_IN_EXPR;
     }
+    else if((ret = token_aging(tok_b)) != EXPRESSION_SUCCESS) { //Function identifier is processed
+        return ret;
+    }
     else {
-        ret = argument_parser(dst_prog, symbol, syms, tok_b); //Everything is ok, you can parse arguments
+        ret = argument_parser(ast, call, symbol, syms, tok_b); //Everything is ok, you can parse arguments
         if(ret != EXPRESSION_SUCCESS) {
             return ret;
         }
@@ -430,7 +424,7 @@ int process_identifier(p_parser_t *pparser,
                        tok_buffer_t *t_buff, 
                        symbol_tables_t *syms) { 
 
-    char *id_name = get_attr(&(t_buff->current), t_buff->scanner);
+    char *id_name = get_attr(t_buff->current, t_buff->scanner);
     expr_el_t *on_inp = &pparser->on_input;
     tree_node_t *symbol;
     symbol = deep_search(&syms->symtab_st, &syms->symtab, id_name); //Seaerching symbol in symbol tables with variables
@@ -445,15 +439,19 @@ int process_identifier(p_parser_t *pparser,
         }
         else {
             str_cpy((char **)&on_inp->value, id_name, strlen(id_name));
+
+            on_inp->node = ast_node(pparser->ast, AST_CALL);
+            if(!on_inp->node) {
+                return INTERNAL_ERROR;
+            }
+
+            on_inp->node->u.name = symbol->key; //Key in global symbol table lives as long as the tree
             //Process function call and arguments
-            int retval = fcall_parser(pparser->dst_code, symbol, syms, t_buff);
+            int retval = fcall_parser(pparser->ast, on_inp->node, symbol, syms, t_buff);
             if(retval != EXPRESSION_SUCCESS) {
                 return retval;
             }
 
-            //Current token attribute is restored to function name (for correct behaviour in precedence table)
-            t_buff->current.attr = symbol->key;
-
             //Function was succesfully called
             cpy_strings(&on_inp->dtype, &(symbol->data.ret_types), true);
             on_inp->is_fcall = true;
@@ -486,6 +484,8 @@ int from_input_token(p_parser_t *pparser,
     on_inp->value = NULL;
     on_inp->is_zero = false;
     on_inp->is_fcall = false;
+    on_inp->num = t_buff->current->num;
+    on_inp->node = NULL;
 
     if(str_init(&on_inp->dtype) != STR_SUCCESS) {
         return INTERNAL_ERROR;
@@ -493,13 +493,15 @@ int from_input_token(p_parser_t *pparser,
 
     int retval = EXPRESSION_SUCCESS;
     //Resolving data type of symbol on input
-    switch (t_buff->current.token_type)
+    switch (t_buff->current->token_type)
     {
         case INTEGER:
             retval = make_type_str(&on_inp->dtype, 'i');
+            num_range_warning(t_buff);
             break;
         case NUMBER:
             retval = make_type_str(&on_inp->dtype, 'n');
+            num_range_warning(t_buff);
             break;
         case STRING:
             retval = make_type_str(&on_inp->dtype, 's');
@@ -514,7 +516,7 @@ int from_input_token(p_parser_t *pparser,
 
             break;
         default:
-            if(is_nil(t_buff->scanner, &t_buff->current)) { //Checking if it is nil type
+            if(is_nil(t_buff->scanner, t_buff->current)) { //Checking if it is nil type
                 retval = make_type_str(&on_inp->dtype, 'z');
             }
             else {
@@ -529,13 +531,13 @@ int from_input_token(p_parser_t *pparser,
     }
 
     //Resolving zero flag (to prevent division by zero)
-    if(is_zero(t_buff->scanner, &t_buff->current) && PREVENT_ZERO_DIV) {
+    if(is_zero(t_buff->scanner, t_buff->current) && PREVENT_ZERO_DIV) {
         on_inp->is_zero = true;
     }
 
     //Making hard copy of token attribute
     if(on_inp->value == NULL) {
-        char * curr_val = get_attr(&(t_buff->current), t_buff->scanner);
+        char * curr_val = get_attr(t_buff->current, t_buff->scanner);
 
         retval = str_cpy((char **)&on_inp->value, curr_val, strlen(curr_val));
         if(retval != STR_SUCCESS) {
@@ -558,7 +560,8 @@ expr_el_t stop_symbol() {
         }, 
         .value = NULL, 
         .is_zero = false,
-        .is_fcall = false
+        .is_fcall = false,
+        .node = NULL
     };
 
     return stop_symbol;
@@ -573,7 +576,8 @@ expr_el_t prec_sign(char sign) {
             .length = 0, 
             .str = NULL
         },
-        .is_fcall = false
+        .is_fcall = false,
+        .node = NULL
     };
 
     switch(sign) {
@@ -611,7 +615,7 @@ expr_el_t operand() {
 
 
 char get_precedence(expr_el_t on_stack_top, expr_el_t on_input) {
-    static char precedence_table[TERM_NUM][TERM_NUM] = {
+    static const char precedence_table[TERM_NUM][TERM_NUM] = {
     //   #   _   ^   %   *   /   //  +   -  ..   <  <=   >  >=  ==  ~=   (   )   i   $
 /*_*/  {'<','<','>','>','>','>','>','>','>','>','>','>','>','>','>','>','<','>','<','>'},
 /*^*/  {'<','<','>','>','>','>','>','>','>','>','>','>','>','>','>','>','<','>','<','>'},
@@ -644,7 +648,7 @@ char get_precedence(expr_el_t on_stack_top, expr_el_t on_input) {
 
 
 char *to_char_sequence(expr_el_t expression_element) {
-    static char * cher_seq[] = {
+    static char * const cher_seq[] = {
         "#", "_", "^", "\045", "*", "/", "//", "+", "-", "..", "<", 
         "<=", ">", ">=", "==", "~=", "(", ")", "i", "$", "E", NULL
     };
@@ -655,12 +659,12 @@ char *to_char_sequence(expr_el_t expression_element) {
 /**
  * @see presedence_parser.h (get_rule()) to learn meaning of rule parts and see the exmaples
  */
-expr_rule_t *get_rule(unsigned int index) {
+const expr_rule_t *get_rule(unsigned int index) {
     if(index >= REDUCTION_RULES_NUM) { //Safety check
         return NULL;
     }
 
-    static expr_rule_t rules[REDUCTION_RULES_NUM] = {
+    static const expr_rule_t rules[REDUCTION_RULES_NUM] = {
         {"(E)", "*", ORIGIN, FIRST ,NULL ,NULL},
         {"i", "*", ORIGIN, FIRST, NULL ,NULL},
         {"E+E", "ni|ni", ORIGIN, ALL, "\"+\" expects numbers/integers as operands", generate_operation_add},
@@ -706,7 +710,7 @@ bool is_compatible(string_t *dtypes1, string_t *dtypes2) {
 }
 
 
-int resolve_res_type(string_t *res, expr_rule_t *rule,
+int resolve_res_type(string_t *res, const expr_rule_t *rule,
                       expr_el_t cur_op, bool cur_ok) {
 
     if(prim_type(res) == UNDEFINED) { //If result type was not set yet set it current operand data type
@@ -774,7 +778,7 @@ int op_type_ch(char c, bool must_be_flag, bool *is_curr_ok,
 
 
 //Presumes that macro EXPRESSION_SUCCESS is 0 !!!
-int type_check(pp_stack_t op_stack, expr_rule_t *rule, string_t *res_type) {
+int type_check(pp_stack_t op_stack, const expr_rule_t *rule, string_t *res_type) {
     bool is_curr_ok = false, must_be_flag = false;
     int ret = EXPRESSION_SUCCESS;
     expr_el_t current = safe_op_pop(&is_curr_ok, &ret, &op_stack); //Getting first operand from operand stack
@@ -867,7 +871,7 @@ int get_str_to_reduction(pp_stack_t *s, pp_stack_t *op, string_t *to_be_red) {
 }
 
 
-bool resolve_res_zero(pp_stack_t operands, expr_rule_t *rule) {
+bool resolve_res_zero(pp_stack_t operands, const expr_rule_t *rule) {
     switch(rule->zero_prop)
     {
     case NONE:
@@ -930,48 +934,103 @@ int non_term(expr_el_t *non_terminal, string_t *data_type, bool is_zero) {
 }
 
 
-int reduce(p_parser_t *pparser, pp_stack_t ops, symbol_tables_t *syms,
-           expr_rule_t *rule, string_t *res_type) {
-
-    //Todo fix function calls being generated as variables
-    prog_t *dst = pparser->dst_code;
-    if(str_cmp(rule->right_side, "i") == 0) {
-        expr_el_t element_terminal = pp_top(&ops);
+/**
+ * @brief Returns node of operand of reduced rule (operands are numbered from the left)
+ */
+static ast_node_t *operand_node(pp_stack_t *ops, int index) {
+    expr_el_t *operand = pp_get_ptr(ops, (int)ops->top - 1 - index); //The leftmost operand is at the top
+    return operand ? operand->node : NULL;
+}
 
-        tree_node_t *res = deep_search(&syms->symtab_st, &syms->symtab, element_terminal.value);
-        if(element_terminal.is_fcall) {
-            //Only function was called during reduction 
-            res = search(&syms->global, element_terminal.value);
 
-            pparser->was_f_call = true;
-            pparser->last_call_ret_num = len(&(res->data.ret_types));
+/**
+ * @brief Creates leaf of expression tree from reduced operand (literal, variable or function call)
+ */
+static ast_node_t *operand_leaf(p_parser_t *pparser, expr_el_t *element_terminal, 
+                                symbol_tables_t *syms) {
+
+    ast_t *ast = pparser->ast;
+    ast_node_t *node;
+    tree_node_t *res = deep_search(&syms->symtab_st, &syms->symtab, element_terminal->value);
+    if(element_terminal->is_fcall) {
+        //Only function was called during reduction 
+        res = search(&syms->global, element_terminal->value);
+
+        pparser->was_f_call = true;
+        pparser->last_call_ret_num = len(&(res->data.ret_types));
+
+        node = element_terminal->node; //Node with arguments was created, when function call was parsed
+    }
+    else if(res == NULL) {
+        //We are pushing a static value
+        char prim_dtype_c = to_str(&element_terminal->dtype)[0];
+        sym_dtype_t dtype = char_to_dtype(prim_dtype_c);
+
+        if(dtype == INT || dtype == NUM) { //Numeric literals were already converted by scanner
+            node = ast_node(ast, AST_NUM);
+            if(node) {
+                node->u.num = element_terminal->num;
+            }
+        }
+        else {
+            node = ast_node(ast, AST_VAL);
+            if(node && !(node->u.name = ast_str(ast, element_terminal->value))) {
+                node = NULL;
+            }
+        }
 
-            generate_call_function(dst, element_terminal.value);
+        if(node) {
+            node->m = dtype;
+        }
+    }
+    else {
+        //We are pushing variable (its name must outlive symbol table of current block)
+        node = ast_node(ast, AST_VAR);
+        if(node && !(node->u.name = ast_str(ast, to_str(&res->data.name)))) {
+            node = NULL;
         }
-        else if(res == NULL) {
-            //We are pushing a static value
 
-            char prim_dtype_c = to_str(&element_terminal.dtype)[0];
-            sym_dtype_t dtype = char_to_dtype(prim_dtype_c);
-            
-            //We are pushing a static value
-            generate_value_push(dst, VAL, dtype, element_terminal.value);
+        if(node) {
+            node->m = res->data.dtype;
         }
-        else{
-            //We are pushing variable
-            generate_value_push(dst, VAR, res->data.dtype , res->data.name.str);
+    }
+
+    return node;
+}
+
+
+int reduce(p_parser_t *pparser, pp_stack_t ops, symbol_tables_t *syms,
+           const expr_rule_t *rule, string_t *res_type) {
+
+    ast_node_t *node;
+    if(str_cmp(rule->right_side, "i") == 0) {
+        expr_el_t element_terminal = pp_top(&ops);
+        node = operand_leaf(pparser, &element_terminal, syms);
+    }
+    else if(rule->generator_function != NULL) {
+        //Operation is generated after its operands (@see codegen_expression())
+        node = ast_node(pparser->ast, AST_OP);
+        if(node) {
+            node->n = rule - get_rule(0);
+            node->a = operand_node(&ops, 0);
+            node->b = operand_node(&ops, 1);
         }
     }
+    else {
+        node = operand_node(&ops, 0); //Brackets don't need any node
+    }
 
-    //Generate operation code
-    if(rule->generator_function != NULL)
-        rule->generator_function(dst);
+    if(!node) {
+        return INTERNAL_ERROR;
+    }
 
     bool will_be_zero = resolve_res_zero(ops, rule);
     expr_el_t non_terminal;
     if(non_term(&non_terminal, res_type, will_be_zero) != EXPRESSION_SUCCESS) {
         return INTERNAL_ERROR;
     }
+
+    non_terminal.node = node;
     if(!pp_push(&pparser->stack, non_terminal)) { /**< Make non terminal at the top of main stack (with corresponding zero flag)*/
         return INTERNAL_ERROR;
     }
@@ -983,7 +1042,7 @@ int reduce(p_parser_t *pparser, pp_stack_t ops, symbol_tables_t *syms,
 }
 
 
-void only_primary_type(string_t *ret_types, expr_rule_t *rule) {
+void only_primary_type(string_t *ret_types, const expr_rule_t *rule) {
     if(str_cmp("i", rule->right_side) != 0 && 
        str_cmp("(E)", rule->right_side) != 0) {
         cut_string(ret_types, 1);
@@ -1006,7 +1065,7 @@ int reduce_top(p_parser_t *pparser, symbol_tables_t *syms,
 
     int ret;
     ret = get_str_to_reduction(&(pparser->stack), &operands, &to_be_reduced);
-    expr_rule_t *rule;
+    const expr_rule_t *rule;
     if(ret == EXPRESSION_SUCCESS) {
         ret = EXPRESSION_FAILURE; /**< If rule is not found it is invalid operation -> return EXPR_FAILURE */
         for(int i = 0; (rule = get_rule(i)); i++) {
@@ -1036,10 +1095,10 @@ int reduce_top(p_parser_t *pparser, symbol_tables_t *syms,
 
 
 int get_input_symbol(p_parser_t *pparser, tok_buffer_t *t_buff, 
-                     symbol_tables_t *symtabs, prog_t *dst) {
+                     symbol_tables_t *symtabs) {
 
     int retval = EXPRESSION_SUCCESS;
-    if(pparser->stop_flag || is_EOE(t_buff->scanner, &(t_buff->current))) {
+    if(pparser->stop_flag || is_EOE(t_buff->scanner, t_buff->current)) {
         pparser->on_input = stop_symbol(); //If there is end of expression, put stop symbol to input
     }
     else {
@@ -1052,7 +1111,12 @@ int get_input_symbol(p_parser_t *pparser, tok_buffer_t *t_buff,
     if(pparser->was_f_call && !pparser->only_f_was_called) {
         //Clear stack to calculate only first return value
         size_t pop_cnt = (pparser->last_call_ret_num > 0) ? pparser->last_call_ret_num - 1 : pparser->last_call_ret_num;
-        generate_dump_values(dst, 1, pop_cnt);
+
+        //Function call was reduced right before, so it is at the top of the stack
+        expr_el_t *f_call = pp_get_ptr(&pparser->stack, (int)pparser->stack.top - 1);
+        if(!f_call || !ast_dump(pparser->ast, &f_call->node, 1, pop_cnt)) {
+            return INTERNAL_ERROR;
+        }
     }
 
     pparser->was_f_call = false; /**< New input symbol -> reset function call flag */
@@ -1086,7 +1150,7 @@ void free_everything(p_parser_t *pparser) {
         str_dtor(&(current_el.dtype));
         //Freeing attributes of stored elements in garbage collector stack (if it is dynamicaly allocated)
         if(current_el.type != NON_TERM) {
-            free(current_el.value);
+            mem_free(current_el.value);
         }
     }
     
@@ -1096,11 +1160,12 @@ void free_everything(p_parser_t *pparser) {
 
 
 int token_aging(tok_buffer_t *token_buffer) {
-    token_buffer->last = token_buffer->current; //Make current token older
-    token_buffer->current = get_next_token(token_buffer->scanner);
+    token_buffer->last = *token_buffer->current; //Make current token older
+    get_next_token(token_buffer->scanner); //Current token is in lookahead buffer of scanner, so it is only removed
+    token_buffer->current = peek_token(token_buffer->scanner, 0);
 
     int ret = EXPRESSION_SUCCESS;
-    if(is_error_token(&token_buffer->current, &ret)) {
+    if(is_error_token(token_buffer->current, &ret)) {
         return ret;
     }
 
@@ -1142,7 +1207,7 @@ void print_err_message(int *return_value,
 
     pos_t r = token_buffer->scanner->cursor_pos[ROW]; //Position of scanner cursor
     pos_t c = token_buffer->scanner->cursor_pos[COL];
-    char * attr = get_attr(&(token_buffer->current), token_buffer->scanner); //Attribute of current token
+    char * attr = get_attr(token_buffer->current, token_buffer->scanner); //Attribute of current token
 
     switch(*return_value)
     {
@@ -1150,43 +1215,43 @@ void print_err_message(int *return_value,
         break;
 
     case INTERNAL_ERROR:
-        fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| \033[1;31mInternal error:\033[0m ", r, c);
-        fprintf(stderr, "An error ocurred during precedence parsing!\n");
+        fprintf(token_buffer->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t| \033[1;31mInternal error:\033[0m ", r, c);
+        fprintf(token_buffer->scanner->diag, "An error ocurred during precedence parsing!\n");
         break;
 
     case SEM_ERROR_IN_EXPR:
-        fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSemantic error:\033[0m ", r, c);
-        fprintf(stderr, "Bad data types in expression!\n");
+        fprintf(token_buffer->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSemantic error:\033[0m ", r, c);
+        fprintf(token_buffer->scanner->diag, "Bad data types in expression!\n");
         if(*err_m) {
-            fprintf(stderr, "\t| \033[0;33m%s\033[0m\n", *err_m);
+            fprintf(token_buffer->scanner->diag, "\t| \033[0;33m%s\033[0m\n", *err_m);
         }
 
         break;
 
     case UNDECLARED_IDENTIFIER:
-        fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSemantic error:\033[0m ", r, c);
-        fprintf(stderr, "Undeclared identifier \"\033[1;33m%s\033[0m\"!\n", attr);
+        fprintf(token_buffer->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSemantic error:\033[0m ", r, c);
+        fprintf(token_buffer->scanner->diag, "Undeclared identifier \"\033[1;33m%s\033[0m\"!\n", attr);
         break;
 
     case NIL_ERROR:
-        fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSemantic (nil) error:\033[0m ", r, c);
-        fprintf(stderr, "Cannot use nil in expression like this!\n");
+        fprintf(token_buffer->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSemantic (nil) error:\033[0m ", r, c);
+        fprintf(token_buffer->scanner->diag, "Cannot use nil in expression like this!\n");
         break;
     
     case DIV_BY_ZERO:
-        fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mDivision by zero:\033[0m ", r, c);
-        fprintf(stderr, "Cannot divide by zero!\n");
+        fprintf(token_buffer->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mDivision by zero:\033[0m ", r, c);
+        fprintf(token_buffer->scanner->diag, "Cannot divide by zero!\n");
         break;
 
     case EXPRESSION_FAILURE:
-        fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSyntax error:\033[0m ", r, c);
-        fprintf(stderr, "Invalid combination of tokens in expression! (nearby \"\033[1;33m%s\033[0m\")\n", attr);
+        fprintf(token_buffer->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSyntax error:\033[0m ", r, c);
+        fprintf(token_buffer->scanner->diag, "Invalid combination of tokens in expression! (nearby \"\033[1;33m%s\033[0m\")\n", attr);
         *return_value = SYNTAX_ERROR_IN_EXPR;
         break;
 
     case MISSING_EXPRESSION:
-        fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSyntax error:\033[0m ", r, c);
-        fprintf(stderr, "Expected expression, but it was not found! (found \"\033[1;33m%s\033[0m\" instead)\n", attr);
+        fprintf(token_buffer->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t| \033[0;31mSyntax error:\033[0m ", r, c);
+        fprintf(token_buffer->scanner->diag, "Expected expression, but it was not found! (found \"\033[1;33m%s\033[0m\" instead)\n", attr);
         *return_value = SYNTAX_ERROR_IN_EXPR;
         break;
 
@@ -1204,20 +1269,53 @@ void undefined_var_warning(tok_buffer_t *token_buffer, char *variable_name) {
         pos_t r = token_buffer->scanner->cursor_pos[ROW]; //Position of scanner cursor
         pos_t c = token_buffer->scanner->cursor_pos[COL];
 
-        fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| \033[1;33mWarning:\033[0m ", r, c);
-        fprintf(stderr, "Uninitialized variable '\033[1;33m%s\033[0m'! It is implicitly nil (but is not nil type)!\n", variable_name);
+        token_buffer->scanner->warn_cnt++;
+        fprintf(token_buffer->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t| \033[1;33mWarning:\033[0m ", r, c);
+        fprintf(token_buffer->scanner->diag, "Uninitialized variable '\033[1;33m%s\033[0m'! It is implicitly nil (but is not nil type)!\n", variable_name);
+    }
+}
+
+
+void num_range_warning(tok_buffer_t *token_buffer) {
+    token_t *tok = token_buffer->current;
+
+    bool out_of_range = false;
+    if(tok->token_type == NUMBER) {
+        out_of_range = isinf(tok->num.number);
+    }
+    else if(tok->token_type == INTEGER && tok->num.integer == LLONG_MAX) { //Saturated value, it must be checked again
+        attr_view_t literal = get_attr_view(tok, token_buffer->scanner);
+        parse_integer(literal.str, literal.len, &out_of_range);
+    }
+
+    if(out_of_range && PRINT_EXPR_WARNINGS) {
+        char *literal = get_attr(tok, token_buffer->scanner);
+
+        pos_t r = token_buffer->scanner->cursor_pos[ROW]; //Position of scanner cursor
+        pos_t c = token_buffer->scanner->cursor_pos[COL];
+
+        token_buffer->scanner->warn_cnt++;
+        fprintf(token_buffer->scanner->diag, "(\033[1;37m%lu:%lu\033[0m)\t| \033[1;33mWarning:\033[0m ", r, c);
+        if(tok->token_type == NUMBER) {
+            fprintf(token_buffer->scanner->diag, "Numeric literal '\033[1;33m%s\033[0m' is out of compilers range. It will be truncated to %e\n", literal, DBL_MAX);
+        }
+        else {
+            fprintf(token_buffer->scanner->diag, "Numeric literal '\033[1;33m%s\033[0m' is out of compilers range. It will be truncated to %lld\n", literal, LLONG_MAX);
+        }
+
+        fprintf(token_buffer->scanner->diag, "\t| Check your interpret if it supports as big numbers as this!\n");
     }
 }
 
 
 void prepare_buffer(scanner_t *sc, tok_buffer_t *tok_b) {
     tok_b->scanner = sc;
-    token_init(&(tok_b->current));
+    tok_b->current = peek_token(sc, 0);
     token_init(&(tok_b->last));
 }
 
 
-int prepare_pp(prog_t *dst, p_parser_t *pp) {
+int prepare_pp(ast_t *ast, p_parser_t *pp) {
     if(!pp_stack_init(&pp->stack) || !pp_stack_init(&pp->garbage)) {
         return INTERNAL_ERROR;
     }
@@ -1236,18 +1334,18 @@ int prepare_pp(prog_t *dst, p_parser_t *pp) {
     pp->only_f_was_called = true;
 
     pp->last_call_ret_num = 0;
-    pp->dst_code = dst;
+    pp->ast = ast;
 
     return EXPRESSION_SUCCESS;
 }
 
 
 int update_structs(scanner_t *sc, symbol_tables_t *s, 
-                   tok_buffer_t *tok_buff, p_parser_t *pparser, prog_t *dst) {
+                   tok_buffer_t *tok_buff, p_parser_t *pparser) {
 
     int ret = EXPRESSION_SUCCESS;
-    tok_buff->current = lookahead(sc);
-    if(is_error_token(&tok_buff->current, &ret)) {
+    tok_buff->current = peek_token(sc, 0);
+    if(is_error_token(tok_buff->current, &ret)) {
         return ret;
     }
 
@@ -1256,7 +1354,7 @@ int update_structs(scanner_t *sc, symbol_tables_t *s,
         return ret;
     }
 
-    ret = get_input_symbol(pparser, tok_buff, s, dst); //Update input symbol
+    ret = get_input_symbol(pparser, tok_buff, s); //Update input symbol
     if(ret != EXPRESSION_SUCCESS) {
         return ret;
     }
@@ -1284,7 +1382,7 @@ bool is_end_of_parsing(p_parser_t *pparser, int *return_value) {
 
 
 int parse_expression(scanner_t *sc, symbol_tables_t *s, string_t *dtypes, 
-                     bool *is_only_f_call, prog_t *dst) {
+                     bool *is_only_f_call, ast_t *ast, ast_node_t **expr) {
 
     int ret = EXPRESSION_SUCCESS;
     char *failed_op_msg = NULL;
@@ -1292,14 +1390,15 @@ int parse_expression(scanner_t *sc, symbol_tables_t *s, string_t *dtypes,
     tok_buffer_t tok_buff;
     prepare_buffer(sc, &tok_buff);
 
+    *expr = NULL;
     p_parser_t pparser;
-    ret = prepare_pp(dst, &pparser);
+    ret = prepare_pp(ast, &pparser);
     if(ret != EXPRESSION_SUCCESS) {
         return ret;
     }
     
     while(ret == EXPRESSION_SUCCESS) { //Main cycle
-        ret = update_structs(sc, s, &tok_buff, &pparser, dst);
+        ret = update_structs(sc, s, &tok_buff, &pparser);
         if(ret != EXPRESSION_SUCCESS) {
             break;
         }
@@ -1344,6 +1443,9 @@ int parse_expression(scanner_t *sc, symbol_tables_t *s, string_t *dtypes,
     }
 
     *is_only_f_call = pparser.only_f_was_called;
+    if(ret == EXPRESSION_SUCCESS) { //Whole expression was reduced to one nonterminal
+        *expr = pp_top(&pparser.stack).node;
+    }
 
     //Print error msg to terminal or adjust error code and free resources
     print_err_message(&ret, &tok_buff, &failed_op_msg);
@@ -22,6 +22,7 @@
 
 #include "scanner.h"
 #include "generator.h"
+#include "ast.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -52,8 +53,8 @@
  */ 
 typedef struct tok_buffer {
     scanner_t *scanner;
-    token_t last;
-    token_t current;
+    token_t last; /**< Copy of the last processed token */
+    token_t *current; /**< Token on input (it is still in lookahead buffer of scanner, @see peek_token()) */
 } tok_buffer_t;
 
 
@@ -77,7 +78,9 @@ typedef struct expr_el {
     string_t dtype; /**< Data type of element in expression (string, integer, number) */
     bool is_zero;
     void *value; /**< Value of element (or pointer to symbol table) */
+    num_value_t num; /**< Value of numeric literal (parsed by scanner) */
     bool is_fcall;
+    ast_node_t *node; /**< Node of operand or subexpression in AST (NULL if it is not operand) */
 } expr_el_t;
 
 
@@ -102,7 +105,7 @@ typedef struct p_parser {
 
     size_t last_call_ret_num; /**< Number of return values of last called function */
 
-    prog_t *dst_code; /**< Poiter to code where should be printed instructions */
+    ast_t *ast; /**< Tree, where nodes of expression are created */
 } p_parser_t;
 
 
@@ -183,8 +186,9 @@ sym_dtype_t prim_type(string_t *type_string);
 
 /**
  * @brief Checks copatibility of data type string (returned from function or expression) and arg. type
+ * @note If integer is given to number parameter, argument is converted (@see ast_int2num())
  */ 
-bool is_compatible_in_arg(prog_t *prog, char par_type, char arg_type);
+bool is_compatible_in_arg(ast_t *ast, ast_node_t **arg, char par_type, char arg_type);
 
 
 /**
@@ -213,8 +217,9 @@ void fcall_syn_error(tok_buffer_t *tok_b, char *f_name, char *msg);
 
 /**
  * @brief Parses just one expression (argument) in function call
+ * @param call Node of function call, parsed argument is appended to it
  */ 
-int parse_arg_expr(size_t *arg_cnt, prog_t *dst_code, 
+int parse_arg_expr(size_t *arg_cnt, ast_t *ast, ast_node_t *call,
                    symbol_tables_t *syms, tok_buffer_t *tok_b, 
                    tree_node_t *symbol);
 
@@ -228,7 +233,7 @@ int after_argument(bool *closing_bracket, tree_node_t *symbol,
 /**
  * @brief Parses arguments in function call in expression (checks separators and expressions)
  */ 
-int argument_parser(prog_t *dst_code, 
+int argument_parser(ast_t *ast, ast_node_t *call,
                     tree_node_t *symbol,
                     symbol_tables_t *syms,
                     tok_buffer_t *tok_b);
@@ -237,7 +242,7 @@ int argument_parser(prog_t *dst_code,
  * @brief Parses function call inside expression (check if there is '(' whe nfunction is called)
  * @return EXPRESSION_SUCCESS if wverything was ok
  */ 
-int fcall_parser(prog_t *dst_prog,
+int fcall_parser(ast_t *ast, ast_node_t *call,
                  tree_node_t *symbol, 
                  symbol_tables_t *syms, 
                  tok_buffer_t *tok_b);
@@ -305,7 +310,7 @@ char *to_char_sequence(expr_el_t expression_element);
  *       ) returns from "must_be" mode to normal mode 
  *       Example: (nis|nis = First and sec operand can be number/integer/string and if it's e. g. string second must be string too
  */ 
-expr_rule_t *get_rule(unsigned int index);
+const expr_rule_t *get_rule(unsigned int index);
 
 
 /**
@@ -324,7 +329,7 @@ bool is_compatible(string_t *dtypes1, string_t *dtypes2);
  * @brief Resolves which data type attribut should have newly created nonterminal on stack
  * @return INTERNAL_ERROR if an error occurs otherwise EXPRESSION SUCCESS
  */ 
-int resolve_res_type(string_t *res, expr_rule_t *rule, 
+int resolve_res_type(string_t *res, const expr_rule_t *rule, 
                       expr_el_t cur_op, bool cur_ok);
 
 
@@ -347,7 +352,7 @@ int op_type_ch(char c, bool must_be_flag, bool *is_curr_ok,
  * @brief Performs type checking when precedence parser reducing the top of the stack
  * @note Type check is based on rules writen in get_rule() ( @see get_rule())
  */
-int type_check(pp_stack_t op_stack, expr_rule_t *rule, string_t *res_type);
+int type_check(pp_stack_t op_stack, const expr_rule_t *rule, string_t *res_type);
 
 
 /**
@@ -360,13 +365,13 @@ int get_str_to_reduction(pp_stack_t *s, pp_stack_t *op, string_t *to_be_red);
 /**
  * @brief Determines if result of reduction will be zero value (in some cases it is possible to find out it if is)
  */ 
-bool resolve_res_zero(pp_stack_t operands, expr_rule_t *rule);
+bool resolve_res_zero(pp_stack_t operands, const expr_rule_t *rule);
 
 
 /**
  * @brief Determines if result of reduction will be zero value (in some cases it is possible to find out it if is)
  */ 
-bool resolve_res_zero(pp_stack_t operands, expr_rule_t *rule);
+bool resolve_res_zero(pp_stack_t operands, const expr_rule_t *rule);
 
 
 /**
@@ -381,7 +386,7 @@ int non_term(expr_el_t *non_terminal, string_t *data_type, bool is_zero);
  * @param rule Rule containing information about result type and operand data types
  */  
 int reduce(p_parser_t *pparser, pp_stack_t ops, symbol_tables_t *syms, 
-           expr_rule_t *rule, string_t *res_type);
+           const expr_rule_t *rule, string_t *res_type);
 
 
 /**
@@ -404,8 +409,7 @@ int reduce_top(p_parser_t *pparser, symbol_tables_t *syms,
  */ 
 int get_input_symbol(p_parser_t *pparser, 
                      tok_buffer_t *t_buff, 
-                     symbol_tables_t *symtabs,
-                     prog_t *dst);
+                     symbol_tables_t *symtabs);
 
 
 /**
@@ -445,6 +449,12 @@ void print_err_message(int *return_value, tok_buffer_t *token_buffer,
 void undefined_var_warning(tok_buffer_t *token_buffer, char *variable_name);
 
 
+/**
+ * @brief Prints warning if numeric (or integer) literal is out of range of compiler (it is truncated by generator)
+ */ 
+void num_range_warning(tok_buffer_t *token_buffer);
+
+
 /**
  * @brief Inits all parts of auxiliary structure tok_buffer_t
  */ 
@@ -453,16 +463,16 @@ void prepare_buffer(scanner_t *sc, tok_buffer_t *tok_b);
 
 /**
  * @brief Prepare necessary stacks before their usage in precedence parser
- * @param dst Pointer to program structure in which are instructions printed
+ * @param ast Tree, where nodes of expression are created
  */ 
-int prepare_pp(prog_t *dst, p_parser_t *pp);
+int prepare_pp(ast_t *ast, p_parser_t *pp);
 
 
 /**
  * @brief Updates parser structs and current token int token_buffer in main cycle
  */ 
 int update_structs(scanner_t *sc, symbol_tables_t *s, 
-                   tok_buffer_t *tok_buff, p_parser_t *pparser, prog_t *dst);
+                   tok_buffer_t *tok_buff, p_parser_t *pparser);
 
 
 /**
@@ -479,9 +489,12 @@ bool is_end_of_parsing(p_parser_t *pparser, int *return_value);
  *               specifies return types of expression
  * @param is_only_f_call Output parameter, will be set to true, if was ONLY 
  *                       function called inside expression (there aren't any other operations)
+ * @param expr Output parameter, it is set to the root of tree of parsed expression (nodes are allocated from ast)
+ * @note Code is not generated here (@see codegen_expression())
  */
 int parse_expression(scanner_t *sc, symbol_tables_t *s, 
-                     string_t *dtypes, bool *is_only_f_call, prog_t *dst_code);
+                     string_t *dtypes, bool *is_only_f_call, 
+                     ast_t *ast, ast_node_t **expr);
 
 
 #endif
@@ -0,0 +1,58 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                 prelude.c
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *   Purpose: Splicing of helper and builtin functions rendered at build time
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file prelude.c
+ * @brief Splicing of helper and builtin functions rendered at build time
+ * @note Code is rendered by mkprelude (@see mkprelude.c) with the same functions of generator,
+ *       that were used during every compilation before
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#include "generator.h"
+#include "symtable.h"
+#include "compiler.h"
+#include "prelude_blobs.h"
+#include "build_salt.h"
+
+#include <string.h>
+
+
+void generate_init(prog_t *dst) {
+    app_instr_static(dst, prelude_text, sizeof(prelude_text) - 1);
+}
+
+
+int generate_builtin(prog_t *dst, symtab_t *symtab) {
+    //Only used builtin functions are generated (symtab should be global)
+    for(size_t i = 0; i < sizeof(builtin_blobs) / sizeof(prelude_blob_t); i++) {
+        if(search(symtab, builtin_blobs[i].name) != NULL) {
+            app_instr_static(dst, builtin_blobs[i].text, builtin_blobs[i].len);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+uint64_t codegen_salt() {
+    uint64_t salt = BUILD_SALT;
+
+    uint64_t hash = hash_bytes(COMPILER_VERSION, strlen(COMPILER_VERSION), HASH_INIT);
+
+    return hash_bytes(&salt, sizeof(salt), hash);
+}
+
+
+/***                             End of prelude.c                          ***/
@@ -18,28 +18,32 @@
 
 #include "scanner.h"
 
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+
 
 DSTACK(token_t, tok, fprintf(stderr," %ld", s->data[i].first_ch_index)) /**< Token buffer definition */
 
 
 /**
- * @brief Prints lexical error message to stderr
+ * @brief Prints lexical error message to diagnostic stream of scanner
  */ 
 void lex_err(scanner_t *sc, token_t *bad_token) {
-    fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| ", (sc->cursor_pos[ROW]), (sc->cursor_pos[COL]));
-    fprintf(stderr, "\033[0;31mLexical error:\033[0m ");
-    fprintf(stderr, "Invalid token '\033[1;33m%s\033[0m'!\n", get_attr(bad_token, sc));
+    fprintf(sc->diag, "(\033[1;37m%lu:%lu\033[0m)\t| ", (sc->cursor_pos[ROW]), (sc->cursor_pos[COL]));
+    fprintf(sc->diag, "\033[0;31mLexical error:\033[0m ");
+    fprintf(sc->diag, "Invalid token '\033[1;33m%s\033[0m'!\n", get_attr(bad_token, sc));
 
 }
 
 
 /**
- * @brief Prints internal error message to stderr
+ * @brief Prints internal error message to diagnostic stream of scanner
  */
 void int_err(scanner_t *sc) {
-    fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| ", (sc->cursor_pos[ROW]), (sc->cursor_pos[COL]));
-    fprintf(stderr, "\033[1;31mInternal error:\033[0m ");
-    fprintf(stderr, "Internal error in scanner occured!\n");
+    fprintf(sc->diag, "(\033[1;37m%lu:%lu\033[0m)\t| ", (sc->cursor_pos[ROW]), (sc->cursor_pos[COL]));
+    fprintf(sc->diag, "\033[1;31mInternal error:\033[0m ");
+    fprintf(sc->diag, "Internal error in scanner occured!\n");
 }
 
 
@@ -50,44 +54,192 @@ void token_init(token_t *token) {
     token->token_type = UNKNOWN;
     token->attr = NULL;
     token->first_ch_index = UNSET;
+    token->length = 0;
+    token->attr_id = UNSET;
+    token->num.integer = 0;
+}
+
+
+/**
+ * @brief Allocates space for attribute in store of scanner
+ * @return Pointer to allocated space or NULL if allocation failed
+ */
+char *attr_alloc(scanner_t *sc, size_t size) {
+    attr_chunk_t *cur = sc->attr_store;
+    if(!cur || cur->size - cur->used < size) { //Current chunk is full -> new one is created (old chunks are kept, so attributes does not move)
+        size_t chunk_size = size > ATTR_CHUNK_SIZE ? size : ATTR_CHUNK_SIZE;
+        attr_chunk_t *new_chunk = malloc(sizeof(attr_chunk_t) + chunk_size);
+        if(!new_chunk) {
+            return NULL;
+        }
+
+        new_chunk->data = (char *)(new_chunk + 1);
+        new_chunk->size = chunk_size;
+        new_chunk->used = 0;
+        new_chunk->next = cur;
+        sc->attr_store = cur = new_chunk;
+    }
+
+    char *result = &cur->data[cur->used];
+    cur->used += size;
+
+    return result;
+}
+
+
+/**
+ * @brief Frees all chunks of attribute store except the current one (if keep_current is true)
+ */
+void attr_store_reset(scanner_t *sc, bool keep_current) {
+    attr_chunk_t *cur = sc->attr_store;
+    if(!cur) {
+        return;
+    }
+
+    attr_chunk_t *to_free = keep_current ? cur->next : cur;
+    while(to_free) {
+        attr_chunk_t *next = to_free->next;
+        free(to_free);
+        to_free = next;
+    }
+
+    if(keep_current) {
+        cur->next = NULL;
+        cur->used = 0;
+    }
+    else {
+        sc->attr_store = NULL;
+    }
 }
 
 
 char * get_attr(token_t *token, scanner_t *sc) {
-    if(token->attr) { //Token attribute is not stored in token buffer (e.g. in table of predefined symbols)
+    if(token->attr) { //Token attribute is not in source code (e.g. in table of predefined symbols) or it was already copied
         return token->attr;
     }
+
+    char *attr = attr_alloc(sc, token->length + 1);
+    if(!attr) {
+        int_err(sc);
+        return "";
+    }
+
+    memcpy(attr, &sc->src[token->first_ch_index], token->length);
+    attr[token->length] = '\0';
+    token->attr = attr;
+
+    return attr;
+}
+
+
+attr_view_t get_attr_view(token_t *token, scanner_t *sc) {
+    attr_view_t view;
+    if(token->attr) {
+        view.str = token->attr;
+        view.len = strlen(token->attr);
+    }
     else {
-        return &(to_str(&sc->str_buffer)[token->first_ch_index]);
+        view.str = &sc->src[token->first_ch_index];
+        view.len = token->length;
     }
+
+    return view;
+}
+
+
+bool attr_view_eq(attr_view_t view, const char *str) {
+    return strncmp(view.str, str, view.len) == 0 && str[view.len] == '\0';
 }
 
 
 /**
  * @brief Prepares scanner structure and sets its attributes to initial values
  */
-int scanner_init(scanner_t *sc) {
+int scanner_init_buffer(scanner_t *sc, const char *src, size_t src_len) {
+    sc->src = src;
+    sc->src_len = src_len;
+    sc->src_pos = 0;
+    sc->src_owned = NULL;
+    sc->diag = stderr;
+
     sc->state = INIT;
     sc->is_input_buffer_full = false;
 
-    sc->is_tok_buffer_full = false;
+    sc->la_head = 0;
+    sc->la_count = 0;
+
+    sc->replay = NULL;
+    sc->replay_len = 0;
+    sc->replay_next = 0;
+    sc->warn_cnt = 0;
 
     sc->cursor_pos[ROW] = 1;
     sc->cursor_pos[COL] = 1;
 
-    if(str_init(&sc->str_buffer) != STR_SUCCESS) { //Error during buffer initialization occured
-        int_err(sc);
+    sc->attr_store = NULL;
+    sc->first_ch_index = UNSET;
+    sc->ch_index = 0;
+
+    return EXIT_SUCCESS;
+}
+
+
+#define INPUT_CHUNK_SIZE 4096 /**< Size of chunks, in which is input stream read */
+
+int read_stream(FILE *stream, char **dst, size_t *length) {
+    char *input = NULL;
+    size_t alloc_size = 0, got;
+    *length = 0;
+    do {
+        if(*length + INPUT_CHUNK_SIZE > alloc_size) {
+            alloc_size = alloc_size ? alloc_size * 2 : INPUT_CHUNK_SIZE;
+            char *extended = realloc(input, alloc_size);
+            if(!extended) {
+                free(input);
+                return INTERNAL_ERROR;
+            }
+
+            input = extended;
+        }
+
+        got = fread(&input[*length], sizeof(char), INPUT_CHUNK_SIZE, stream);
+        *length += got;
+    } while(got == INPUT_CHUNK_SIZE);
+
+    if(ferror(stream)) {
+        free(input);
         return INTERNAL_ERROR;
     }
 
-    sc->first_ch_index = UNSET;
+    *dst = input;
 
     return EXIT_SUCCESS;
 }
 
+
+/**
+ * @brief Reads the whole stdin to buffer, that is owned by scanner
+ */
+int scanner_init(scanner_t *sc) {
+    char *input = NULL;
+    size_t length = 0;
+    if(read_stream(stdin, &input, &length) != EXIT_SUCCESS) {
+        fprintf(stderr, "\033[1;31mInternal error:\033[0m Cannot read the input!\n");
+        return INTERNAL_ERROR;
+    }
+
+    int ret = scanner_init_buffer(sc, input, length);
+    sc->src_owned = input;
+
+    return ret;
+}
+
 void scanner_dtor(scanner_t *sc) {
     sc->first_ch_index = UNSET;
-    str_dtor(&sc->str_buffer);
+    attr_store_reset(sc, false);
+
+    free(sc->src_owned);
+    sc->src_owned = NULL;
 }
 
 
@@ -118,7 +270,7 @@ void update_cursor_pos(char c, scanner_t *sc) {
 
 
 /**
- * @brief Reads character from stdin (or from input buffer)
+ * @brief Reads character from source code (or from input buffer)
  */
 char next_char(scanner_t *sc) {
     char next;
@@ -127,7 +279,8 @@ char next_char(scanner_t *sc) {
         sc->is_input_buffer_full = false;
     }
     else {
-        next = getchar();
+        sc->ch_index = sc->src_pos;
+        next = (sc->src_pos < sc->src_len) ? sc->src[sc->src_pos++] : EOF;
         update_cursor_pos(next, sc);
     }
 
@@ -135,24 +288,315 @@ char next_char(scanner_t *sc) {
 }
 
 
+/*******************************Fast skipping*********************************/
+/**
+ * Long runs of whitespaces, comment bodies and string literal bodies do not 
+ * change state of FSM, so they are skipped by blocks of characters (SSE2/AVX2 
+ * if compiler targets them, otherwise character by character) 
+ */ 
+
+#if defined(__AVX2__) && !defined(SCANNER_NO_SIMD)
+
+#include <immintrin.h>
+
+#define VEC_WIDTH 32
+typedef __m256i vec_t;
+#define vec_load(p) _mm256_loadu_si256((const __m256i *)(p))
+#define vec_set(c) _mm256_set1_epi8((char)(c))
+#define vec_eq(a, b) _mm256_cmpeq_epi8((a), (b))
+#define vec_or(a, b) _mm256_or_si256((a), (b))
+#define vec_andnot(a, b) _mm256_andnot_si256((a), (b))
+#define vec_sub(a, b) _mm256_sub_epi8((a), (b))
+#define vec_min(a, b) _mm256_min_epu8((a), (b))
+#define vec_mask(v) ((uint32_t)_mm256_movemask_epi8(v))
+
+#elif defined(__SSE2__) && !defined(SCANNER_NO_SIMD)
+
+#include <emmintrin.h>
+
+#define VEC_WIDTH 16
+typedef __m128i vec_t;
+#define vec_load(p) _mm_loadu_si128((const __m128i *)(p))
+#define vec_set(c) _mm_set1_epi8((char)(c))
+#define vec_eq(a, b) _mm_cmpeq_epi8((a), (b))
+#define vec_or(a, b) _mm_or_si128((a), (b))
+#define vec_andnot(a, b) _mm_andnot_si128((a), (b))
+#define vec_sub(a, b) _mm_sub_epi8((a), (b))
+#define vec_min(a, b) _mm_min_epu8((a), (b))
+#define vec_mask(v) ((uint32_t)_mm_movemask_epi8(v))
+
+#endif
+
+
+/**
+ * @brief Returns true if character is space according to isspace() (in "C" locale)
+ */ 
+bool is_space_ch(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+
+/**
+ * @brief Returns true if character does not change state of FSM in given state
+ * @note (char)0xFF is always interesting, because it is same as EOF
+ */ 
+bool is_skippable(unsigned char c, fsm_state_t state) {
+    switch(state) {
+        case INIT:
+            return is_space_ch(c);
+        case COM_F1: //One line comment ([ can start block comment)
+            return c != '\n' && c != '[' && c != 0xFF;
+        case COM_1: //Block comment
+            return c != ']' && c != 0xFF;
+        case STR_1: //Body of string literal (escape sequences and control characters are processed by FSM)
+            return c != '"' && c != '\\' && c != 0xFF && c != 0x7F && (c >= ' ' || is_space_ch(c));
+        default:
+            return false;
+    }
+}
+
+
+#ifdef VEC_WIDTH
+
+/**
+ * @brief Returns mask of characters in block, that change state of FSM (see is_skippable())
+ */ 
+uint32_t interesting_mask(vec_t v, fsm_state_t state) {
+    //Spaces are ' ' and '\t' - '\r' (characters - '\t' <= 4 as unsigned)
+    vec_t tab_based = vec_sub(v, vec_set('\t'));
+    vec_t spaces = vec_or(vec_eq(v, vec_set(' ')), vec_eq(vec_min(tab_based, vec_set(4)), tab_based));
+    vec_t eof = vec_eq(v, vec_set(0xFF));
+
+    switch(state) {
+        case INIT:
+            return ~vec_mask(spaces);
+        case COM_F1:
+            return vec_mask(vec_or(eof, vec_or(vec_eq(v, vec_set('\n')), vec_eq(v, vec_set('[')))));
+        case COM_1:
+            return vec_mask(vec_or(eof, vec_eq(v, vec_set(']'))));
+        case STR_1: {
+            vec_t control = vec_eq(vec_min(v, vec_set(0x1F)), v); //Characters <= 0x1F as unsigned
+            control = vec_or(vec_andnot(spaces, control), vec_eq(v, vec_set(0x7F)));
+            vec_t special = vec_or(vec_eq(v, vec_set('"')), vec_eq(v, vec_set('\\')));
+
+            return vec_mask(vec_or(vec_or(special, control), eof));
+        }
+        default:
+            return ~(uint32_t)0;
+    }
+}
+
+#endif
+
+
+/**
+ * @brief Finds the first character from index from, that changes state of FSM
+ * @return Index of found character or to if there is no such character
+ */ 
+size_t find_interesting(const char *src, size_t from, size_t to, fsm_state_t state) {
+    size_t i = from;
+
+#ifdef VEC_WIDTH
+    if(to - from >= VEC_WIDTH && is_skippable(src[i], state)) { //Short runs are not worth it
+        uint32_t valid = (VEC_WIDTH == 32) ? ~(uint32_t)0 : (1u << VEC_WIDTH) - 1;
+        for(; i + VEC_WIDTH <= to; i += VEC_WIDTH) {
+            uint32_t mask = interesting_mask(vec_load(&src[i]), state) & valid;
+            if(mask) {
+                return i + __builtin_ctz(mask);
+            }
+        }
+    }
+#endif
+
+    while(i < to && is_skippable(src[i], state)) {
+        i++;
+    }
+
+    return i;
+}
+
+
+/**
+ * @brief Counts newlines in part of source code
+ * @param last_nl Output parameter, index of the last found newline (unchanged if there is no newline)
+ */ 
+size_t count_newlines(const char *src, size_t from, size_t to, size_t *last_nl) {
+    size_t count = 0, i = from;
+
+#ifdef VEC_WIDTH
+    vec_t nl = vec_set('\n');
+    for(; i + VEC_WIDTH <= to; i += VEC_WIDTH) {
+        uint32_t mask = vec_mask(vec_eq(vec_load(&src[i]), nl));
+        if(mask) {
+            count += __builtin_popcount(mask);
+            *last_nl = i + 31 - __builtin_clz(mask);
+        }
+    }
+#endif
+
+    for(; i < to; i++) {
+        if(src[i] == '\n') {
+            count++;
+            *last_nl = i;
+        }
+    }
+
+    return count;
+}
+
+
+/**
+ * @brief Skips characters, that does not change current state of FSM, and updates cursor position
+ * @note It is used only if there is no character in input buffer
+ */ 
+void skip_boring(scanner_t *sc) {
+    size_t from = sc->src_pos;
+    size_t to = find_interesting(sc->src, from, sc->src_len, sc->state);
+    if(to == from) {
+        return;
+    }
+
+    size_t last_nl = from;
+    size_t nl_cnt = count_newlines(sc->src, from, to, &last_nl);
+    if(nl_cnt > 0) {
+        sc->cursor_pos[ROW] += nl_cnt;
+        sc->cursor_pos[COL] = to - last_nl;
+    }
+    else {
+        sc->cursor_pos[COL] += to - from;
+    }
+
+    sc->ch_index = to - 1;
+    sc->src_pos = to;
+}
+
+//^^^^^^^^^^^^^^^^^^^^^^^^^^^^End of fast skipping^^^^^^^^^^^^^^^^^^^^^^^^^^^/
+
+
+/****************************Numeric literals*********************************/
+
+long long parse_integer(const char *str, size_t length, bool *overflow) {
+    long long result = 0;
+    *overflow = false;
+    for(size_t i = 0; i < length; i++) {
+        int digit = str[i] - '0';
+        if(result > (LLONG_MAX - digit) / 10) {
+            *overflow = true;
+            return LLONG_MAX;
+        }
+
+        result = result * 10 + digit;
+    }
+
+    return result;
+}
+
+
+#define MAX_EXACT_MANTISSA (1ull << 53) /**< Greater integers can't be represented in double exactly */
+#define MAX_EXACT_POW10 22 /**< 10^22 is the greatest power of ten, that is represented in double exactly */
+#define MAX_MANTISSA_DIGITS 19 /**< Number of digits, that always fits to 64-bit integer */
+
+double parse_number(const char *str, size_t length) {
+    static const double pow10[MAX_EXACT_POW10 + 1] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    unsigned long long mantissa = 0;
+    int digits = 0;
+    long exp10 = 0;
+    bool exact = true, is_frac = false;
+
+    size_t i = 0;
+    for(; i < length && str[i] != 'e' && str[i] != 'E'; i++) {
+        if(str[i] == '.') {
+            is_frac = true;
+            continue;
+        }
+
+        int digit = str[i] - '0';
+        if(digits < MAX_MANTISSA_DIGITS) {
+            if(mantissa > 0 || digit > 0) { //Leading zeros are not significant
+                mantissa = mantissa * 10 + digit;
+                digits++;
+            }
+
+            exp10 -= is_frac ? 1 : 0;
+        }
+        else { //Digits, that don't fit to mantissa
+            exact = exact && digit == 0;
+            exp10 += is_frac ? 0 : 1;
+        }
+    }
+
+    if(i < length) { //Exponent
+        bool negative = str[++i] == '-';
+        i += (str[i] == '-' || str[i] == '+') ? 1 : 0;
+
+        long exp = 0;
+        for(; i < length; i++) {
+            exp = (exp < 100000) ? exp * 10 + (str[i] - '0') : exp; //Saturation (result is inf or zero anyway)
+        }
+
+        exp10 += negative ? -exp : exp;
+    }
+
+    if(mantissa == 0 && exact) {
+        return 0.0;
+    }
+
+    //Both operands are exact, so result of one operation is correctly rounded
+    if(exact && mantissa <= MAX_EXACT_MANTISSA && exp10 >= -MAX_EXACT_POW10 && exp10 <= MAX_EXACT_POW10) {
+        return exp10 >= 0 ? (double)mantissa * pow10[exp10] : (double)mantissa / pow10[-exp10];
+    }
+
+    //Slow path (long mantissa or big exponent)
+    char buffer[64];
+    char *literal = length < sizeof(buffer) ? buffer : malloc(length + 1);
+    if(!literal) {
+        return HUGE_VAL;
+    }
+
+    memcpy(literal, str, length);
+    literal[length] = '\0';
+    double result = strtod(literal, NULL);
+
+    if(literal != buffer) {
+        free(literal);
+    }
+
+    return result;
+}
+
+//^^^^^^^^^^^^^^^^^^^^^^^^^^^End of numeric literals^^^^^^^^^^^^^^^^^^^^^^^^^^/
+
+
 /**
  * @brief Assigns type to token and perform other necessary actions to
  */ 
 void got_token(token_type_t type, char c, token_t *token, scanner_t *sc) {
+    //Current character is part of token only if it ends in initial state (e.g. invalid character)
+    size_t end_index = sc->ch_index + 1;
     if(sc->state != INIT) {
         ungetchar(c, sc);
+        end_index = sc->ch_index;
     }
 
     if(type == EOF_TYPE) {
-        cut_string(&sc->str_buffer, sc->first_ch_index);
-
         token->attr = "EOF"; //Special attribute only for displaying error messages end debugging
     }
     else if(sc->first_ch_index != UNSET) {
-        token->first_ch_index = sc->first_ch_index; //Give "pointer index" to token
-
-        if(app_char('\0', &(sc->str_buffer)) != STR_SUCCESS) {
-            type = INT_ERR_TYPE;
+        token->first_ch_index = sc->first_ch_index; //Token is only span of source code
+        token->length = end_index - sc->first_ch_index;
+
+        //Numeric literals are converted only once (here)
+        const char *literal = &sc->src[token->first_ch_index];
+        if(type == INTEGER) {
+            bool overflow;
+            token->num.integer = parse_integer(literal, token->length, &overflow);
+        }
+        else if(type == NUMBER) {
+            token->num.number = parse_number(literal, token->length);
         }
     }
 
@@ -173,8 +617,7 @@ void got_token(token_type_t type, char c, token_t *token, scanner_t *sc) {
 void got_comment(char c, token_t *token, scanner_t *sc) {
     ungetchar(c, sc);
 
-    cut_string(&(sc->str_buffer), sc->first_ch_index); //Ingore comment in attribute buffer
-    sc->first_ch_index = UNSET;
+    sc->first_ch_index = UNSET; //Comment is ignored
 
     sc->state = INIT; //Reset automata state
 }
@@ -202,12 +645,13 @@ bool from_tab(char *(*tab_func)(unsigned int), token_t *token, scanner_t *sc) {
         table_size = SEPARATOR_TABLE_SIZE;
     }
 
-    char * tab_token = NULL;
-    char * first_ch = &((to_str(&sc->str_buffer))[sc->first_ch_index]);
-    tab_token = match(first_ch, tab_func, table_size); //Searching in given table
-    if(tab_token != NULL) {
-        token->attr = tab_token;
-        cut_string(&sc->str_buffer, sc->first_ch_index);
+    //Current character is not part of token yet
+    const char * first_ch = &sc->src[sc->first_ch_index];
+    size_t length = sc->ch_index - sc->first_ch_index;
+    int tab_index = match_index_n(first_ch, length, tab_func, table_size); //Searching in given table
+    if(tab_index != UNSET) {
+        token->attr = tab_func(tab_index);
+        token->attr_id = tab_index;
         sc->first_ch_index = UNSET;
 
         return true;
@@ -264,17 +708,11 @@ void INIT_trans(char c, token_t * token, scanner_t *sc) {
         sc->state = EOF_F;
     }
     else {
-        if(sc->first_ch_index == UNSET) { //If poistion of cursor in str buffer is not set -> set it to the end
-            sc->first_ch_index = sc->str_buffer.length;
-        }
-
-        if(app_char(c, &sc->str_buffer) != STR_SUCCESS) { //Saving error token to show it to user
-            got_token(INT_ERR_TYPE, c, token, sc);
-        }
-        else {
-            got_token(ERROR_TYPE, c, token, sc);
+        if(sc->first_ch_index == UNSET) { //Invalid character is saved as error token to show it to user
+            sc->first_ch_index = sc->ch_index;
         }
 
+        got_token(ERROR_TYPE, c, token, sc);
         lex_err(sc, token);
     }
 }
@@ -426,9 +864,9 @@ void COM_3_trans(char c, token_t * token, scanner_t *sc) {
     got_token(ERROR_TYPE, c, token, sc);
 
     //This is quite special lexical error so it deserves special error message
-    fprintf(stderr, "(\033[1;37m%lu:%lu\033[0m)\t| ", (sc->cursor_pos[ROW]), (sc->cursor_pos[COL]));
-    fprintf(stderr, "\033[0;31mLexical error:\033[0m ");
-    fprintf(stderr, "Block comments must be correctly ended with '\033[1;33m]]\033[0m'!\n");
+    fprintf(sc->diag, "(\033[1;37m%lu:%lu\033[0m)\t| ", (sc->cursor_pos[ROW]), (sc->cursor_pos[COL]));
+    fprintf(sc->diag, "\033[0;31mLexical error:\033[0m ");
+    fprintf(sc->diag, "Block comments must be correctly ended with '\033[1;33m]]\033[0m'!\n");
 }
 
 
@@ -601,34 +1039,35 @@ void EOF_F_trans(char c, token_t * token, scanner_t *sc) {
  */ 
 trans_func_t get_trans(fsm_state_t state) {
 
-    static trans_func_t transition_functions[STATE_NUM];
-    transition_functions[INIT] = INIT_trans;
-    transition_functions[ID_F] = ID_F_trans;
-    transition_functions[INT_F] = INT_F_trans;
-    transition_functions[NUM_1] = NUM_1_trans;
-    transition_functions[NUM_2] = NUM_2_trans;
-    transition_functions[NUM_3] = NUM_3_trans;
-    transition_functions[NUM_F1] = NUM_F1_trans;
-    transition_functions[NUM_F2] = NUM_F2_trans;
-    transition_functions[COM_1] = COM_1_trans;
-    transition_functions[COM_2] = COM_2_trans;
-    transition_functions[COM_3] = COM_3_trans;
-    transition_functions[COM_F1] = COM_F1_trans;
-    transition_functions[COM_F2] = COM_F2_trans;
-    transition_functions[COM_F3] = COM_F3_trans;
-    transition_functions[STR_1] = STR_1_trans;
-    transition_functions[STR_2] = STR_2_trans;
-    transition_functions[STR_3] = STR_3_trans;
-    transition_functions[STR_4] = STR_4_trans;
-    transition_functions[STR_F] = STR_F_trans;
-    transition_functions[SEP_F] = SEP_F_trans;
-    transition_functions[OP_1] = OP_1_trans;
-    transition_functions[OP_2] = OP_2_trans;
-    transition_functions[OP_F1] = OP_F1_trans;
-    transition_functions[OP_F2] = OP_F2_trans;
-    transition_functions[OP_F3] = OP_F3_trans;
-    transition_functions[OP_F4] = OP_F4_trans;
-    transition_functions[EOF_F] = EOF_F_trans;
+    static const trans_func_t transition_functions[STATE_NUM] = {
+        [INIT] = INIT_trans,
+        [ID_F] = ID_F_trans,
+        [INT_F] = INT_F_trans,
+        [NUM_1] = NUM_1_trans,
+        [NUM_2] = NUM_2_trans,
+        [NUM_3] = NUM_3_trans,
+        [NUM_F1] = NUM_F1_trans,
+        [NUM_F2] = NUM_F2_trans,
+        [COM_1] = COM_1_trans,
+        [COM_2] = COM_2_trans,
+        [COM_3] = COM_3_trans,
+        [COM_F1] = COM_F1_trans,
+        [COM_F2] = COM_F2_trans,
+        [COM_F3] = COM_F3_trans,
+        [STR_1] = STR_1_trans,
+        [STR_2] = STR_2_trans,
+        [STR_3] = STR_3_trans,
+        [STR_4] = STR_4_trans,
+        [STR_F] = STR_F_trans,
+        [SEP_F] = SEP_F_trans,
+        [OP_1] = OP_1_trans,
+        [OP_2] = OP_2_trans,
+        [OP_F1] = OP_F1_trans,
+        [OP_F2] = OP_F2_trans,
+        [OP_F3] = OP_F3_trans,
+        [OP_F4] = OP_F4_trans,
+        [EOF_F] = EOF_F_trans,
+    };
 
     return transition_functions[state];
 }
@@ -639,7 +1078,7 @@ char *tok_type_to_str(token_type_t tok_type) {
         return NULL;
     }
 
-    static char* tok_type_meanings[TOK_TYPE_NUM] = {
+    static char * const tok_type_meanings[TOK_TYPE_NUM] = {
         "unknown", "identifier", "keyword", "integer", 
         "number", "string", "operator", "separator",
         "end of file", "invalid token"
@@ -667,52 +1106,125 @@ bool is_error_token(token_t *token, int *return_code) {
 }
 
 
-token_t get_next_token(scanner_t *sc) {
-    token_t result;
-    token_init(&result);
+/**
+ * @brief Reads next token directly from source code
+ */
+static token_t scan_token(scanner_t *sc) {
+    if(sc->replay) { //Source code was already scanned (EOF is returned repeatedly at the end)
+        const tok_record_t *rec = &sc->replay[sc->replay_len - 1];
+        if(sc->replay_next < sc->replay_len) {
+            rec = &sc->replay[sc->replay_next++];
+        }
 
-    if(sc->is_tok_buffer_full) {
-       result = sc->tok_buffer;
-       sc->is_tok_buffer_full = false; 
+        sc->cursor_pos[ROW] = rec->cursor_pos[ROW];
+        sc->cursor_pos[COL] = rec->cursor_pos[COL];
+
+        return rec->token;
     }
 
+    token_t result;
+    token_init(&result);
+
     while(result.token_type == UNKNOWN) {
+        bool is_skipping_state = sc->state == INIT || sc->state == COM_F1 || 
+                                 sc->state == COM_1 || sc->state == STR_1;
+        if(is_skipping_state && !sc->is_input_buffer_full) {
+            skip_boring(sc);
+        }
+
         char c = next_char(sc);
 
         //Get transitions from current state
         trans_func_t do_transition = get_trans(sc->state);
         do_transition(c, &result, sc);
 
-        if(sc->state != INIT) {
-            if(sc->first_ch_index == UNSET) {
-                sc->first_ch_index = sc->str_buffer.length;
-            }
-
-            if(app_char(c, &sc->str_buffer) != STR_SUCCESS) {
-                got_token(INT_ERR_TYPE, c, &result, sc);
-            } 
+        if(sc->state != INIT && sc->first_ch_index == UNSET) { //Token starts (its characters are not copied)
+            sc->first_ch_index = sc->ch_index;
         }
 
     } //while(result.token_type == UNKNOWN)
 
     return result;
-} //get_next_token()
+} //scan_token()
 
 
+token_t get_next_token(scanner_t *sc) {
+    if(sc->la_count > 0) { //Token was already read by lookahead
+        token_t result = sc->la_ring[sc->la_head];
+        sc->la_head = (sc->la_head + 1) & (LOOKAHEAD_SIZE - 1);
+        sc->la_count--;
+
+        return result;
+    }
+
+    return scan_token(sc);
+}
+
+
+/**
+ * @brief Returns true if there are no tokens after given token (or they should not be read yet)
+ */
+static bool is_last_token(token_t *token) {
+    return token->token_type == EOF_TYPE || token->token_type == ERROR_TYPE || 
+           token->token_type == INT_ERR_TYPE;
+}
 
-token_t lookahead(scanner_t *sc) {
-    token_t result;
-    token_init(&result);
 
-    if(sc->is_tok_buffer_full) {
-        result = sc->tok_buffer;
+token_t *peek_token(scanner_t *sc, size_t n) {
+    if(n >= LOOKAHEAD_SIZE) {
+        return NULL;
     }
-    else {
-        result = get_next_token(sc);
-        sc->tok_buffer = result;
-        sc->is_tok_buffer_full = true;
+
+    while(sc->la_count <= n) {
+        if(sc->la_count > 0) {
+            token_t *newest = &sc->la_ring[(sc->la_head + sc->la_count - 1) & (LOOKAHEAD_SIZE - 1)];
+            if(is_last_token(newest)) {
+                return newest;
+            }
+        }
+
+        sc->la_ring[(sc->la_head + sc->la_count) & (LOOKAHEAD_SIZE - 1)] = scan_token(sc);
+        sc->la_count++;
+    }
+
+    return &sc->la_ring[(sc->la_head + n) & (LOOKAHEAD_SIZE - 1)];
+}
+
+
+void scanner_replay(scanner_t *sc, const tok_record_t *records, size_t len) {
+    sc->replay = len > 0 ? records : NULL;
+    sc->replay_len = len;
+    sc->replay_next = 0;
+}
+
+
+size_t scanner_replay_pos(scanner_t *sc) {
+    return sc->replay_next - sc->la_count;
+}
+
+
+void scanner_replay_seek(scanner_t *sc, size_t index) {
+    sc->la_head = 0;
+    sc->la_count = 0; //Tokens read in advance are thrown away
+    sc->replay_next = index < sc->replay_len ? index : sc->replay_len;
+}
+
+
+token_t lookahead(scanner_t *sc) {
+    return *peek_token(sc, 0);
+}
+
+
+void scanner_reclaim(scanner_t *sc) {
+    attr_store_reset(sc, true);
+
+    //Tokens read in advance are spans of source code, but their attributes could be copied to the store by get_attr()
+    for(size_t i = 0; i < sc->la_count; i++) {
+        token_t *t = &sc->la_ring[(sc->la_head + i) & (LOOKAHEAD_SIZE - 1)];
+        if(t->token_type != EOF_TYPE && t->attr_id == UNSET) { //Attributes from tables remain valid
+            t->attr = NULL;
+        }
     }
-    return result;
 }
 
 
@@ -48,13 +48,24 @@ typedef enum token_type {
     TOK_TYPE_NUM
 } token_type_t;
 
+/**
+ * @brief Value of numeric literal (it is parsed only once by scanner)
+ */ 
+typedef union num_value {
+    long long integer; /**< Value of INTEGER token (saturated to LLONG_MAX if it is too big) */
+    double number; /**< Value of NUMBER token (HUGE_VAL if it is out of range) */
+} num_value_t;
+
 /**
  * @brief Token structure
  */ 
 typedef struct token {
     token_type_t token_type;
-    size_t first_ch_index;
-    void * attr;
+    size_t first_ch_index; /**< Index of the first character of token in source code */
+    size_t length; /**< Length of token in source code */
+    void * attr; /**< Attribute of token terminated by '\0' (NULL if it wasn't needed yet, @see get_attr()) */
+    int attr_id; /**< Index of attribute in table of predefined symbols (e.g. keyword_id_t), UNSET if it is not from table */
+    num_value_t num; /**< Value of INTEGER or NUMBER token */
 } token_t;
 
 
@@ -62,6 +73,31 @@ typedef struct token {
 DSTACK_DECL(token_t, tok) /**< Token buffer declaration */
 
 
+/**
+ * @brief View of token attribute directly in source code (it is NOT terminated by '\0')
+ */ 
+typedef struct attr_view {
+    const char *str;
+    size_t len;
+} attr_view_t;
+
+
+#define ATTR_CHUNK_SIZE 1024 /**< Default size of chunks in store of attributes */
+
+/**
+ * @brief Chunk of store for attributes (terminated copies of tokens)
+ * @note Chunks are never reallocated, so pointers to attributes are stable until store is reset
+ */ 
+typedef struct attr_chunk {
+    struct attr_chunk *next; /**< Previously filled chunk */
+    size_t used;
+    size_t size;
+    char *data; /**< Space for attributes (it is allocated together with chunk) */
+} attr_chunk_t;
+
+
+#define LOOKAHEAD_SIZE 4 /**< Number of tokens, that can be read in advance (it must be power of two) */
+
 /**
  * @brief All possible states of FSM ( = base of scanner implementation)
  * @note If token ends with _F suffix, that means, that state is finite
@@ -88,22 +124,43 @@ typedef enum pos_indexes {
     ROW, COL, COORD_NUM
 } pos_indexes_t;
 
+/**
+ * @brief Token together with position of scanner cursor after it was read (element of recorded token stream)
+ */ 
+typedef struct tok_record {
+    token_t token;
+    pos_t cursor_pos[COORD_NUM];
+} tok_record_t;
+
 /**
  * @brief Scanner structure
  */ 
 typedef struct scanner {
-    string_t str_buffer; /**< String buffer used for collecting value of tokens */
+    const char *src; /**< Source code, that is scanned */
+    size_t src_len; /**< Length of source code */
+    size_t src_pos; /**< Index of the next character in source code */
+    char *src_owned; /**< Buffer with source code read from stdin (it is owned by scanner, NULL if source is given by caller) */
+    FILE *diag; /**< Stream for diagnostic messages (lexical errors, warnings and errors of parsers) */
+    attr_chunk_t *attr_store; /**< Store of attributes required by get_attr() (the current chunk) */
     size_t first_ch_index; /**< Index of first character of currently processed token */
+    size_t ch_index; /**< Index of the last character got from source code */
 
     char input_buffer; /**< Sometimes is necessary to "push" character back to stdin*/
     bool is_input_buffer_full; /**< Flag that signalizes validity of data in input_buffer */
 
-    token_t tok_buffer; /**< Additional buffer for one token */
-    bool is_tok_buffer_full; /**< Flag that signalizes validity of data in tok_buffer */
+    token_t la_ring[LOOKAHEAD_SIZE]; /**< Ring buffer for tokens read in advance (@see peek_token()) */
+    size_t la_head; /**< Index of the oldest token in la_ring */
+    size_t la_count; /**< Number of tokens in la_ring */
 
     pos_t cursor_pos[COORD_NUM]; /**< Current cursor position (position of char, that will be processed)*/
 
     fsm_state_t state; /** Current state of FSM */
+
+    const tok_record_t *replay; /**< Recorded tokens, that are returned instead of scanning (NULL if source is scanned) */
+    size_t replay_len; /**< Number of recorded tokens (the last one must be EOF) */
+    size_t replay_next; /**< Index of the next recorded token */
+
+    size_t warn_cnt; /**< Number of warnings printed to diag stream (by scanner or by parsers) */
 } scanner_t;
 
 /**
@@ -120,10 +177,36 @@ void token_init(token_t *token);
 
 /**
  * @brief Finds attribute of given token
- * @return Pointer to token attribute (string)
+ * @return Pointer to token attribute (string terminated by '\0')
+ * @note Attribute is copied from source code to store of scanner at the first call (pointer is saved in token),
+ *       it is valid until the end of current statement (@see scanner_reclaim())
  */ 
 char * get_attr(token_t *token, scanner_t *sc);
 
+/**
+ * @brief Finds attribute of given token without copying it
+ * @return View to source code (or to table of predefined symbols), that is valid during whole scanning
+ */ 
+attr_view_t get_attr_view(token_t *token, scanner_t *sc);
+
+/**
+ * @brief Compares view of attribute with string
+ * @return True if view contains exactly given string
+ */ 
+bool attr_view_eq(attr_view_t view, const char *str);
+
+/**
+ * @brief Converts numeric literal (digits [. digits] [e [+-] digits]) to double
+ * @note Result is correctly rounded (as strtod()), HUGE_VAL is returned if literal is out of range
+ */ 
+double parse_number(const char *str, size_t length);
+
+/**
+ * @brief Converts integer literal (only digits) to integer
+ * @param overflow Output parameter, it is set to true if literal is out of range (result is LLONG_MAX)
+ */ 
+long long parse_integer(const char *str, size_t length, bool *overflow);
+
 /**
  * @brief Reads characters from stdin (or from buffer) and tries to make token from it
  * @param scanner Structure that contains necessary buffers and variables to scan input correctly
@@ -141,6 +224,40 @@ token_t get_next_token(scanner_t *scanner);
  */
 token_t lookahead(scanner_t *scanner);
 
+/**
+ * @brief Reads n-th next token in advance (0 means the token, that will be returned by the next get_next_token())
+ * @return Pointer to token in lookahead buffer of scanner, it is valid until the token is taken by get_next_token(),
+ *         NULL if n >= LOOKAHEAD_SIZE
+ * @note Reading stops at the end of file or at the error token, so it is returned for all greater n
+ *       (messages about lexical errors are not printed before they are necessary)
+ */
+token_t *peek_token(scanner_t *scanner, size_t n);
+
+/**
+ * @brief Makes scanner return given recorded tokens instead of scanning source code
+ * @param records Tokens of the same source code, that scanner has, terminated by EOF token 
+ *                (they are not copied, so they must be valid until scanner is destroyed)
+ */
+void scanner_replay(scanner_t *scanner, const tok_record_t *records, size_t len);
+
+/**
+ * @brief Returns index of recorded token, that will be returned by the next get_next_token() (scanner must be in replay mode)
+ */
+size_t scanner_replay_pos(scanner_t *scanner);
+
+/**
+ * @brief Moves scanner in replay mode to recorded token with given index (tokens read in advance are thrown away)
+ * @note Skipped tokens are not checked, so caller must know, that they are valid
+ */
+void scanner_replay_seek(scanner_t *scanner, size_t index);
+
+/**
+ * @brief Releases attributes created by get_attr() from store of scanner, so store does not grow with the whole input
+ * @note Parser calls it between statements, attributes got before become invalid 
+ *       (tokens, that must outlive statement, need own storage for attribute, see token->attr)
+ */
+void scanner_reclaim(scanner_t *scanner);
+
 /**
  * @brief Converts enumeration type to cstring, where is described meaning of token type
  * @note Can be used e.g. in suggestions and in error messages
@@ -157,11 +274,28 @@ char *tok_type_to_str(token_type_t tok_type);
 bool is_error_token(token_t *token, int *return_code);
 
 /**
- * @brief Inits scanner structure
+ * @brief Reads the whole stream to dynamically allocated buffer
+ * @param dst Output parameter for buffer (caller must free it)
+ * @param length Output parameter for length of read content
+ * @return If it returns INTERNAL_ERROR, allocation or reading failed (nothing is allocated)
+ */ 
+int read_stream(FILE *stream, char **dst, size_t *length);
+
+/**
+ * @brief Inits scanner structure (the whole stdin is read as source code)
  * @return If it returns INTERNAL_ERROR error ocurred during initialization
  */ 
 int scanner_init(scanner_t *scanner);
 
+/**
+ * @brief Inits scanner structure, that reads source code from given buffer
+ * @param src Source code (it is not copied, so it must be valid until scanner is destroyed)
+ * @param src_len Length of source code
+ * @return If it returns INTERNAL_ERROR error ocurred during initialization
+ * @note Diagnostic messages are printed to stderr, it can be changed by diag attribute of scanner
+ */ 
+int scanner_init_buffer(scanner_t *scanner, const char *src, size_t src_len);
+
 /**
  * @brief Destroys scanner structure
  */ 
@@ -24,8 +24,11 @@ extern "C" {
 
 #include "gtest/gtest.h"
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 
 bool verbose_mode = false; /**< Tests prints only test cases with differences between expected result and got */
 bool force_mode = false; /**< Tests automatically prevents overwriting files, if is set to false */
@@ -71,12 +74,14 @@ bool prepare_tests(std::string *fname, std::string *content, scanner_t *dut) {
 }
 
 void show_buffer(scanner_t *uut) {
-    for(size_t i = 0; i <= uut->str_buffer.length; i++) {
-        fprintf(stderr, "%d|", uut->str_buffer.str[i]);
+    for(attr_chunk_t *chunk = uut->attr_store; chunk; chunk = chunk->next) {
+        for(size_t i = 0; i < chunk->used; i++) {
+            fprintf(stderr, "%d|", chunk->data[i]);
+        }
+        fprintf(stderr, "\n");
+        fprintf(stderr, "Used: %ld of %ld", chunk->used, chunk->size);
+        fprintf(stderr, "\n");
     }
-    fprintf(stderr, "\n");
-    fprintf(stderr, "Length: %ld ( + \\0 at the end)", uut->str_buffer.length);
-    fprintf(stderr, "\n");    
 }
  
 class test_fixture : public ::testing::Test {
@@ -598,6 +603,48 @@ TEST_F(scanning_with_lookahead, types) {
     testTypes();
 }
 
+class peeking : public test_fixture {
+    protected:
+        void setData() override {
+            scanner_input = "local s : string = f(a, 1) -- comment\n";
+            exp_types = {
+                KEYWORD, IDENTIFIER, SEPARATOR, KEYWORD, OPERATOR,
+                IDENTIFIER, SEPARATOR, IDENTIFIER, SEPARATOR, INTEGER,
+                SEPARATOR, EOF_TYPE
+            };
+        }
+};
+
+TEST_F(peeking, types) {
+    for(size_t token_i = 0; token_i < exp_types.size(); token_i++) {
+        for(size_t n = 0; n < LOOKAHEAD_SIZE; n++) { //Tokens after EOF are still EOF
+            size_t exp_i = std::min(token_i + n, exp_types.size() - 1);
+            ASSERT_EQ(peek_token(&uut, n)->token_type, exp_types[exp_i]);
+        }
+
+        EXPECT_EQ(peek_token(&uut, LOOKAHEAD_SIZE), nullptr);
+
+        token_t *peeked = peek_token(&uut, 0);
+        EXPECT_EQ(lookahead(&uut).first_ch_index, peeked->first_ch_index);
+        EXPECT_EQ(get_next_token(&uut).first_ch_index, peeked->first_ch_index);
+    }
+}
+
+
+class peeking_errors : public test_fixture {
+    protected:
+        void setData() override {
+            scanner_input = "a b $ c";
+            exp_types = {IDENTIFIER, IDENTIFIER, ERROR_TYPE, IDENTIFIER, EOF_TYPE};
+        }
+};
+
+TEST_F(peeking_errors, stops_at_error) {
+    EXPECT_EQ(peek_token(&uut, 3)->token_type, ERROR_TYPE); //Token after error is not read yet
+    EXPECT_EQ(peek_token(&uut, 1)->token_type, IDENTIFIER);
+    testTypes();
+}
+
 
 class comments : public test_fixture {
     protected:
@@ -650,6 +697,131 @@ TEST_F(numbers, types) {
     testTypes();
 }
 
+TEST_F(numbers, values) {
+    token_t t;
+    while((t = get_next_token(&uut)).token_type != EOF_TYPE) {
+        if(t.token_type == INTEGER) {
+            EXPECT_EQ(t.num.integer, strtoll(get_attr(&t, &uut), NULL, 10));
+        }
+        else if(t.token_type == NUMBER) {
+            EXPECT_EQ(t.num.number, strtod(get_attr(&t, &uut), NULL)) << get_attr(&t, &uut);
+        }
+    }
+}
+
+
+TEST(parse_number, random_literals) {
+    srand(42);
+    for(size_t i = 0; i < 200000; i++) {
+        std::string literal = std::to_string(rand() % 1000000);
+        if(rand() % 2) {
+            literal += "." + std::string(rand() % 12, '0') + std::to_string(rand());
+        }
+        if(rand() % 4 == 0) { //Long mantissas
+            literal += std::to_string(rand()) + std::to_string(rand());
+        }
+        if(rand() % 2) {
+            literal += (rand() % 2) ? "e-" : "e";
+            literal += std::to_string(rand() % 400);
+        }
+
+        EXPECT_EQ(parse_number(literal.c_str(), literal.length()), strtod(literal.c_str(), NULL)) << literal;
+    }
+}
+
+
+TEST(parse_integer, saturation) {
+    bool overflow;
+    EXPECT_EQ(parse_integer("0009", 4, &overflow), 9ll);
+    EXPECT_FALSE(overflow);
+    EXPECT_EQ(parse_integer("9223372036854775807", 19, &overflow), LLONG_MAX);
+    EXPECT_FALSE(overflow);
+    EXPECT_EQ(parse_integer("9223372036854775808", 19, &overflow), LLONG_MAX);
+    EXPECT_TRUE(overflow);
+}
+
+
+TEST(tok_stack, bulk_operations) {
+    tok_stack_t s;
+    ASSERT_TRUE(tok_stack_init(&s));
+
+    std::vector<token_t> tokens(40);
+    for(size_t i = 0; i < tokens.size(); i++) {
+        tokens[i].first_ch_index = i;
+    }
+
+    ASSERT_TRUE(tok_push_n(&s, tokens.data(), tokens.size())); //Stack must be extended
+    EXPECT_EQ(s.top, 40u);
+    EXPECT_EQ(tok_top(&s).first_ch_index, 39lu);
+
+    tok_revert(&s);
+    for(size_t i = 0; i < tokens.size(); i++) {
+        EXPECT_EQ(tok_get_ptr(&s, i)->first_ch_index, 39 - i);
+    }
+
+    token_t popped[3];
+    tok_pop_n(&s, popped, 3);
+    EXPECT_EQ(popped[0].first_ch_index, 2lu);
+    EXPECT_EQ(popped[2].first_ch_index, 0lu);
+    EXPECT_EQ(s.top, 37u);
+
+    size_t allocated = s.allocated;
+    tok_clear(&s);
+    EXPECT_TRUE(tok_is_empty(&s));
+    EXPECT_EQ(s.allocated, allocated); //Space is kept
+
+    ASSERT_TRUE(tok_reserve(&s, 1000));
+    EXPECT_EQ(s.allocated, 1000u);
+    ASSERT_TRUE(tok_push_n(&s, tokens.data(), 5));
+    ASSERT_TRUE(tok_shrink(&s));
+    EXPECT_EQ(s.allocated, 5u);
+
+    tok_stack_dtor(&s);
+}
+
+
+class long_runs : public test_fixture {
+    protected:
+        void setData() override {
+            //Runs are longer than blocks of vectorized skipping (and they end inside of blocks)
+            scanner_input = "a" + std::string(100, ' ') + std::string(37, '\n') + "\t\t";
+            scanner_input += "--[[";
+            for(size_t i = 0; i < 35; i++) {
+                scanner_input += "]x";
+            }
+            scanner_input += std::string(33, '\n') + "]]b";
+            scanner_input += "-- [" + std::string(50, '-') + "\n";
+            scanner_input += "\"" + std::string(45, 's') + "\\n" + std::string(40, '\n') + "\\\"\"";
+            scanner_input += std::string(17, ' ') + "\"" + std::string(80, 'c') + "\x01\"";
+
+            exp_types = {IDENTIFIER, IDENTIFIER, STRING, ERROR_TYPE, ERROR_TYPE, ERROR_TYPE, EOF_TYPE};
+
+            exp_attrs = {"a", "b", "\"" + std::string(45, 's') + "\\n" + std::string(40, '\n') + "\\\"\"",
+                         "\"" + std::string(80, 'c')};
+        }
+};
+
+TEST_F(long_runs, types) {
+    testTypes();
+}
+
+TEST_F(long_runs, attributes) {
+    testAttributes();
+}
+
+TEST_F(long_runs, positions) {
+    get_next_token(&uut);
+    token_t t = get_next_token(&uut); //b
+    EXPECT_EQ(t.token_type, IDENTIFIER);
+    EXPECT_EQ(uut.cursor_pos[ROW], 71lu);
+    EXPECT_EQ(uut.cursor_pos[COL], 3lu);
+
+    t = get_next_token(&uut); //String with newlines
+    EXPECT_EQ(t.token_type, STRING);
+    EXPECT_EQ(uut.cursor_pos[ROW], 112lu);
+    EXPECT_EQ(uut.cursor_pos[COL], 4lu);
+}
+
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,1466 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                  ssa.c
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *      Purpose: Optimizations of functions in SSA form (before code is generated)
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file ssa.c
+ * @brief Optimizations of functions in SSA form (before code is generated)
+ * @note For more documentation about functions and structures @see ssa.h
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#include "ssa.h"
+#include "arena.h"
+#include "dstack.h"
+#include "dstring.h"
+#include "precedence_parser.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+
+#define NO_VAR UINT32_MAX /**< Value has no variable, that holds it */
+#define SSA_INT2NUM UINT16_MAX /**< Operation of implicit conversion (other operations are indexes of rules) */
+
+
+/**
+ * @brief Kind of SSA value
+ */
+typedef enum ssa_kind {
+    SSA_CONST, /**< Constant known in compile time */
+    SSA_OPAQUE, /**< Unknown value (parameter, result of function, phi value) */
+    SSA_EXPR, /**< Result of operation with other SSA values */
+} ssa_kind_t;
+
+
+/**
+ * @brief SSA value (it is defined only once and never changed)
+ */
+typedef struct ssa_value {
+    num_value_t num; /**< Value of numeric constant */
+    const char *text; /**< Text of other constant (string, bool or nil) */
+    uint32_t args[2]; /**< Operands of operation (the second one is the same as the first one in unary operations) */
+    uint32_t holder; /**< Variable, that got this value first (NO_VAR if there is no such variable) */
+    uint16_t op; /**< Index of rule of operation (@see get_rule()) or SSA_INT2NUM */
+    uint8_t kind; /**< Kind of value (@see ssa_kind_t) */
+    uint8_t dtype; /**< Data type of constant */
+} ssa_value_t;
+
+
+/**
+ * @brief Local variable or parameter of function
+ */
+typedef struct ssa_var {
+    const char *name; /**< Unique name of variable (in target code) */
+    uint32_t uses; /**< Number of reads of variable (it is counted by dead code elimination) */
+    bool is_param; /**< Parameters are never removed */
+    bool pinned; /**< Variable has definition, that cannot be removed */
+    bool maybe_nil; /**< Variable can contain nil (some of its definitions can be nil) */
+    uint32_t loop; /**< The last loop (its stamp), in which variable is assigned (used by loop-invariant code motion) */
+} ssa_var_t;
+
+
+DSTACK_DECL(ssa_value_t, ssa_val)
+DSTACK_DECL(ssa_var_t, ssa_var)
+DSTACK_DECL(uint32_t, ssa_env)
+
+DSTACK(ssa_value_t, ssa_val,)
+DSTACK(ssa_var_t, ssa_var,)
+DSTACK(uint32_t, ssa_env,)
+
+
+/**
+ * @brief State of optimization of one function
+ */
+typedef struct ssa {
+    ssa_val_stack_t values; /**< All SSA values of function */
+    ssa_var_stack_t vars; /**< Variables of function */
+    uint32_t *env; /**< Current SSA value of every variable */
+    ssa_env_stack_t saved; /**< Values of variables saved before branches of condition (and other temporary values) */
+    uint32_t *var_table; /**< Hash table with indexes of variables (incremented, zero means empty slot) */
+    size_t var_table_size;
+    uint32_t *gvn_table; /**< Hash table with indexes of values (incremented) for value numbering */
+    size_t gvn_table_size;
+    size_t gvn_num; /**< Number of values in hash table */
+    opt_level_t level;
+    bool error; /**< Allocation failed, tree is not changed anymore */
+} ssa_t;
+
+
+static ssa_value_t *get_value(ssa_t *ssa, uint32_t value) {
+    return ssa_val_get_ptr(&ssa->values, (int)value);
+}
+
+
+static uint64_t value_hash(ssa_value_t *v) {
+    uint64_t hash = hash_bytes(&v->kind, sizeof(v->kind), HASH_INIT);
+    hash = hash_bytes(&v->dtype, sizeof(v->dtype), hash);
+    if(v->kind == SSA_CONST) {
+        if(v->text) {
+            hash = hash_bytes(v->text, strlen(v->text), hash);
+        }
+        else {
+            hash = hash_bytes(&v->num, sizeof(v->num), hash);
+        }
+    }
+    else {
+        hash = hash_bytes(&v->op, sizeof(v->op), hash);
+        hash = hash_bytes(v->args, sizeof(v->args), hash);
+    }
+
+    return hash;
+}
+
+
+static bool value_eq(ssa_value_t *v1, ssa_value_t *v2) {
+    if(v1->kind != v2->kind || v1->dtype != v2->dtype) {
+        return false;
+    }
+
+    if(v1->kind == SSA_CONST) {
+        if(v1->text || v2->text) {
+            return v1->text && v2->text && strcmp(v1->text, v2->text) == 0;
+        }
+
+        return memcmp(&v1->num, &v2->num, sizeof(num_value_t)) == 0;
+    }
+
+    return v1->op == v2->op && v1->args[0] == v2->args[0] && v1->args[1] == v2->args[1];
+}
+
+
+/**
+ * @brief Puts value to hash table of value numbering (table is enlarged if it is needed)
+ */
+static void gvn_insert(ssa_t *ssa, uint32_t value) {
+    if((ssa->gvn_num + 1) * 2 > ssa->gvn_table_size) {
+        size_t new_size = ssa->gvn_table_size ? ssa->gvn_table_size * 2 : 64;
+        uint32_t *new_table = (uint32_t *)mem_alloc(sizeof(uint32_t) * new_size);
+        if(!new_table) {
+            ssa->error = true;
+            return;
+        }
+
+        memset(new_table, 0, sizeof(uint32_t) * new_size);
+        for(size_t i = 0; i < ssa->gvn_table_size; i++) { //Values are rehashed
+            if(ssa->gvn_table[i]) {
+                size_t slot = value_hash(get_value(ssa, ssa->gvn_table[i] - 1)) & (new_size - 1);
+                while(new_table[slot]) {
+                    slot = (slot + 1) & (new_size - 1);
+                }
+
+                new_table[slot] = ssa->gvn_table[i];
+            }
+        }
+
+        mem_free(ssa->gvn_table);
+        ssa->gvn_table = new_table;
+        ssa->gvn_table_size = new_size;
+    }
+
+    size_t slot = value_hash(get_value(ssa, value)) & (ssa->gvn_table_size - 1);
+    while(ssa->gvn_table[slot]) {
+        slot = (slot + 1) & (ssa->gvn_table_size - 1);
+    }
+
+    ssa->gvn_table[slot] = value + 1;
+    ssa->gvn_num++;
+}
+
+
+/**
+ * @brief Creates new SSA value (or finds the same one, if value numbering is turned on)
+ * @return Index of value or NO_VAR if an error occured
+ */
+static uint32_t new_value(ssa_t *ssa, ssa_value_t *v) {
+    bool numbered = ssa->level >= OPT_FULL && v->kind != SSA_OPAQUE;
+    if(numbered && ssa->gvn_table_size > 0) {
+        uint64_t hash = value_hash(v);
+        size_t slot = hash & (ssa->gvn_table_size - 1);
+        while(ssa->gvn_table[slot]) {
+            if(value_eq(get_value(ssa, ssa->gvn_table[slot] - 1), v)) {
+                return ssa->gvn_table[slot] - 1;
+            }
+
+            slot = (slot + 1) & (ssa->gvn_table_size - 1);
+        }
+    }
+
+    v->holder = NO_VAR;
+    if(!ssa_val_push(&ssa->values, *v)) {
+        ssa->error = true;
+        return NO_VAR;
+    }
+
+    uint32_t value = (uint32_t)ssa_val_get_top_ind(&ssa->values);
+    if(numbered) {
+        gvn_insert(ssa, value);
+    }
+
+    return value;
+}
+
+
+static uint32_t opaque(ssa_t *ssa) {
+    ssa_value_t v = {.kind = SSA_OPAQUE, .text = NULL};
+
+    return new_value(ssa, &v);
+}
+
+
+static uint32_t constant(ssa_t *ssa, sym_dtype_t dtype, num_value_t num, const char *text) {
+    ssa_value_t v = {.kind = SSA_CONST, .dtype = dtype, .num = num, .text = text};
+
+    return new_value(ssa, &v);
+}
+
+
+static uint32_t expression(ssa_t *ssa, uint16_t op, uint32_t a, uint32_t b) {
+    ssa_value_t v = {.kind = SSA_EXPR, .op = op, .args = {a, b}, .text = NULL};
+
+    return new_value(ssa, &v);
+}
+
+
+/**
+ * @return Index of variable with given name or NO_VAR if it is not variable of function
+ */
+static uint32_t find_var(ssa_t *ssa, const char *name) {
+    if(!ssa->var_table_size) {
+        return NO_VAR;
+    }
+
+    size_t slot = hash_bytes(name, strlen(name), HASH_INIT) & (ssa->var_table_size - 1);
+    while(ssa->var_table[slot]) {
+        uint32_t var = ssa->var_table[slot] - 1;
+        if(strcmp(ssa_var_get_ptr(&ssa->vars, (int)var)->name, name) == 0) {
+            return var;
+        }
+
+        slot = (slot + 1) & (ssa->var_table_size - 1);
+    }
+
+    return NO_VAR;
+}
+
+
+/**
+ * @brief Assigns SSA value to variable
+ */
+static void set_var(ssa_t *ssa, uint32_t var, uint32_t value) {
+    if(var == NO_VAR || value == NO_VAR) {
+        return;
+    }
+
+    ssa->env[var] = value;
+
+    ssa_value_t *v = get_value(ssa, value);
+    if(v->holder == NO_VAR || ssa->env[v->holder] != value) { //The old holder was overwritten
+        v->holder = var;
+    }
+}
+
+
+/**
+ * @return Variable, that currently holds given value (NO_VAR if there is no such variable)
+ */
+static uint32_t get_holder(ssa_t *ssa, uint32_t value) {
+    ssa_value_t *v = get_value(ssa, value);
+    if(v->holder != NO_VAR && ssa->env[v->holder] == value) {
+        return v->holder;
+    }
+
+    return NO_VAR;
+}
+
+
+/**
+ * @brief Rewrites node to literal with value of given constant
+ */
+static void to_literal(ast_node_t *node, ssa_value_t *v) {
+    if(v->dtype == INT || v->dtype == NUM) {
+        node->kind = AST_NUM;
+        node->u.num = v->num;
+    }
+    else {
+        node->kind = AST_VAL;
+        node->u.name = v->text;
+    }
+
+    node->m = v->dtype;
+    node->a = node->b = NULL;
+    node->n = 0;
+}
+
+
+/**
+ * @brief Rewrites expression to read of variable, that already holds its value (global value numbering)
+ */
+static void reuse(ssa_t *ssa, ast_node_t *node, uint32_t value) {
+    if(ssa->level < OPT_FULL || value == NO_VAR) {
+        return;
+    }
+
+    uint32_t holder = get_holder(ssa, value);
+    if(holder != NO_VAR) {
+        node->kind = AST_VAR;
+        node->u.name = ssa_var_get_ptr(&ssa->vars, (int)holder)->name;
+        node->a = node->b = NULL;
+        node->n = 0;
+    }
+}
+
+
+/**
+ * @brief Returns true if text of string constant has no escape sequence (so its characters are its bytes)
+ * @note Text of string constant contains quotes
+ */
+static bool is_plain(ssa_value_t *v) {
+    return v->dtype == STR && v->text && strlen(v->text) >= 2 && !strchr(v->text, '\\');
+}
+
+
+/**
+ * @brief Compares contents of plain string constants (without quotes)
+ */
+static int plain_cmp(ssa_value_t *a, ssa_value_t *b) {
+    size_t a_len = strlen(a->text) - 2, b_len = strlen(b->text) - 2;
+    int cmp = memcmp(a->text + 1, b->text + 1, a_len < b_len ? a_len : b_len);
+    if(cmp == 0) {
+        return (a_len > b_len) - (a_len < b_len);
+    }
+
+    return (cmp > 0) - (cmp < 0);
+}
+
+
+static bool is_numeric(ssa_value_t *v) {
+    return v->dtype == INT || v->dtype == NUM;
+}
+
+
+static double to_double(ssa_value_t *v) {
+    return v->dtype == INT ? (double)v->num.integer : v->num.number;
+}
+
+
+/**
+ * @brief Computes result of integer operation (if it does not overflow)
+ * @return False if result can't be computed in compile time
+ */
+static bool fold_int(const char *op, long long a, long long b, long long *res) {
+    if(strcmp(op, "E+E") == 0) {
+        if((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b)) {
+            return false;
+        }
+
+        *res = a + b;
+    }
+    else if(strcmp(op, "E-E") == 0) {
+        if((b < 0 && a > LLONG_MAX + b) || (b > 0 && a < LLONG_MIN + b)) {
+            return false;
+        }
+
+        *res = a - b;
+    }
+    else if(strcmp(op, "E*E") == 0) {
+        if(a != 0 && b != 0 && (a > LLONG_MAX / (b < 0 ? -b : b) || a < -(LLONG_MAX / (b < 0 ? -b : b)) || b == LLONG_MIN)) {
+            return false;
+        }
+
+        *res = a * b;
+    }
+    else if(strcmp(op, "E//E") == 0 && a >= 0 && b > 0) { //Rounding of negative operands is left to interpreter
+        *res = a / b;
+    }
+    else if(strcmp(op, "E%E") == 0 && a >= 0 && b > 0) {
+        *res = a % b;
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Computes result of operation with numbers (integers are converted as by $BUILTIN$sametypes)
+ * @return False if result can't be computed in compile time
+ */
+static bool fold_num(const char *op, double a, double b, double *res) {
+    if(strcmp(op, "E+E") == 0) {
+        *res = a + b;
+    }
+    else if(strcmp(op, "E-E") == 0) {
+        *res = a - b;
+    }
+    else if(strcmp(op, "E*E") == 0) {
+        *res = a * b;
+    }
+    else if(strcmp(op, "E/E") == 0 && b != 0.0) {
+        *res = a / b;
+    }
+    else {
+        return false;
+    }
+
+    return isfinite(*res);
+}
+
+
+/**
+ * @brief Compares constants (relational operators)
+ * @return False if result can't be computed in compile time
+ */
+static bool fold_cmp(const char *op, ssa_value_t *a, ssa_value_t *b, bool *res) {
+    int cmp;
+    if(a->dtype == INT && b->dtype == INT) {
+        cmp = (a->num.integer > b->num.integer) - (a->num.integer < b->num.integer);
+    }
+    else if(is_numeric(a) && is_numeric(b)) {
+        double x = to_double(a), y = to_double(b);
+        cmp = (x > y) - (x < y);
+    }
+    else if(is_plain(a) && is_plain(b)) {
+        cmp = plain_cmp(a, b);
+    }
+    else {
+        return false;
+    }
+
+    if(strcmp(op, "E<E") == 0) {
+        *res = cmp < 0;
+    }
+    else if(strcmp(op, "E>E") == 0) {
+        *res = cmp > 0;
+    }
+    else if(strcmp(op, "E<=E") == 0) {
+        *res = cmp <= 0;
+    }
+    else if(strcmp(op, "E>=E") == 0) {
+        *res = cmp >= 0;
+    }
+    else if(strcmp(op, "E==E") == 0) {
+        *res = cmp == 0;
+    }
+    else if(strcmp(op, "E~=E") == 0) {
+        *res = cmp != 0;
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Constant folding of operation
+ * @return Constant value or NO_VAR if operation can't be computed in compile time
+ */
+static uint32_t fold(ssa_t *ssa, uint16_t op, uint32_t a, uint32_t b) {
+    const expr_rule_t *rule = get_rule(op);
+    ssa_value_t *x = get_value(ssa, a), *y = get_value(ssa, b);
+    if(!rule || x->kind != SSA_CONST || y->kind != SSA_CONST) {
+        return NO_VAR;
+    }
+
+    const char *pattern = rule->right_side;
+    num_value_t res = {.integer = 0};
+    bool cmp;
+    if(strcmp(pattern, "_E") == 0) {
+        if(x->dtype == INT && x->num.integer != LLONG_MIN) {
+            res.integer = -x->num.integer;
+            return constant(ssa, INT, res, NULL);
+        }
+        else if(x->dtype == NUM) {
+            res.number = -x->num.number;
+            return constant(ssa, NUM, res, NULL);
+        }
+    }
+    else if(strcmp(pattern, "#E") == 0) {
+        if(is_plain(x)) {
+            res.integer = (long long)strlen(x->text) - 2;
+            return constant(ssa, INT, res, NULL);
+        }
+    }
+    else if(x->dtype == INT && y->dtype == INT && fold_int(pattern, x->num.integer, y->num.integer, &res.integer)) {
+        return constant(ssa, INT, res, NULL);
+    }
+    else if(is_numeric(x) && is_numeric(y) && (x->dtype == NUM || y->dtype == NUM || strcmp(pattern, "E/E") == 0) &&
+            fold_num(pattern, to_double(x), to_double(y), &res.number)) {
+        return constant(ssa, NUM, res, NULL);
+    }
+    else if(fold_cmp(pattern, x, y, &cmp)) {
+        return constant(ssa, BOOL, res, cmp ? "true" : "false");
+    }
+
+    return NO_VAR;
+}
+
+
+/**
+ * @brief Value after implicit conversion of integer to number
+ */
+static uint32_t int2num(ssa_t *ssa, uint32_t value) {
+    ssa_value_t *v = get_value(ssa, value);
+    if(v->kind == SSA_CONST) {
+        if(v->dtype != INT) { //Numbers and nils are not converted
+            return value;
+        }
+
+        num_value_t res = {.number = (double)v->num.integer};
+        return constant(ssa, NUM, res, NULL);
+    }
+
+    return expression(ssa, SSA_INT2NUM, value, value);
+}
+
+
+/**
+ * @brief Computes SSA values of expression and optimizes it
+ * @return Value of expression (NO_VAR if an error occured)
+ */
+static uint32_t eval(ssa_t *ssa, ast_node_t *node) {
+    if(ssa->error) {
+        return NO_VAR;
+    }
+
+    switch(node->kind) {
+        case AST_NUM:
+            return constant(ssa, node->m, node->u.num, NULL);
+        case AST_VAL: {
+            num_value_t zero = {.integer = 0};
+            return constant(ssa, node->m, zero, node->u.name);
+        }
+        case AST_VAR: {
+            uint32_t var = find_var(ssa, node->u.name);
+            if(var == NO_VAR) {
+                return opaque(ssa);
+            }
+
+            uint32_t value = ssa->env[var];
+            ssa_value_t *v = get_value(ssa, value);
+            if(v->kind == SSA_CONST) { //Constant propagation
+                to_literal(node, v);
+            }
+            else {
+                uint32_t holder = get_holder(ssa, value);
+                if(holder != NO_VAR && holder != var) { //Copy propagation
+                    node->u.name = ssa_var_get_ptr(&ssa->vars, (int)holder)->name;
+                }
+            }
+
+            return value;
+        }
+        case AST_CALL:
+            for(ast_node_t *arg = node->a; arg; arg = arg->next) {
+                eval(ssa, arg);
+            }
+
+            return opaque(ssa);
+        case AST_DUMP:
+            eval(ssa, node->a);
+            return opaque(ssa);
+        case AST_INT2NUM: {
+            uint32_t a = eval(ssa, node->a);
+            if(a == NO_VAR) {
+                return NO_VAR;
+            }
+
+            uint32_t value = int2num(ssa, a);
+            if(value != NO_VAR && get_value(ssa, value)->kind == SSA_CONST) {
+                to_literal(node, get_value(ssa, value));
+            }
+            else {
+                reuse(ssa, node, value);
+            }
+
+            return value;
+        }
+        case AST_OP: {
+            uint32_t a = eval(ssa, node->a);
+            uint32_t b = node->b ? eval(ssa, node->b) : a;
+            if(a == NO_VAR || b == NO_VAR) {
+                return NO_VAR;
+            }
+
+            uint32_t value = fold(ssa, (uint16_t)node->n, a, b);
+            if(value != NO_VAR) { //Constant folding
+                to_literal(node, get_value(ssa, value));
+                return value;
+            }
+
+            value = expression(ssa, (uint16_t)node->n, a, b);
+            reuse(ssa, node, value);
+
+            return value;
+        }
+        default:
+            return opaque(ssa);
+    }
+}
+
+
+/**
+ * @brief Sets phi values to all variables, that are defined inside loop body
+ */
+static void loop_phis(ssa_t *ssa, ast_node_t *block) {
+    for(ast_node_t *stmt = block; stmt; stmt = stmt->next) {
+        if(stmt->kind == AST_LOCAL) {
+            set_var(ssa, find_var(ssa, stmt->u.name), opaque(ssa));
+        }
+        else if(stmt->kind == AST_ASSIGN) {
+            for(ast_node_t *var = stmt->a; var; var = var->next) {
+                set_var(ssa, find_var(ssa, var->u.name), opaque(ssa));
+            }
+        }
+        else if(stmt->kind == AST_IF) {
+            loop_phis(ssa, stmt->b);
+            loop_phis(ssa, stmt->u.c);
+        }
+        else if(stmt->kind == AST_WHILE) {
+            loop_phis(ssa, stmt->b);
+        }
+    }
+}
+
+
+/**
+ * @brief Assigns values to variables (values are evaluated first)
+ */
+static void assign(ssa_t *ssa, ast_node_t *stmt) {
+    size_t base = ssa->saved.top, value_cnt = 0;
+    for(ast_node_t *value = stmt->b; value; value = value->next, value_cnt++) {
+        if(!ssa_env_push(&ssa->saved, eval(ssa, value))) {
+            ssa->error = true;
+        }
+    }
+
+    size_t target_cnt = 0;
+    for(ast_node_t *var = stmt->a; var; var = var->next) {
+        target_cnt++;
+    }
+
+    if(ssa->error) {
+        return;
+    }
+
+    //The last expression can be function, that returns more values
+    size_t i = 0;
+    for(ast_node_t *var = stmt->a; var; var = var->next, i++) {
+        bool is_single = i + 1 < value_cnt || (i + 1 == value_cnt && target_cnt == value_cnt);
+        uint32_t value = is_single ? *ssa_env_get_ptr(&ssa->saved, (int)(base + i)) : opaque(ssa);
+        if(value != NO_VAR && (var->flags & AST_CONVERT)) {
+            value = int2num(ssa, value);
+        }
+
+        set_var(ssa, find_var(ssa, var->u.name), value);
+    }
+
+    ssa_env_pop_n(&ssa->saved, NULL, value_cnt);
+}
+
+
+/**
+ * @brief Returns true if constant condition is true (@see $BUILTIN$tobool)
+ */
+static bool is_true(ssa_value_t *v) {
+    if(v->dtype == BOOL) {
+        return strcmp(v->text, "true") == 0;
+    }
+
+    return v->dtype != NIL;
+}
+
+
+/**
+ * @brief Replaces statement (pointed by link) by given list of statements
+ */
+static void splice(ast_node_t **link, ast_node_t *stmt, ast_node_t *list) {
+    if(!list) {
+        *link = stmt->next;
+        return;
+    }
+
+    ast_node_t *last = list;
+    while(last->next) {
+        last = last->next;
+    }
+
+    last->next = stmt->next;
+    *link = list;
+}
+
+
+static bool walk_block(ssa_t *ssa, ast_node_t **link, size_t nest_lvl);
+
+
+/**
+ * @brief Optimizes both branches of condition and merges values of variables after them
+ * @return True if both branches end by return
+ */
+static bool walk_if(ssa_t *ssa, ast_node_t *stmt, size_t nest_lvl) {
+    size_t var_num = ssa->vars.top, base = ssa->saved.top;
+    if(!ssa_env_push_n(&ssa->saved, ssa->env, var_num)) {
+        ssa->error = true;
+        return false;
+    }
+
+    bool then_ret = walk_block(ssa, &stmt->b, nest_lvl);
+    if(!ssa_env_push_n(&ssa->saved, ssa->env, var_num)) {
+        ssa->error = true;
+        return false;
+    }
+
+    memcpy(ssa->env, ssa_env_get_ptr(&ssa->saved, (int)base), sizeof(uint32_t) * var_num);
+    bool else_ret = walk_block(ssa, &stmt->u.c, nest_lvl);
+
+    for(size_t i = 0; i < var_num && !ssa->error; i++) {
+        uint32_t then_value = *ssa_env_get_ptr(&ssa->saved, (int)(base + var_num + i));
+        if(else_ret && !then_ret) { //Only values from branch, that continues after condition are used
+            set_var(ssa, i, then_value);
+        }
+        else if(then_value != ssa->env[i] && !then_ret) {
+            set_var(ssa, i, opaque(ssa)); //Phi value
+        }
+    }
+
+    ssa_env_pop_n(&ssa->saved, NULL, 2 * var_num);
+
+    return then_ret && else_ret;
+}
+
+
+/**
+ * @brief Optimizes statements of block (statements after return are removed)
+ * @return True if block ends by return
+ */
+static bool walk_block(ssa_t *ssa, ast_node_t **link, size_t nest_lvl) {
+    bool returned = false;
+    while(*link && !ssa->error) {
+        ast_node_t *stmt = *link;
+        if(returned) { //Unreachable code
+            *link = NULL;
+            break;
+        }
+
+        switch(stmt->kind) {
+            case AST_LOCAL: {
+                uint32_t value;
+                if(stmt->a) {
+                    value = eval(ssa, stmt->a);
+                }
+                else if(nest_lvl > 0) { //It keeps value from previous iteration (variable is declared before loop)
+                    value = opaque(ssa);
+                }
+                else {
+                    num_value_t zero = {.integer = 0};
+                    value = constant(ssa, NIL, zero, "nil");
+                }
+
+                set_var(ssa, find_var(ssa, stmt->u.name), value);
+                break;
+            }
+            case AST_ASSIGN:
+                assign(ssa, stmt);
+                break;
+            case AST_CALL:
+                eval(ssa, stmt);
+                break;
+            case AST_IF: {
+                uint32_t cond = eval(ssa, stmt->a);
+                if(cond != NO_VAR && get_value(ssa, cond)->kind == SSA_CONST) { //Only one branch is used
+                    splice(link, stmt, is_true(get_value(ssa, cond)) ? stmt->b : stmt->u.c);
+                    continue;
+                }
+
+                returned = walk_if(ssa, stmt, nest_lvl);
+                break;
+            }
+            case AST_WHILE: {
+                loop_phis(ssa, stmt->b);
+                uint32_t cond = eval(ssa, stmt->a);
+                ssa_value_t *v = cond != NO_VAR ? get_value(ssa, cond) : NULL;
+                if(v && v->kind == SSA_CONST && !is_true(v)) { //Body is never executed
+                    *link = stmt->next;
+                    continue;
+                }
+
+                //Values of variables after loop are the same as at its condition
+                size_t var_num = ssa->vars.top, base = ssa->saved.top;
+                if(!ssa_env_push_n(&ssa->saved, ssa->env, var_num)) {
+                    ssa->error = true;
+                    break;
+                }
+
+                walk_block(ssa, &stmt->b, nest_lvl + 1);
+                memcpy(ssa->env, ssa_env_get_ptr(&ssa->saved, (int)base), sizeof(uint32_t) * var_num);
+                ssa_env_pop_n(&ssa->saved, NULL, var_num);
+                break;
+            }
+            case AST_RETURN:
+                for(ast_node_t *value = stmt->a; value; value = value->next) {
+                    eval(ssa, value);
+                }
+
+                returned = true;
+                break;
+            default:
+                break;
+        }
+
+        link = &stmt->next;
+    }
+
+    return returned;
+}
+
+
+/**
+ * @brief Returns true if expression can be removed (it cannot fail and it has no side effects)
+ * @param only_literals If true, variables are not allowed (operations with them can fail because of nil)
+ */
+static bool is_removable(ast_node_t *expr, bool only_literals) {
+    switch(expr->kind) {
+        case AST_NUM:
+            return true;
+        case AST_VAL:
+            return !only_literals || expr->m != NIL;
+        case AST_VAR:
+            return !only_literals;
+        case AST_INT2NUM:
+            return is_removable(expr->a, only_literals);
+        case AST_OP: {
+            const char *pattern = get_rule(expr->n)->right_side;
+            if(strcmp(pattern, "E/E") == 0 || strcmp(pattern, "E//E") == 0 ||
+               strcmp(pattern, "E%E") == 0 || strcmp(pattern, "E^E") == 0) { //Division by zero
+                return false;
+            }
+
+            return is_removable(expr->a, true) && (!expr->b || is_removable(expr->b, true));
+        }
+        default:
+            return false;
+    }
+}
+
+
+static bool are_removable(ast_node_t *list) {
+    for(ast_node_t *expr = list; expr; expr = expr->next) {
+        if(!is_removable(expr, false)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static ssa_var_t *get_var(ssa_t *ssa, const char *name) {
+    uint32_t var = find_var(ssa, name);
+
+    return var != NO_VAR ? ssa_var_get_ptr(&ssa->vars, (int)var) : NULL;
+}
+
+
+/**
+ * @brief Counts reads of variables in list of expressions
+ */
+static void count_uses(ssa_t *ssa, ast_node_t *expr) {
+    for(; expr; expr = expr->next) {
+        if(expr->kind == AST_VAR) {
+            ssa_var_t *var = get_var(ssa, expr->u.name);
+            if(var) {
+                var->uses++;
+            }
+        }
+        else if(expr->kind == AST_CALL || expr->kind == AST_DUMP || expr->kind == AST_INT2NUM) {
+            count_uses(ssa, expr->a);
+        }
+        else if(expr->kind == AST_OP) {
+            count_uses(ssa, expr->a);
+            count_uses(ssa, expr->b);
+        }
+    }
+}
+
+
+/**
+ * @brief Returns true if variable is never read (and it is not parameter)
+ */
+static bool is_dead(ssa_t *ssa, const char *name) {
+    ssa_var_t *var = get_var(ssa, name);
+
+    return var && !var->is_param && var->uses == 0;
+}
+
+
+/**
+ * @brief Counts uses of variables and finds variables with definitions, that can't be removed
+ */
+static void mark_block(ssa_t *ssa, ast_node_t *block) {
+    for(ast_node_t *stmt = block; stmt; stmt = stmt->next) {
+        switch(stmt->kind) {
+            case AST_LOCAL:
+                if(stmt->a) {
+                    count_uses(ssa, stmt->a);
+                    if(!is_removable(stmt->a, false)) {
+                        get_var(ssa, stmt->u.name)->pinned = true;
+                    }
+                }
+
+                break;
+            case AST_ASSIGN:
+                count_uses(ssa, stmt->b);
+                break;
+            case AST_CALL:
+                count_uses(ssa, stmt->a);
+                break;
+            case AST_IF:
+                count_uses(ssa, stmt->a);
+                mark_block(ssa, stmt->b);
+                mark_block(ssa, stmt->u.c);
+                break;
+            case AST_WHILE:
+                count_uses(ssa, stmt->a);
+                mark_block(ssa, stmt->b);
+                break;
+            case AST_RETURN:
+                count_uses(ssa, stmt->a);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+
+/**
+ * @brief Pins targets of assignments, that are kept (their variables must be declared)
+ * @note Uses of variables must be already counted
+ */
+static void pin_block(ssa_t *ssa, ast_node_t *block) {
+    for(ast_node_t *stmt = block; stmt; stmt = stmt->next) {
+        if(stmt->kind == AST_ASSIGN) {
+            bool is_dead_stmt = are_removable(stmt->b);
+            for(ast_node_t *var = stmt->a; var && is_dead_stmt; var = var->next) {
+                is_dead_stmt = is_dead(ssa, var->u.name);
+            }
+
+            for(ast_node_t *var = stmt->a; var && !is_dead_stmt; var = var->next) {
+                ssa_var_t *target = get_var(ssa, var->u.name);
+                if(target) {
+                    target->pinned = true;
+                }
+            }
+        }
+        else if(stmt->kind == AST_IF) {
+            pin_block(ssa, stmt->b);
+            pin_block(ssa, stmt->u.c);
+        }
+        else if(stmt->kind == AST_WHILE) {
+            pin_block(ssa, stmt->b);
+        }
+    }
+}
+
+
+/**
+ * @brief Removes definitions of variables, that are never read
+ * @return True if something was removed
+ */
+static bool sweep_block(ssa_t *ssa, ast_node_t **link) {
+    bool removed = false;
+    while(*link) {
+        ast_node_t *stmt = *link;
+        bool is_dead_stmt = false;
+        if(stmt->kind == AST_LOCAL) {
+            is_dead_stmt = is_dead(ssa, stmt->u.name) && !get_var(ssa, stmt->u.name)->pinned;
+        }
+        else if(stmt->kind == AST_ASSIGN) {
+            is_dead_stmt = are_removable(stmt->b);
+            for(ast_node_t *var = stmt->a; var && is_dead_stmt; var = var->next) {
+                is_dead_stmt = is_dead(ssa, var->u.name);
+            }
+        }
+        else if(stmt->kind == AST_IF) {
+            removed = sweep_block(ssa, &stmt->b) || removed;
+            removed = sweep_block(ssa, &stmt->u.c) || removed;
+        }
+        else if(stmt->kind == AST_WHILE) {
+            removed = sweep_block(ssa, &stmt->b) || removed;
+        }
+
+        if(is_dead_stmt) {
+            *link = stmt->next;
+            removed = true;
+        }
+        else {
+            link = &stmt->next;
+        }
+    }
+
+    return removed;
+}
+
+
+/**
+ * @brief Dead code elimination (definitions of unused variables are removed until there is nothing to remove)
+ */
+static void remove_dead(ssa_t *ssa, ast_node_t **body) {
+    do {
+        for(size_t i = 0; i < ssa->vars.top; i++) {
+            ssa_var_t *var = ssa_var_get_ptr(&ssa->vars, (int)i);
+            var->uses = 0;
+            var->pinned = false;
+        }
+
+        mark_block(ssa, *body);
+        pin_block(ssa, *body);
+    } while(sweep_block(ssa, body));
+}
+
+
+static void add_var(ssa_t *ssa, const char *name, bool is_param) {
+    ssa_var_t var = {.name = name, .uses = 0, .is_param = is_param, .pinned = false, .maybe_nil = is_param, .loop = 0};
+    if(!ssa_var_push(&ssa->vars, var)) {
+        ssa->error = true;
+    }
+}
+
+
+/**
+ * @brief Finds all local variables of block
+ */
+static void collect_vars(ssa_t *ssa, ast_node_t *block) {
+    for(ast_node_t *stmt = block; stmt; stmt = stmt->next) {
+        if(stmt->kind == AST_LOCAL) {
+            add_var(ssa, stmt->u.name, false);
+        }
+        else if(stmt->kind == AST_IF) {
+            collect_vars(ssa, stmt->b);
+            collect_vars(ssa, stmt->u.c);
+        }
+        else if(stmt->kind == AST_WHILE) {
+            collect_vars(ssa, stmt->b);
+        }
+    }
+}
+
+
+/**
+ * @brief Creates hash table of variables and sets their initial values
+ */
+static void init_vars(ssa_t *ssa) {
+    size_t var_num = ssa->vars.top;
+    ssa->var_table_size = 16;
+    while(ssa->var_table_size < var_num * 2) {
+        ssa->var_table_size *= 2;
+    }
+
+    ssa->var_table = (uint32_t *)mem_alloc(sizeof(uint32_t) * ssa->var_table_size);
+    ssa->env = (uint32_t *)mem_alloc(sizeof(uint32_t) * (var_num + 1));
+    if(!ssa->var_table || !ssa->env) {
+        ssa->error = true;
+        return;
+    }
+
+    memset(ssa->var_table, 0, sizeof(uint32_t) * ssa->var_table_size);
+    for(size_t i = 0; i < var_num; i++) {
+        const char *name = ssa_var_get_ptr(&ssa->vars, (int)i)->name;
+        size_t slot = hash_bytes(name, strlen(name), HASH_INIT) & (ssa->var_table_size - 1);
+        while(ssa->var_table[slot]) {
+            slot = (slot + 1) & (ssa->var_table_size - 1);
+        }
+
+        ssa->var_table[slot] = i + 1;
+        ssa->env[i] = NO_VAR;
+        set_var(ssa, i, opaque(ssa)); //Parameters (and variables before declaration) have unknown values
+    }
+}
+
+
+/**
+ * @brief State of loop-invariant code motion
+ */
+typedef struct licm {
+    ssa_t *ssa;
+    ast_t *ast; /**< Tree, whose arena is used for declarations of temporary variables */
+    const char *f_name;
+    uint32_t tmp_num; /**< Number of created temporary variables */
+    uint32_t stamp; /**< Stamp of loop, that is being processed */
+    ast_node_t **insert; /**< Place before the loop, where the next declaration of temporary variable is inserted */
+} licm_t;
+
+
+/**
+ * @brief Returns true if value of expression can't be nil
+ */
+static bool is_non_nil(ssa_t *ssa, ast_node_t *expr) {
+    switch(expr->kind) {
+        case AST_NUM:
+        case AST_OP: //Result of operation is never nil
+            return true;
+        case AST_VAL:
+            return expr->m != NIL;
+        case AST_VAR: {
+            ssa_var_t *var = get_var(ssa, expr->u.name);
+            return var && !var->maybe_nil;
+        }
+        case AST_INT2NUM:
+            return is_non_nil(ssa, expr->a);
+        default:
+            return false;
+    }
+}
+
+
+static void set_maybe_nil(ssa_t *ssa, const char *name, bool *changed) {
+    ssa_var_t *var = get_var(ssa, name);
+    if(var && !var->maybe_nil) {
+        var->maybe_nil = true;
+        *changed = true;
+    }
+}
+
+
+/**
+ * @brief Finds variables, that can contain nil (any of their definitions can be nil)
+ * @note It does not depend on order of statements, so it must be repeated until nothing is changed
+ */
+static void find_nils(ssa_t *ssa, ast_node_t *block, bool *changed) {
+    for(ast_node_t *stmt = block; stmt; stmt = stmt->next) {
+        if(stmt->kind == AST_LOCAL && (!stmt->a || !is_non_nil(ssa, stmt->a))) {
+            set_maybe_nil(ssa, stmt->u.name, changed);
+        }
+        else if(stmt->kind == AST_ASSIGN) {
+            ast_node_t *value = stmt->b;
+            for(ast_node_t *var = stmt->a; var; var = var->next) {
+                //Values of the last expression (function call) can be nil
+                bool is_single = value && (value->next || !var->next);
+                if(!is_single || !is_non_nil(ssa, value)) {
+                    set_maybe_nil(ssa, var->u.name, changed);
+                }
+
+                value = value && value->next ? value->next : NULL;
+            }
+        }
+        else if(stmt->kind == AST_IF) {
+            find_nils(ssa, stmt->b, changed);
+            find_nils(ssa, stmt->u.c, changed);
+        }
+        else if(stmt->kind == AST_WHILE) {
+            find_nils(ssa, stmt->b, changed);
+        }
+    }
+}
+
+
+/**
+ * @brief Stamps variables, that are assigned (or declared) in block
+ */
+static void stamp_block(licm_t *licm, ast_node_t *block) {
+    for(ast_node_t *stmt = block; stmt; stmt = stmt->next) {
+        if(stmt->kind == AST_LOCAL) {
+            ssa_var_t *var = get_var(licm->ssa, stmt->u.name);
+            if(var) {
+                var->loop = licm->stamp;
+            }
+        }
+        else if(stmt->kind == AST_ASSIGN) {
+            for(ast_node_t *target = stmt->a; target; target = target->next) {
+                ssa_var_t *var = get_var(licm->ssa, target->u.name);
+                if(var) {
+                    var->loop = licm->stamp;
+                }
+            }
+        }
+        else if(stmt->kind == AST_IF) {
+            stamp_block(licm, stmt->b);
+            stamp_block(licm, stmt->u.c);
+        }
+        else if(stmt->kind == AST_WHILE) {
+            stamp_block(licm, stmt->b);
+        }
+    }
+}
+
+
+/**
+ * @brief Returns true if expression has the same value in every iteration of current loop
+ * @note Temporary variables (they are not in ssa->vars) are declared inside outer loops, so they are not invariant
+ */
+static bool is_invariant(licm_t *licm, ast_node_t *expr) {
+    switch(expr->kind) {
+        case AST_NUM:
+        case AST_VAL:
+            return true;
+        case AST_VAR: {
+            ssa_var_t *var = get_var(licm->ssa, expr->u.name);
+            return var && var->loop != licm->stamp;
+        }
+        case AST_OP:
+            return is_invariant(licm, expr->a) && (!expr->b || is_invariant(licm, expr->b));
+        case AST_INT2NUM:
+            return is_invariant(licm, expr->a);
+        default: //Function calls are not pure
+            return false;
+    }
+}
+
+
+/**
+ * @brief Returns true if operation can fail even with operands, that are not nil (division by zero)
+ */
+static bool can_fail_div(ast_node_t *op) {
+    const char *pattern = get_rule(op->n)->right_side;
+    if(strcmp(pattern, "E/E") != 0 && strcmp(pattern, "E//E") != 0 &&
+       strcmp(pattern, "E%E") != 0 && strcmp(pattern, "E^E") != 0) {
+        return false;
+    }
+
+    ast_node_t *divisor = op->b;
+    if(divisor->kind != AST_NUM || strcmp(pattern, "E^E") == 0) {
+        return true;
+    }
+
+    return divisor->m == INT ? divisor->u.num.integer == 0 : divisor->u.num.number == 0.0;
+}
+
+
+/**
+ * @brief Returns true if expression can fail by division by zero (anywhere in it)
+ */
+static bool has_fallible_div(ast_node_t *expr) {
+    if(expr->kind == AST_OP) {
+        return can_fail_div(expr) || has_fallible_div(expr->a) || (expr->b && has_fallible_div(expr->b));
+    }
+    else if(expr->kind == AST_INT2NUM) {
+        return has_fallible_div(expr->a);
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Returns true if evaluation of expression can't fail (it can be evaluated even if it was not evaluated originally)
+ */
+static bool is_fault_free(ssa_t *ssa, ast_node_t *expr) {
+    if(expr->kind == AST_OP) {
+        return !can_fail_div(expr) && is_non_nil(ssa, expr->a) && is_fault_free(ssa, expr->a) &&
+               (!expr->b || (is_non_nil(ssa, expr->b) && is_fault_free(ssa, expr->b)));
+    }
+    else if(expr->kind == AST_INT2NUM) { //Nil is not converted, so it does not fail
+        return is_fault_free(ssa, expr->a);
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Moves expression to new temporary variable declared before the loop and replaces it by the variable
+ */
+static void hoist(licm_t *licm, ast_node_t **link) {
+    size_t name_len = strlen(licm->f_name) + 16;
+    char *name = (char *)arena_alloc(&licm->ast->arena, name_len);
+    ast_node_t *local = ast_node(licm->ast, AST_LOCAL);
+    ast_node_t *var = ast_node(licm->ast, AST_VAR);
+    if(!name || !local || !var) {
+        return;
+    }
+
+    //Identifiers can't be empty, so the name can't collide with names of other variables
+    snprintf(name, name_len, "%s$$%u", licm->f_name, (unsigned)licm->tmp_num++);
+
+    ast_node_t *expr = *link;
+    var->u.name = local->u.name = name;
+    var->next = expr->next;
+    expr->next = NULL;
+    local->a = expr;
+    *link = var;
+
+    local->next = *licm->insert;
+    *licm->insert = local;
+    licm->insert = &local->next;
+}
+
+
+/**
+ * @brief Hoists the biggest invariant subexpressions of expression
+ * @param blocked Pointer to flag, that is set, when it is not possible to hoist expressions, that can fail
+ *                (something, that can have other effect, was evaluated before) or NULL if only expressions,
+ *                that can't fail, can be hoisted (expression is not evaluated at the beginning of every iteration)
+ */
+static void hoist_expr(licm_t *licm, ast_node_t **link, bool *blocked) {
+    ast_node_t *expr = *link;
+    bool is_computed = expr->kind == AST_OP || expr->kind == AST_INT2NUM;
+    if(is_computed && is_invariant(licm, expr)) {
+        //Expression can fail only by nil (before the loop it fails with the same code as inside)
+        bool can_fail_first = blocked && !*blocked && !has_fallible_div(expr);
+        if(can_fail_first || is_fault_free(licm->ssa, expr)) {
+            hoist(licm, link);
+            return;
+        }
+    }
+
+    if(expr->kind == AST_CALL) {
+        for(ast_node_t **arg = &expr->a; *arg; arg = &(*arg)->next) {
+            hoist_expr(licm, arg, blocked);
+        }
+    }
+    else if(expr->kind == AST_OP || expr->kind == AST_INT2NUM || expr->kind == AST_DUMP) {
+        hoist_expr(licm, &expr->a, blocked);
+        if(expr->kind == AST_OP && expr->b) {
+            hoist_expr(licm, &expr->b, blocked);
+        }
+    }
+
+    if(blocked && (expr->kind == AST_CALL || (expr->kind == AST_OP && can_fail_div(expr)))) {
+        *blocked = true;
+    }
+}
+
+
+static void hoist_list(licm_t *licm, ast_node_t **list) {
+    for(ast_node_t **link = list; *link; link = &(*link)->next) {
+        hoist_expr(licm, link, NULL);
+    }
+}
+
+
+/**
+ * @brief Hoists invariant expressions, that can't fail, from all statements of block (including nested blocks)
+ */
+static void hoist_block(licm_t *licm, ast_node_t *block) {
+    for(ast_node_t *stmt = block; stmt; stmt = stmt->next) {
+        switch(stmt->kind) {
+            case AST_LOCAL:
+                if(stmt->a) {
+                    hoist_expr(licm, &stmt->a, NULL);
+                }
+
+                break;
+            case AST_ASSIGN:
+                hoist_list(licm, &stmt->b);
+                break;
+            case AST_CALL:
+            case AST_RETURN:
+                hoist_list(licm, &stmt->a);
+                break;
+            case AST_IF:
+                hoist_expr(licm, &stmt->a, NULL);
+                hoist_block(licm, stmt->b);
+                hoist_block(licm, stmt->u.c);
+                break;
+            case AST_WHILE:
+                hoist_expr(licm, &stmt->a, NULL);
+                hoist_block(licm, stmt->b);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+
+/**
+ * @brief Loop-invariant code motion in block (nested loops are processed first)
+ */
+static void licm_block(licm_t *licm, ast_node_t **link) {
+    for(; *link; link = &(*link)->next) {
+        ast_node_t *stmt = *link;
+        if(stmt->kind == AST_IF) {
+            licm_block(licm, &stmt->b);
+            licm_block(licm, &stmt->u.c);
+        }
+        else if(stmt->kind == AST_WHILE) {
+            licm_block(licm, &stmt->b);
+
+            licm->stamp++;
+            licm->insert = link;
+            stamp_block(licm, stmt->b);
+
+            //Condition is evaluated at the beginning of every iteration, so even expressions, that can fail, are hoisted
+            bool blocked = false;
+            hoist_expr(licm, &stmt->a, &blocked);
+            hoist_block(licm, stmt->b);
+
+            link = licm->insert; //Declarations of temporary variables are skipped
+        }
+    }
+}
+
+
+/**
+ * @brief Moves computations of loops, that give the same value in every iteration, before the loops
+ */
+static void move_invariants(ssa_t *ssa, ast_node_t *func, ast_t *ast) {
+    bool changed = true;
+    while(changed) {
+        changed = false;
+        find_nils(ssa, func->b, &changed);
+    }
+
+    licm_t licm = {.ssa = ssa, .ast = ast, .f_name = func->u.name, .tmp_num = 0, .stamp = 0, .insert = NULL};
+    licm_block(&licm, &func->b);
+}
+
+
+void ssa_optimize(ast_node_t *node, opt_level_t level, ast_t *ast) {
+    if(level == OPT_NONE) {
+        return;
+    }
+
+    ssa_t ssa = {.env = NULL, .var_table = NULL, .var_table_size = 0, .gvn_table = NULL,
+                 .gvn_table_size = 0, .gvn_num = 0, .level = level, .error = false};
+
+    if(!ssa_val_stack_init(&ssa.values) || !ssa_var_stack_init(&ssa.vars) || !ssa_env_stack_init(&ssa.saved)) {
+        ssa.error = true;
+    }
+
+    if(!ssa.error && node->kind == AST_FUNCTION && !(node->flags & AST_REUSED)) {
+        for(ast_node_t *param = node->a; param; param = param->next) {
+            add_var(&ssa, param->u.name, true);
+        }
+
+        collect_vars(&ssa, node->b);
+        init_vars(&ssa);
+
+        walk_block(&ssa, &node->b, 0);
+        if(!ssa.error) {
+            remove_dead(&ssa, &node->b);
+            if(level >= OPT_FULL) {
+                move_invariants(&ssa, node, ast);
+            }
+        }
+    }
+    else if(!ssa.error && node->kind == AST_CALL) { //Global call has only constant arguments
+        eval(&ssa, node);
+    }
+
+    mem_free(ssa.gvn_table);
+    mem_free(ssa.env);
+    mem_free(ssa.var_table);
+    ssa_env_stack_dtor(&ssa.saved);
+    ssa_var_stack_dtor(&ssa.vars);
+    ssa_val_stack_dtor(&ssa.values);
+}
+
+
+/***                               End of ssa.c                            ***/
@@ -0,0 +1,55 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                  ssa.h
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *      Purpose: Optimizations of functions in SSA form (before code is generated)
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file ssa.h
+ * @brief Optimizations of functions in SSA form (before code is generated)
+ * @note Every local variable, parameter and temporary value on the stack (node of expression) gets SSA value,
+ *       values are merged by phi values after conditions and at the beginning of loops
+ * @note Tree is rewritten in place, new nodes are allocated only from given tree, so functions can be optimized
+ *       concurrently (every thread with its own tree)
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#ifndef SSA_H
+#define SSA_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "ast.h"
+
+
+/**
+ * @brief Level of optimizations
+ */
+typedef enum opt_level {
+    OPT_NONE = 0, /**< Code is generated directly from tree */
+    OPT_BASIC = 1, /**< Constant propagation and folding, copy propagation and dead code elimination (-O1) */
+    OPT_FULL = 2, /**< OPT_BASIC, global value numbering (computed values are reused from variables)
+                       and loop-invariant code motion (-O2) */
+} opt_level_t;
+
+
+/**
+ * @brief Optimizes global statement (function definition or function call)
+ * @param ast Tree, whose arena is used for new nodes (declarations of temporary variables before loops)
+ * @note If level is OPT_NONE, it does nothing
+ */
+void ssa_optimize(ast_node_t *node, opt_level_t level, ast_t *ast);
+
+
+#endif
+
+/***                               End of ssa.h                            ***/
@@ -83,7 +83,7 @@ void insert_sym(symtab_t *tab, const char *key, sym_data_t newdata) {
     }
 
     if(!was_inserted) { //Create new node and allocate memory for it
-        *cur_node = (tree_node_t *)malloc(sizeof(tree_node_t));
+        *cur_node = (tree_node_t *)mem_alloc(sizeof(tree_node_t));
         if(*cur_node == NULL) {
             return;
         }
@@ -116,7 +116,7 @@ void replace_by_rightmost(tree_node_t *target, tree_node_t **tab) {
     tree_node_t *temp = *tab;
     target->data = (*tab)->data;
 
-    free(target->key);
+    mem_free(target->key);
     target->key = (*tab)->key;
     
     if((*tab)->l_ptr != NULL) {
@@ -126,7 +126,7 @@ void replace_by_rightmost(tree_node_t *target, tree_node_t **tab) {
         *tab = NULL;
     }
 
-    free(temp);
+    mem_free(temp);
 }
 
 /**
@@ -156,8 +156,8 @@ void delete_sym(symtab_t *tab, const char *key) {
                 }
 
                 data_dtor(&to_be_deleted->data);
-                free(to_be_deleted->key);
-                free(to_be_deleted);
+                mem_free(to_be_deleted->key);
+                mem_free(to_be_deleted);
             }
         }
         else if(comparison_result > 0) {
@@ -174,6 +174,11 @@ void delete_sym(symtab_t *tab, const char *key) {
  * @param tab symbol table to be deleted
  */ 
 void destroy_tab(symtab_t *tab) {
+    if(arena_active()) { //Nodes are released together with arena
+        tab->t = NULL;
+        return;
+    }
+
     ts_stack_t stack;
     ts_stack_init(&stack);
     
@@ -192,8 +197,8 @@ void destroy_tab(symtab_t *tab) {
             curr_node = curr_node->l_ptr;
 
             data_dtor(&tmp->data);
-            free(tmp->key);
-            free(tmp);
+            mem_free(tmp->key);
+            mem_free(tmp);
         }
 
   } while(curr_node != NULL || !ts_is_empty(&stack));
@@ -299,12 +304,12 @@ void data_dtor(sym_data_t *data) {
 /**
  * @brief Contains static array with builtin functions and its attributes (parameter, return types)
  */ 
-sym_data_t* builtin_functions(unsigned int index) {
+const sym_data_t* builtin_functions(unsigned int index) {
     if (index >= BUILTIN_TABLE_SIZE) {
         return NULL;
     }
 
-    static sym_data_t builtin_functions[BUILTIN_TABLE_SIZE] = {
+    static const sym_data_t builtin_functions[BUILTIN_TABLE_SIZE] = {
     //Name                Return types   Parameters
     {{0, 0, "chr"}, FUNC, {0, 0, "s"}, {0, 0, "i"}, UNSET, DEFINED, false},
     {{0, 0, "ord"}, FUNC, {0, 0, "i"}, {0, 0, "si"}, UNSET, DEFINED, false},
@@ -335,7 +340,7 @@ void load_builtin_f(symtab_t *dst) {
  * @brief Tries to find function by name in table of builtin functions
  * @return Pointer to function data in static table if function is found, other wise NULL
  */ 
-sym_data_t* search_builtin(const char *f_name) {
+const sym_data_t* search_builtin(const char *f_name) {
     //If function name start with 'z' (for example) -> search from the end 
     int i = f_name[0] < 'z' - 'a' / 2 ? 0 : BUILTIN_TABLE_SIZE - 1;
     int inc = f_name[0] < 'z' - 'a' / 2 ? 1 : -1;
@@ -355,7 +360,7 @@ sym_data_t* search_builtin(const char *f_name) {
  * @return True if symbol was found in builtin functions table otherwise false
  */
 bool check_builtin(char *key, symtab_t *dst) {
-    sym_data_t *bfunc_data_ptr = search_builtin(key);
+    const sym_data_t *bfunc_data_ptr = search_builtin(key);
 
     if(bfunc_data_ptr) {
         insert_sym(dst, to_str(&bfunc_data_ptr->name), *bfunc_data_ptr);
@@ -141,6 +141,7 @@ void replace_rightmost(symtab_t *tab, symtab_t *target);
 /**
  * @brief Deletetes the entire symbol table and correctly frees its resources
  * @param tab symbol table to be deleted
+ * @note If arena is used (@see arena.h), tree is not traversed, nodes are released together with arena
  */ 
 void destroy_tab(symtab_t *tab);
 
@@ -175,7 +176,7 @@ void load_builtin_f(symtab_t *dst);
  * @brief Tries to find function by name in table of builtin functions
  * @return Pointer to function data in static table if function is found, other wise NULL
  */ 
-sym_data_t* search_builtin(const char *f_name);
+const sym_data_t* search_builtin(const char *f_name);
 
 
 /**
@@ -187,7 +188,7 @@ bool check_builtin(char *key, symtab_t *dst);
 /**
  * @brief Contains static array with builtin functions and its attributes (parameter, return types)
  */ 
-sym_data_t* builtin_functions(unsigned int index);
+const sym_data_t* builtin_functions(unsigned int index);
 
 
 /**
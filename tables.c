@@ -23,7 +23,7 @@
  * @return Pointer to keyword with index from argument    
  */ 
 char * get_keyword(unsigned int index) {
-    static char * keyword_table[KEYWORD_TABLE_SIZE] = 
+    static char * const keyword_table[KEYWORD_TABLE_SIZE] = 
     {
         "do", "else", "end", "function", 
         "global", "if", "integer", "local", 
@@ -41,7 +41,7 @@ char * get_keyword(unsigned int index) {
  * @return Pointer to operator with index from argument    
  */ 
 char * get_operator(unsigned int index) {
-    static char * operator_table[OPERATOR_TABLE_SIZE] = 
+    static char * const operator_table[OPERATOR_TABLE_SIZE] = 
     {
         "#", "%", "*", "+", "-", "..", 
         "/", "//", "<", "<=", "=", 
@@ -57,7 +57,7 @@ char * get_operator(unsigned int index) {
  * @return Pointer to separator with index from argument    
  */ 
 char * get_separator(unsigned int index) {
-    static char * separator_table[SEPARATOR_TABLE_SIZE] = 
+    static char * const separator_table[SEPARATOR_TABLE_SIZE] = 
     {
         "(", ")", ",", ":"
     };
@@ -66,23 +66,37 @@ char * get_separator(unsigned int index) {
 }
 
 
+/**
+ * @brief Compares string with given length with terminated string from table (as strcmp)
+ */ 
+int cmp_n(const char * str, size_t length, const char * tab_str) {
+    int cmp_result = strncmp(str, tab_str, length);
+    if(cmp_result == 0 && tab_str[length] != '\0') { //String from table is longer
+        return -1;
+    }
+
+    return cmp_result;
+}
+
+
 /**
  * @brief Tries to find string in table (Implemented as binary search)
  * @param str string to be found
+ * @param length length of string (it doesn't need to be terminated)
  * @param table_func pointer to function, that contains static array
- * @return pointer to found string in static array or NULL
+ * @return index of found string in static array or -1
  */ 
-char * match(char * str, char * (*table_func)(unsigned int), size_t tab_size) {
+int match_index_n(const char * str, size_t length, char * (*table_func)(unsigned int), size_t tab_size) {
 
     int middle = tab_size / 2;
     int left_b = 0, right_b = tab_size - 1;
-    char * found = NULL;
+    int found = -1;
     do {
         char * cur_str = table_func(middle);
-        int cmp_result = str_cmp(str, cur_str);
+        int cmp_result = cmp_n(str, length, cur_str);
 
         if(cmp_result == 0) {
-            found = cur_str;
+            found = middle;
             break;
         }
         else if(cmp_result < 0) {
@@ -100,4 +114,16 @@ char * match(char * str, char * (*table_func)(unsigned int), size_t tab_size) {
 }
 
 
+int match_index(char * str, char * (*table_func)(unsigned int), size_t tab_size) {
+    return match_index_n(str, strlen(str), table_func, tab_size);
+}
+
+
+char * match(char * str, char * (*table_func)(unsigned int), size_t tab_size) {
+    int index = match_index(str, table_func, tab_size);
+
+    return (index < 0) ? NULL : table_func(index);
+}
+
+
 /***                             End of tables.c                           ***/
@@ -29,6 +29,16 @@
 #define OPERATOR_TABLE_SIZE 16
 #define SEPARATOR_TABLE_SIZE 4
 
+/**
+ * @brief Indexes of keywords in table of keywords (must correspond with sorting of table)
+ */
+typedef enum keyword_id {
+    KW_DO, KW_ELSE, KW_END, KW_FUNCTION,
+    KW_GLOBAL, KW_IF, KW_INTEGER, KW_LOCAL,
+    KW_NIL, KW_NUMBER, KW_REQUIRE, KW_RETURN,
+    KW_STRING, KW_THEN, KW_WHILE
+} keyword_id_t;
+
 /**
  * @brief Returns pointer to string in static array with keywords
  * @param index to array with keywords
@@ -62,6 +72,25 @@ char * get_builtin(unsigned int index);
  */ 
 char * match(char * str, char * (*table_func)(unsigned int), size_t tab_size);
 
+/**
+ * @brief Tries to find string in table (binary search)
+ * @param str string to be found
+ * @param table_func pointer to function, that contains static array
+ * @param tab_size size of table in which be searching executed
+ * @return index of found string in static array or -1 if string is not there
+ */ 
+int match_index(char * str, char * (*table_func)(unsigned int), size_t tab_size);
+
+/**
+ * @brief Tries to find string, that is not terminated by '\0', in table (binary search)
+ * @param str string to be found
+ * @param length length of string
+ * @param table_func pointer to function, that contains static array
+ * @param tab_size size of table in which be searching executed
+ * @return index of found string in static array or -1 if string is not there
+ */ 
+int match_index_n(const char * str, size_t length, char * (*table_func)(unsigned int), size_t tab_size);
+
 #endif
 
 /***                             End of tables.h                           ***/
@@ -0,0 +1,659 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                tokstream.c
+ * 
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ * 
+ *      Purpose: Recording of token stream and its binary format (dump/load)
+ * 
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/ 
+
+/**
+ * @file tokstream.c
+ * @brief Recording of token stream and its binary format (dump/load)
+ * @note For more documentation about functions and structures @see tokstream.h
+ * 
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */ 
+
+#include "tokstream.h"
+
+#include <string.h>
+
+#define TOKSTREAM_INIT_SIZE 256
+
+
+void tokstream_init(tokstream_t *ts) {
+    ts->records = NULL;
+    ts->len = 0;
+    ts->alloc_size = 0;
+    ts->src_len = 0;
+    ts->src_hash = HASH_INIT;
+}
+
+
+/**
+ * @brief Appends new (uninitialized) record to the end of token stream
+ * @return Pointer to the new record or NULL if allocation failed
+ */ 
+static tok_record_t *tokstream_push(tokstream_t *ts) {
+    if(ts->len == ts->alloc_size) {
+        size_t new_size = ts->alloc_size ? ts->alloc_size * 2 : TOKSTREAM_INIT_SIZE;
+        tok_record_t *extended = realloc(ts->records, new_size * sizeof(tok_record_t));
+        if(!extended) {
+            return NULL;
+        }
+
+        ts->records = extended;
+        ts->alloc_size = new_size;
+    }
+
+    return &ts->records[ts->len++];
+}
+
+
+int tokstream_record(tokstream_t *ts, scanner_t *sc) {
+    ts->len = 0;
+    ts->src_len = sc->src_len;
+    ts->src_hash = hash_bytes(sc->src, sc->src_len, HASH_INIT);
+
+    token_t t;
+    do {
+        t = get_next_token(sc);
+
+        int ret;
+        if(is_error_token(&t, &ret)) {
+            return ret;
+        }
+
+        tok_record_t *rec = tokstream_push(ts);
+        if(!rec) {
+            return INTERNAL_ERROR;
+        }
+
+        rec->token = t;
+        rec->cursor_pos[ROW] = sc->cursor_pos[ROW];
+        rec->cursor_pos[COL] = sc->cursor_pos[COL];
+    } while(t.token_type != EOF_TYPE);
+
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * @brief Buffer with encoded token stream
+ */ 
+typedef struct byte_buf {
+    unsigned char *data;
+    size_t len; /**< Number of written bytes (or index of the next byte to read) */
+    size_t size; /**< Allocated size (or number of bytes to read) */
+} byte_buf_t;
+
+
+#define MAX_VARINT_LEN 10 /**< Maximal number of bytes of one 64-bit integer */
+#define MAX_RECORD_LEN (1 + 5 * MAX_VARINT_LEN + sizeof(num_value_t))
+
+
+/**
+ * @brief Ensures, that there is space for at least one record in buffer
+ */ 
+static bool buf_reserve(byte_buf_t *buf) {
+    if(buf->len + MAX_RECORD_LEN > buf->size) {
+        size_t new_size = buf->size ? buf->size * 2 : TOKSTREAM_INIT_SIZE * MAX_RECORD_LEN;
+        unsigned char *extended = realloc(buf->data, new_size);
+        if(!extended) {
+            return false;
+        }
+
+        buf->data = extended;
+        buf->size = new_size;
+    }
+
+    return true;
+}
+
+
+/**************************Variable length integers***************************/
+
+static void write_varint(byte_buf_t *buf, uint64_t value) {
+    while(value >= 0x80) {
+        buf->data[buf->len++] = (unsigned char)(value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+
+    buf->data[buf->len++] = (unsigned char)value;
+}
+
+
+static bool read_varint(byte_buf_t *buf, uint64_t *value) {
+    *value = 0;
+    for(unsigned shift = 0; shift < 64 && buf->len < buf->size; shift += 7) {
+        unsigned char c = buf->data[buf->len++];
+
+        *value |= (uint64_t)(c & 0x7f) << shift;
+        if(!(c & 0x80)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//Signed differences are stored as unsigned integers (0, -1, 1, -2, ...)
+static uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+
+static int64_t unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+//^^^^^^^^^^^^^^^^^^^^^^^^^End of variable length integers^^^^^^^^^^^^^^^^^^^^/
+
+
+/****************************Kinds of tokens**********************************/
+
+//Token type and index to table of predefined symbols are stored in one byte (kind)
+#define KIND_KEYWORD 0
+#define KIND_OPERATOR (KIND_KEYWORD + KEYWORD_TABLE_SIZE)
+#define KIND_SEPARATOR (KIND_OPERATOR + OPERATOR_TABLE_SIZE)
+#define KIND_OTHER (KIND_SEPARATOR + SEPARATOR_TABLE_SIZE) /**< Tokens, that are not from tables (KIND_OTHER + type) */
+#define KIND_NUM (KIND_OTHER + TOK_TYPE_NUM)
+
+
+static unsigned char get_kind(token_t *t) {
+    if(t->attr_id == UNSET) {
+        return KIND_OTHER + t->token_type;
+    }
+    else if(t->token_type == KEYWORD) {
+        return KIND_KEYWORD + t->attr_id;
+    }
+    else if(t->token_type == OPERATOR) {
+        return KIND_OPERATOR + t->attr_id;
+    }
+    else {
+        return KIND_SEPARATOR + t->attr_id;
+    }
+}
+
+
+/**
+ * @brief Sets type and attribute of token from its kind
+ * @return True if token is span of source code (it has no attribute from table)
+ */ 
+static bool set_kind(token_t *t, unsigned char kind) {
+    token_init(t);
+    if(kind < KIND_OPERATOR) {
+        t->token_type = KEYWORD;
+        t->attr_id = kind - KIND_KEYWORD;
+        t->attr = get_keyword(t->attr_id);
+    }
+    else if(kind < KIND_SEPARATOR) {
+        t->token_type = OPERATOR;
+        t->attr_id = kind - KIND_OPERATOR;
+        t->attr = get_operator(t->attr_id);
+    }
+    else if(kind < KIND_OTHER) {
+        t->token_type = SEPARATOR;
+        t->attr_id = kind - KIND_SEPARATOR;
+        t->attr = get_separator(t->attr_id);
+    }
+    else {
+        t->token_type = kind - KIND_OTHER;
+        if(t->token_type == EOF_TYPE) {
+            t->attr = "EOF";
+        }
+        else {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//^^^^^^^^^^^^^^^^^^^^^^^^^^^^^End of kinds of tokens^^^^^^^^^^^^^^^^^^^^^^^^^/
+
+
+/**
+ * @brief Returns true if token has parsed numeric value, that must be stored
+ */ 
+static bool has_num(token_type_t type) {
+    return type == INTEGER || type == NUMBER;
+}
+
+
+/**
+ * @brief Position of the previous record (records are stored as differences to it)
+ */ 
+typedef struct rec_ctx {
+    uint64_t span_end; /**< End of the last token, that is span of source code */
+    pos_t row;
+    pos_t col;
+} rec_ctx_t;
+
+
+/**
+ * @brief Stores record as: kind, [gap between spans, length | index of identifier], row difference, column (difference), [value]
+ */ 
+static void write_record(byte_buf_t *buf, tok_record_t *rec, size_t id, rec_ctx_t *ctx) {
+    token_t *t = &rec->token;
+    unsigned char kind = get_kind(t);
+    buf->data[buf->len++] = kind;
+
+    if(t->token_type == IDENTIFIER) {
+        write_varint(buf, id);
+    }
+    else if(t->attr_id == UNSET && t->token_type != EOF_TYPE) {
+        write_varint(buf, zigzag((int64_t)(t->first_ch_index - ctx->span_end)));
+        write_varint(buf, t->length);
+        ctx->span_end = t->first_ch_index + t->length;
+    }
+
+    pos_t row = rec->cursor_pos[ROW], col = rec->cursor_pos[COL];
+    write_varint(buf, row - ctx->row);
+    if(row == ctx->row) {
+        write_varint(buf, zigzag((int64_t)(col - ctx->col)));
+    }
+    else {
+        write_varint(buf, col);
+    }
+
+    ctx->row = row;
+    ctx->col = col;
+
+    if(has_num(t->token_type)) {
+        memcpy(&buf->data[buf->len], &t->num, sizeof(num_value_t));
+        buf->len += sizeof(num_value_t);
+    }
+}
+
+
+/**
+ * @brief Distinct identifier of token stream
+ */ 
+typedef struct id_entry {
+    size_t first; /**< Index of record with the first occurrence of identifier */
+    size_t count; /**< Number of occurrences */
+    size_t id; /**< Index of identifier in order of the first occurrences */
+} id_entry_t;
+
+
+/**
+ * @brief Table of distinct identifiers of token stream (open addressing, linear probing)
+ */ 
+typedef struct id_table {
+    id_entry_t *entries;
+    size_t num; /**< Number of distinct identifiers */
+    size_t *slots; /**< Indices to entries + 1 (0 means empty slot) */
+    size_t size; /**< Number of slots (power of 2) */
+} id_table_t;
+
+
+static bool id_table_init(id_table_t *ids, tokstream_t *ts) {
+    size_t id_tokens = 0;
+    for(size_t i = 0; i < ts->len; i++) {
+        id_tokens += ts->records[i].token.token_type == IDENTIFIER;
+    }
+
+    //There are always at least half of slots empty, so table is never enlarged
+    ids->size = 1;
+    while(ids->size < id_tokens * 2) {
+        ids->size <<= 1;
+    }
+
+    ids->num = 0;
+    ids->entries = calloc(id_tokens + 1, sizeof(id_entry_t));
+    ids->slots = calloc(ids->size, sizeof(size_t));
+
+    return ids->entries && ids->slots;
+}
+
+
+static void id_table_dtor(id_table_t *ids) {
+    free(ids->entries);
+    free(ids->slots);
+}
+
+
+/**
+ * @brief Returns index of identifier in record (identifier is added to table, if it is not there)
+ */ 
+static size_t intern(id_table_t *ids, tokstream_t *ts, const char *src, size_t rec_i) {
+    token_t *t = &ts->records[rec_i].token;
+    const char *name = &src[t->first_ch_index];
+
+    size_t slot = hash_bytes(name, t->length, HASH_INIT) & (ids->size - 1);
+    for(; ids->slots[slot]; slot = (slot + 1) & (ids->size - 1)) {
+        id_entry_t *known = &ids->entries[ids->slots[slot] - 1];
+        token_t *known_t = &ts->records[known->first].token;
+        if(known_t->length == t->length && memcmp(&src[known_t->first_ch_index], name, t->length) == 0) {
+            known->count++;
+            return known->id;
+        }
+    }
+
+    ids->entries[ids->num] = (id_entry_t){.first = rec_i, .count = 1, .id = ids->num};
+    ids->slots[slot] = ++ids->num;
+
+    return ids->num - 1;
+}
+
+
+//The most frequent identifiers are the first ones (they have the shortest indices)
+static int entry_cmp(const void *a, const void *b) {
+    const id_entry_t *entry_a = a, *entry_b = b;
+    if(entry_a->count != entry_b->count) {
+        return entry_a->count < entry_b->count ? 1 : -1;
+    }
+
+    return entry_a->first < entry_b->first ? -1 : entry_a->first > entry_b->first;
+}
+
+
+/**
+ * @brief Sorts identifiers by their frequency and changes indices in records to indices to sorted table
+ */ 
+static bool sort_ids(id_table_t *ids, tokstream_t *ts, size_t *rec_ids) {
+    size_t *new_ids = malloc((ids->num + 1) * sizeof(size_t));
+    if(!new_ids) {
+        return false;
+    }
+
+    qsort(ids->entries, ids->num, sizeof(id_entry_t), entry_cmp);
+    for(size_t i = 0; i < ids->num; i++) {
+        new_ids[ids->entries[i].id] = i;
+    }
+
+    for(size_t i = 0; i < ts->len; i++) {
+        if(ts->records[i].token.token_type == IDENTIFIER) {
+            rec_ids[i] = new_ids[rec_ids[i]];
+        }
+    }
+
+    free(new_ids);
+
+    return true;
+}
+
+
+/**
+ * @brief Stores every distinct identifier once as span of source code (gap to the previous one, length)
+ */ 
+static bool write_ids(byte_buf_t *buf, id_table_t *ids, tokstream_t *ts) {
+    write_varint(buf, ids->num);
+
+    size_t span_end = 0;
+    for(size_t i = 0; i < ids->num; i++) {
+        if(!buf_reserve(buf)) {
+            return false;
+        }
+
+        token_t *t = &ts->records[ids->entries[i].first].token;
+        write_varint(buf, zigzag((int64_t)(t->first_ch_index - span_end)));
+        write_varint(buf, t->length);
+        span_end = t->first_ch_index + t->length;
+    }
+
+    return true;
+}
+
+
+int tokstream_write(tokstream_t *ts, const char *src, FILE *f) {
+    byte_buf_t buf = {NULL, 0, 0};
+    id_table_t ids;
+    size_t *rec_ids = calloc(ts->len + 1, sizeof(size_t)); //Index of identifier for every record
+    if(!id_table_init(&ids, ts) || !rec_ids || !buf_reserve(&buf)) {
+        id_table_dtor(&ids);
+        free(rec_ids);
+        free(buf.data);
+        return INTERNAL_ERROR;
+    }
+
+    for(size_t i = 0; i < ts->len; i++) {
+        if(ts->records[i].token.token_type == IDENTIFIER) {
+            rec_ids[i] = intern(&ids, ts, src, i);
+        }
+    }
+
+    memcpy(buf.data, TOKSTREAM_MAGIC, strlen(TOKSTREAM_MAGIC));
+    buf.len = strlen(TOKSTREAM_MAGIC);
+    write_varint(&buf, TOKSTREAM_VERSION);
+    write_varint(&buf, ts->src_len);
+    write_varint(&buf, ts->src_hash);
+
+    bool is_ok = sort_ids(&ids, ts, rec_ids) && write_ids(&buf, &ids, ts);
+    id_table_dtor(&ids);
+
+    if(is_ok) {
+        write_varint(&buf, ts->len);
+    }
+
+    rec_ctx_t ctx = {0, 1, 1};
+    for(size_t i = 0; is_ok && i < ts->len; i++) {
+        is_ok = buf_reserve(&buf);
+        if(is_ok) {
+            write_record(&buf, &ts->records[i], rec_ids[i], &ctx);
+        }
+    }
+
+    free(rec_ids);
+
+    size_t written = is_ok ? fwrite(buf.data, sizeof(unsigned char), buf.len, f) : 0;
+    free(buf.data);
+
+    return is_ok && written == buf.len ? EXIT_SUCCESS : INTERNAL_ERROR;
+}
+
+
+/**
+ * @brief Identifier loaded from token stream (span of source code)
+ */ 
+typedef struct id_span {
+    size_t start;
+    size_t length;
+} id_span_t;
+
+
+/**
+ * @brief Reads table of distinct identifiers (@see write_ids())
+ * @return False if table is not valid
+ */ 
+static bool read_ids(byte_buf_t *buf, id_span_t **ids, size_t *id_num, size_t src_len) {
+    uint64_t num;
+    //Every identifier has at least two bytes (so number can be checked before allocation)
+    if(!read_varint(buf, &num) || num > (buf->size - buf->len) / 2) {
+        return false;
+    }
+
+    *ids = malloc((num + 1) * sizeof(id_span_t));
+    if(!*ids) {
+        return false;
+    }
+
+    uint64_t span_end = 0, gap, length;
+    for(*id_num = 0; *id_num < num; (*id_num)++) {
+        if(!read_varint(buf, &gap) || !read_varint(buf, &length)) {
+            return false;
+        }
+
+        uint64_t start = span_end + (uint64_t)unzigzag(gap);
+        if(start > src_len || length > src_len - start) {
+            return false;
+        }
+
+        (*ids)[*id_num].start = start;
+        (*ids)[*id_num].length = length;
+        span_end = start + length;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Reads one record of token stream
+ * @return False if record is not valid
+ */ 
+static bool read_record(byte_buf_t *buf, tok_record_t *rec, rec_ctx_t *ctx, 
+                        const id_span_t *ids, size_t id_num, size_t src_len) {
+    if(buf->len >= buf->size || buf->data[buf->len] >= KIND_NUM) {
+        return false;
+    }
+
+    token_t *t = &rec->token;
+    uint64_t gap, length, row_diff, col;
+    if(set_kind(t, buf->data[buf->len++])) { //Spans must be inside of source code (attributes are got from it)
+        bool is_error = t->token_type == ERROR_TYPE || t->token_type == INT_ERR_TYPE; //They are never recorded
+        if(t->token_type == UNKNOWN || is_error) {
+            return false;
+        }
+        else if(t->token_type == IDENTIFIER) { //Identifier is the first occurrence of it in source code
+            uint64_t id;
+            if(!read_varint(buf, &id) || id >= id_num) {
+                return false;
+            }
+
+            t->first_ch_index = ids[id].start;
+            t->length = ids[id].length;
+        }
+        else {
+            if(!read_varint(buf, &gap) || !read_varint(buf, &length)) {
+                return false;
+            }
+
+            uint64_t start = ctx->span_end + (uint64_t)unzigzag(gap);
+            if(start > src_len || length > src_len - start) {
+                return false;
+            }
+
+            t->first_ch_index = start;
+            t->length = length;
+            ctx->span_end = start + length;
+        }
+    }
+
+    if(!read_varint(buf, &row_diff) || !read_varint(buf, &col)) {
+        return false;
+    }
+
+    ctx->col = (row_diff == 0) ? ctx->col + (pos_t)unzigzag(col) : col;
+    ctx->row += row_diff;
+    rec->cursor_pos[ROW] = ctx->row;
+    rec->cursor_pos[COL] = ctx->col;
+
+    if(has_num(t->token_type)) {
+        if(buf->size - buf->len < sizeof(num_value_t)) {
+            return false;
+        }
+
+        memcpy(&t->num, &buf->data[buf->len], sizeof(num_value_t));
+        buf->len += sizeof(num_value_t);
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Decodes records of token stream (table of identifiers is already read)
+ */ 
+static int decode_records(tokstream_t *ts, byte_buf_t *buf, const id_span_t *ids, size_t id_num) {
+    uint64_t count;
+    //Every record has at least two bytes (so count can be checked before allocation)
+    if(!read_varint(buf, &count) || count == 0 || count > (buf->size - buf->len) / 2) {
+        return INTERNAL_ERROR;
+    }
+
+    tok_record_t *records = realloc(ts->records, count * sizeof(tok_record_t));
+    if(!records) {
+        return INTERNAL_ERROR;
+    }
+
+    ts->records = records;
+    ts->alloc_size = count;
+    ts->len = 0;
+
+    rec_ctx_t ctx = {0, 1, 1};
+    for(; ts->len < count; ts->len++) {
+        if(!read_record(buf, &ts->records[ts->len], &ctx, ids, id_num, ts->src_len)) {
+            return INTERNAL_ERROR;
+        }
+    }
+
+    //Scanner expects EOF at the end of stream
+    if(ts->records[ts->len - 1].token.token_type != EOF_TYPE) {
+        return INTERNAL_ERROR;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * @brief Decodes whole token stream from buffer
+ */ 
+static int decode(tokstream_t *ts, byte_buf_t *buf) {
+    size_t magic_len = strlen(TOKSTREAM_MAGIC);
+    if(buf->size < magic_len || memcmp(buf->data, TOKSTREAM_MAGIC, magic_len) != 0) {
+        return INTERNAL_ERROR;
+    }
+
+    buf->len = magic_len;
+    uint64_t version, src_len;
+    if(!read_varint(buf, &version) || version != TOKSTREAM_VERSION ||
+       !read_varint(buf, &src_len) || !read_varint(buf, &ts->src_hash)) {
+        return INTERNAL_ERROR;
+    }
+
+    ts->src_len = src_len;
+
+    id_span_t *ids = NULL;
+    size_t id_num = 0;
+    int ret = INTERNAL_ERROR;
+    if(read_ids(buf, &ids, &id_num, ts->src_len)) {
+        ret = decode_records(ts, buf, ids, id_num);
+    }
+
+    free(ids);
+
+    return ret;
+}
+
+
+int tokstream_read(tokstream_t *ts, FILE *f) {
+    byte_buf_t buf = {NULL, 0, 0};
+    char *content = NULL;
+    if(read_stream(f, &content, &buf.size) != EXIT_SUCCESS) {
+        return INTERNAL_ERROR;
+    }
+
+    buf.data = (unsigned char *)content;
+    int ret = decode(ts, &buf);
+    free(content);
+
+    if(ret != EXIT_SUCCESS) {
+        ts->len = 0;
+    }
+
+    return ret;
+}
+
+
+bool tokstream_matches(tokstream_t *ts, const char *src, size_t src_len) {
+    return ts->len > 0 && ts->src_len == src_len && 
+           ts->src_hash == hash_bytes(src, src_len, HASH_INIT);
+}
+
+
+void tokstream_dtor(tokstream_t *ts) {
+    free(ts->records);
+    tokstream_init(ts);
+}
+
+
+/***                            End of tokstream.c                         ***/
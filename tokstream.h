@@ -0,0 +1,88 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                tokstream.h
+ * 
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ * 
+ *      Purpose: Recording of token stream and its binary format (dump/load)
+ * 
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/ 
+
+/**
+ * @file tokstream.h
+ * @brief Recording of token stream and its binary format (dump/load)
+ * @note Recorded stream can be given to scanner (@see scanner_replay()), so source code
+ *       does not have to be scanned again if it is compiled repeatedly
+ * 
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o), 
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */ 
+
+#ifndef TOKSTREAM_H
+#define TOKSTREAM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "scanner.h"
+
+#define TOKSTREAM_MAGIC "IFJ21TOK" /**< The first bytes of file with token stream */
+#define TOKSTREAM_VERSION 2 /**< Version of binary format (files with other version are refused) */
+
+
+/**
+ * @brief Recorded tokens of one source code
+ */ 
+typedef struct tokstream {
+    tok_record_t *records; /**< Tokens with positions (the last one is EOF) */
+    size_t len;
+    size_t alloc_size;
+    size_t src_len; /**< Length of source code, from which tokens were got */
+    uint64_t src_hash; /**< Hash of source code (@see hash_bytes()) */
+} tokstream_t;
+
+
+/**
+ * @brief Sets initial values to token stream (it is empty)
+ */ 
+void tokstream_init(tokstream_t *ts);
+
+/**
+ * @brief Reads all tokens from scanner (until EOF) and stores them to token stream
+ * @return LEXICAL_ERROR if there was invalid token (stream is not complete), 
+ *         INTERNAL_ERROR if allocation failed, otherwise EXIT_SUCCESS
+ */ 
+int tokstream_record(tokstream_t *ts, scanner_t *sc);
+
+/**
+ * @brief Writes token stream to file in compact binary format
+ * @param src Source code, from which tokens were recorded (to find out equal identifiers)
+ * @note Records are stored as differences to the previous record (variable length integers),
+ *       every distinct identifier is stored only once in table (sorted by frequency) and records contain index to it
+ * @return INTERNAL_ERROR if writing failed
+ */ 
+int tokstream_write(tokstream_t *ts, const char *src, FILE *f);
+
+/**
+ * @brief Loads token stream from file
+ * @return INTERNAL_ERROR if file is not valid token stream (or allocation failed)
+ */ 
+int tokstream_read(tokstream_t *ts, FILE *f);
+
+/**
+ * @brief Checks if token stream was got from given source code (it is not stale)
+ */ 
+bool tokstream_matches(tokstream_t *ts, const char *src, size_t src_len);
+
+/**
+ * @brief Frees all resources held by token stream
+ */ 
+void tokstream_dtor(tokstream_t *ts);
+
+
+#endif
+
+/***                            End of tokstream.h                         ***/
@@ -0,0 +1,47 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                workers.c
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *      Purpose: Helpers shared by multithreaded parts of compiler
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file workers.c
+ * @brief Helpers shared by multithreaded parts of compiler
+ * @note For more documentation about functions @see workers.h
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#define _POSIX_C_SOURCE 200809L /**< Because of sysconf() */
+
+#include "workers.h"
+
+#include <unistd.h>
+
+
+unsigned get_worker_num(unsigned required, size_t job_num, unsigned max) {
+    if(required == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        required = online > 0 ? (unsigned)online : 1;
+    }
+
+    if(required > max) {
+        required = max;
+    }
+
+    if(required > job_num) { //Idle workers are useless
+        required = job_num > 0 ? (unsigned)job_num : 1;
+    }
+
+    return required;
+}
+
+
+/***                             End of workers.c                          ***/
@@ -0,0 +1,38 @@
+/******************************************************************************
+ *                                  IFJ21
+ *                                workers.h
+ *
+ *      Authors: Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *                Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ *
+ *      Purpose: Helpers shared by multithreaded parts of compiler
+ *
+ *                      Last change: 18. 10. 2026
+ *****************************************************************************/
+
+/**
+ * @file workers.h
+ * @brief Helpers shared by multithreaded parts of compiler (@see batch.h, codegen.h)
+ *
+ * @authors Radek Marek (xmarek77), Vojtěch Dvořák (xdvora3o),
+ *          Juraj Dědič (xdedic07), Tomáš Dvořák (xdvora3r)
+ */
+
+#ifndef WORKERS_H
+#define WORKERS_H
+
+#include <stdlib.h>
+
+
+/**
+ * @brief Returns number of workers (threads), that will be used for given number of jobs
+ * @param required Required number of workers (if it is 0, number of online processors is used)
+ * @param job_num Number of jobs (there is no more workers than jobs, but at least one)
+ * @param max Upper limit of number of workers
+ */
+unsigned get_worker_num(unsigned required, size_t job_num, unsigned max);
+
+
+#endif
+
+/***                             End of workers.h                          ***/